@@ -0,0 +1,118 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/utils/memory.h>
+
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
+#include <xcb/xcb.h>
+
+namespace como::base::x11
+{
+
+using event_ptr = unique_cptr<xcb_generic_event_t>;
+
+/**
+ * Copies the values of @p previous that @p next does not set into @p next. The merged request
+ * results in the same geometry as both requests handled in order.
+ */
+inline void merge_configure_requests(xcb_configure_request_event_t const& previous,
+                                     xcb_configure_request_event_t& next)
+{
+    auto merge = [&](uint16_t flag, auto member) {
+        if ((previous.value_mask & flag) && !(next.value_mask & flag)) {
+            next.*member = previous.*member;
+            next.value_mask |= flag;
+        }
+    };
+
+    merge(XCB_CONFIG_WINDOW_X, &xcb_configure_request_event_t::x);
+    merge(XCB_CONFIG_WINDOW_Y, &xcb_configure_request_event_t::y);
+    merge(XCB_CONFIG_WINDOW_WIDTH, &xcb_configure_request_event_t::width);
+    merge(XCB_CONFIG_WINDOW_HEIGHT, &xcb_configure_request_event_t::height);
+    merge(XCB_CONFIG_WINDOW_BORDER_WIDTH, &xcb_configure_request_event_t::border_width);
+}
+
+/**
+ * Removes events that are superseded by a later event of the same kind:
+ * - ConfigureRequests of a window are merged into the last one.
+ * - Of the PropertyNotify events with the same window, atom and state only the last one is kept.
+ * - Of the MotionNotify events with the same window and button state only the last one is kept.
+ *
+ * Events are only compressed over other compressible events. Any other event, restacking
+ * requests and sent events end the compression, such that the order of events that depend on
+ * each other does not change.
+ */
+inline void compress_events(std::vector<event_ptr>& events)
+{
+    using key_t = std::tuple<uint8_t, xcb_window_t, uint32_t, uint32_t>;
+
+    auto get_key = [](xcb_generic_event_t* event) -> std::optional<key_t> {
+        if (event->response_type & 0x80) {
+            // Sent by a client.
+            return {};
+        }
+
+        switch (event->response_type) {
+        case XCB_CONFIGURE_REQUEST: {
+            auto req = reinterpret_cast<xcb_configure_request_event_t*>(event);
+            if (req->value_mask & (XCB_CONFIG_WINDOW_SIBLING | XCB_CONFIG_WINDOW_STACK_MODE)) {
+                return {};
+            }
+            return key_t{XCB_CONFIGURE_REQUEST, req->window, 0, 0};
+        }
+        case XCB_PROPERTY_NOTIFY: {
+            auto notify = reinterpret_cast<xcb_property_notify_event_t*>(event);
+            return key_t{XCB_PROPERTY_NOTIFY, notify->window, notify->atom, notify->state};
+        }
+        case XCB_MOTION_NOTIFY: {
+            auto motion = reinterpret_cast<xcb_motion_notify_event_t*>(event);
+            return key_t{XCB_MOTION_NOTIFY, motion->event, motion->state, 0};
+        }
+        default:
+            return {};
+        }
+    };
+
+    // Index of the last event per key since the last event that ended the compression.
+    std::map<key_t, size_t> pending;
+    auto compressed{false};
+
+    for (size_t index = 0; index < events.size(); ++index) {
+        auto event = events.at(index).get();
+
+        auto key = get_key(event);
+        if (!key) {
+            pending.clear();
+            continue;
+        }
+
+        auto [it, inserted] = pending.try_emplace(*key, index);
+        if (inserted) {
+            continue;
+        }
+
+        auto& previous = events.at(it->second);
+        if (event->response_type == XCB_CONFIGURE_REQUEST) {
+            merge_configure_requests(
+                *reinterpret_cast<xcb_configure_request_event_t*>(previous.get()),
+                *reinterpret_cast<xcb_configure_request_event_t*>(event));
+        }
+
+        previous.reset();
+        it->second = index;
+        compressed = true;
+    }
+
+    if (compressed) {
+        std::erase_if(events, [](auto const& event) { return !event; });
+    }
+}
+
+}
@@ -12,6 +12,7 @@
 #include <QRect>
 #include <QRegion>
 #include <QVector>
+#include <unordered_map>
 #include <vector>
 #include <xcb/xcb.h>
 
@@ -83,6 +84,98 @@ inline void restack_windows(xcb_connection_t* con, std::vector<xcb_window_t> con
     }
 }
 
+/**
+ * Returns the indices of the windows that must be restacked to change the stacking order from
+ * @p previous to @p windows. Both lists go from top to bottom.
+ *
+ * The first window is never moved. Of the other windows all are kept in place that form the
+ * longest subsequence which already is in the right relative order.
+ */
+inline std::vector<size_t> get_restack_moves(std::vector<xcb_window_t> const& previous,
+                                             std::vector<xcb_window_t> const& windows)
+{
+    if (windows.size() < 2) {
+        return {};
+    }
+
+    std::unordered_map<xcb_window_t, int> previous_pos;
+    for (size_t i = 0; i < previous.size(); ++i) {
+        previous_pos[previous.at(i)] = static_cast<int>(i);
+    }
+
+    auto get_previous_pos = [&](size_t index) {
+        auto it = previous_pos.find(windows.at(index));
+        return it == previous_pos.end() ? -1 : it->second;
+    };
+
+    // Patience sorting for the longest increasing subsequence of previous positions below the
+    // first window. Windows not stacked before must always be moved.
+    auto const first_pos = get_previous_pos(0);
+
+    std::vector<size_t> tails;
+    std::vector<int> predecessor(windows.size(), -1);
+    auto tail_pos = [&](size_t tail) { return get_previous_pos(tails.at(tail)); };
+
+    for (size_t i = 1; i < windows.size(); ++i) {
+        auto const pos = get_previous_pos(i);
+        if (pos < 0 || pos < first_pos) {
+            continue;
+        }
+
+        size_t low = 0;
+        size_t high = tails.size();
+        while (low < high) {
+            auto const mid = (low + high) / 2;
+            if (tail_pos(mid) < pos) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        if (low > 0) {
+            predecessor.at(i) = static_cast<int>(tails.at(low - 1));
+        }
+        if (low == tails.size()) {
+            tails.push_back(i);
+        } else {
+            tails.at(low) = i;
+        }
+    }
+
+    std::vector<bool> kept(windows.size(), false);
+    kept.at(0) = true;
+    for (int i = tails.empty() ? -1 : static_cast<int>(tails.back()); i >= 0;
+         i = predecessor.at(i)) {
+        kept.at(i) = true;
+    }
+
+    std::vector<size_t> moves;
+    for (size_t i = 1; i < windows.size(); ++i) {
+        if (!kept.at(i)) {
+            moves.push_back(i);
+        }
+    }
+    return moves;
+}
+
+/**
+ * Restacks @p windows like restack_windows but only sends requests for the windows that changed
+ * their relative position since they were stacked as @p previous.
+ */
+inline void restack_windows(xcb_connection_t* con,
+                            std::vector<xcb_window_t> const& windows,
+                            std::vector<xcb_window_t> const& previous)
+{
+    // Moves go from top to bottom. This way every window is stacked below one that is already at
+    // its final position.
+    for (auto index : get_restack_moves(previous, windows)) {
+        const uint16_t mask = XCB_CONFIG_WINDOW_SIBLING | XCB_CONFIG_WINDOW_STACK_MODE;
+        const uint32_t stackingValues[] = {windows.at(index - 1), XCB_STACK_MODE_BELOW};
+        xcb_configure_window(con, windows.at(index), mask, stackingValues);
+    }
+}
+
 inline void restack_windows_with_raise(xcb_connection_t* con,
                                        std::vector<xcb_window_t> const& windows)
 {
@@ -10,6 +10,7 @@
 
 #include <QRect>
 #include <xcb/composite.h>
+#include <xcb/shape.h>
 #include <xcb/xcb.h>
 
 namespace como::base::x11::xcb
@@ -150,5 +151,6 @@ public:
 };
 
 XCB_WRAPPER(window_attributes, xcb_get_window_attributes, xcb_window_t)
+XCB_WRAPPER(shape_extents, xcb_shape_query_extents, xcb_window_t)
 
 }
@@ -47,7 +47,7 @@ public:
                 if (!m_inputFilter && index == 2) {
                     m_inputFilter = std::make_unique<input_filter<typename Space::input_t>>(
                         *space.input, this->m_ui->inputTextEdit);
-                    space.input->m_spies.push_back(m_inputFilter.get());
+                    space.input->install_spy(m_inputFilter.get());
                 }
                 if (index == 5) {
                     update_keyboard_tab();
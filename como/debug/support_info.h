@@ -154,6 +154,12 @@ QString get_support_info(Space const& space)
         support.append(QStringLiteral("Refresh Rate: %1\n\n").arg(output->refresh_rate()));
     }
 
+    if constexpr (requires { space.base.mod.render->presentation->latency; }) {
+        support.append(QStringLiteral("\nInput Latency\n"));
+        support.append(QStringLiteral("=============\n"));
+        support.append(space.base.mod.render->presentation->latency.get_support_info());
+    }
+
     support.append(QStringLiteral("\nCompositing\n"));
     support.append(QStringLiteral("===========\n"));
     if (auto& effects = space.base.mod.render->effects) {
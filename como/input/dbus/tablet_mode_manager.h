@@ -96,7 +96,7 @@ public:
         , redirect{redirect}
     {
         if (redirect.has_tablet_mode_switch()) {
-            redirect.m_spies.push_back(new tablet_mode_switch_spy(redirect, *qobject));
+            redirect.install_spy(new tablet_mode_switch_spy(redirect, *qobject));
         } else {
             Q_EMIT redirect.qobject->has_tablet_mode_switch_changed(false);
         }
@@ -117,7 +117,7 @@ public:
 
     ~tablet_mode_manager()
     {
-        remove_all(redirect.m_spies, spy);
+        redirect.uninstall_spy(spy);
     }
 
     std::unique_ptr<tablet_mode_manager_qobject> qobject;
@@ -132,7 +132,7 @@ private:
         if (set) {
             if (!spy) {
                 spy = new mode_switch_spy_t(redirect, *qobject);
-                redirect.m_spies.push_back(spy);
+                redirect.install_spy(spy);
             }
             qobject->setTabletModeAvailable(true);
         } else {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "event.h"
+#include "event_interest.h"
 
 #include <QSet>
 #include <QTabletEvent>
@@ -14,26 +15,6 @@
 namespace como::input
 {
 
-/**
- * Sends an event through all InputFilters.
- * The method @p function is invoked on each input filter. Processing is stopped if
- * a filter returns @c true for @p function.
- *
- * The UnaryPredicate is defined like the UnaryPredicate of std::any_of.
- * The signature of the function should be equivalent to the following:
- * @code
- * bool function(event_filter<redirect> const* filter);
- * @endcode
- *
- * The intended usage is to std::bind the method to invoke on the filter with all arguments
- * bind.
- */
-template<typename Filters, typename UnaryPredicate>
-void process_filters(Filters const& filters, UnaryPredicate function)
-{
-    std::any_of(filters.cbegin(), filters.cend(), function);
-}
-
 /**
  * Base class for filtering input events inside InputRedirection.
  *
@@ -50,6 +31,10 @@ void process_filters(Filters const& filters, UnaryPredicate function)
  * a filter returns @c false the next one is invoked. This means a filter
  * installed early gets to see more events than a filter installed later on.
  *
+ * A filter is only invoked for the event types of its @p interests and while it is active.
+ * Filters that only process events in a specific mode should deactivate themselves outside
+ * of it.
+ *
  * Deleting an instance of event_filter automatically uninstalls it from
  * InputRedirection.
  */
@@ -57,8 +42,9 @@ template<typename Redirect>
 class event_filter
 {
 public:
-    explicit event_filter(Redirect& redirect)
-        : redirect{redirect}
+    explicit event_filter(Redirect& redirect, event_interest interests = event_interest::all)
+        : interests{interests}
+        , redirect{redirect}
     {
     }
 
@@ -186,7 +172,44 @@ public:
         return false;
     }
 
+    bool is_active() const
+    {
+        return active;
+    }
+
+    event_interest const interests;
     Redirect& redirect;
+
+protected:
+    void set_active(bool active)
+    {
+        if (this->active == active) {
+            return;
+        }
+        this->active = active;
+        redirect.filter_index.invalidate();
+    }
+
+private:
+    bool active{true};
 };
 
+/**
+ * Sends an event through the active input filters interested in the event @p type.
+ * The method @p function is invoked with @p args on each filter. Processing is stopped if
+ * a filter returns @c true.
+ */
+template<typename Redirect, typename... Params, typename... Args>
+void process_filters(Redirect& redirect,
+                     event_interest type,
+                     bool (event_filter<Redirect>::*function)(Params...),
+                     Args const&... args)
+{
+    for (auto filter : redirect.filter_index.get(redirect.m_filters, type)) {
+        if ((filter->*function)(args...)) {
+            return;
+        }
+    }
+}
+
 }
@@ -0,0 +1,140 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/utils/flags.h>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace como::input
+{
+
+/// Types of input events filters and spies can be interested in.
+enum class event_interest : uint32_t {
+    none = 0,
+    button = 1 << 0,
+    motion = 1 << 1,
+    axis = 1 << 2,
+    key = 1 << 3,
+    key_repeat = 1 << 4,
+    touch_down = 1 << 5,
+    touch_motion = 1 << 6,
+    touch_up = 1 << 7,
+    touch_cancel = 1 << 8,
+    touch_frame = 1 << 9,
+    pinch_begin = 1 << 10,
+    pinch_update = 1 << 11,
+    pinch_end = 1 << 12,
+    swipe_begin = 1 << 13,
+    swipe_update = 1 << 14,
+    swipe_end = 1 << 15,
+    hold_begin = 1 << 16,
+    hold_end = 1 << 17,
+    switch_toggle = 1 << 18,
+    tablet_tool = 1 << 19,
+    tablet_tool_button = 1 << 20,
+    tablet_pad_button = 1 << 21,
+    tablet_pad_strip = 1 << 22,
+    tablet_pad_ring = 1 << 23,
+
+    pointer = button | motion | axis,
+    keyboard = key | key_repeat,
+    touch = touch_down | touch_motion | touch_up | touch_cancel | touch_frame,
+    gesture = pinch_begin | pinch_update | pinch_end | swipe_begin | swipe_update | swipe_end
+        | hold_begin | hold_end,
+    tablet = tablet_tool | tablet_tool_button | tablet_pad_button | tablet_pad_strip
+        | tablet_pad_ring,
+    all = (1 << 24) - 1,
+};
+
+}
+
+ENUM_FLAGS(como::input::event_interest)
+
+namespace como::input
+{
+
+/**
+ * Lists of the active receivers, filters or spies, interested in an event type. The lists keep
+ * the order of the receivers and are rebuilt on the next lookup after being invalidated.
+ *
+ * A lookup returns a shared snapshot of all lists so receivers can be installed, removed or
+ * (de)activated while an event is processed.
+ */
+template<typename Receiver>
+class event_interest_index
+{
+public:
+    static constexpr size_t type_count{std::bit_width(static_cast<uint32_t>(event_interest::all))};
+    using lists_t = std::array<std::vector<Receiver*>, type_count>;
+
+    class snapshot
+    {
+    public:
+        snapshot(std::shared_ptr<lists_t const> lists, event_interest type)
+            : lists{std::move(lists)}
+            , list{&this->lists->at(std::countr_zero(static_cast<uint32_t>(type)))}
+        {
+        }
+
+        auto begin() const
+        {
+            return list->cbegin();
+        }
+
+        auto end() const
+        {
+            return list->cend();
+        }
+
+    private:
+        std::shared_ptr<lists_t const> lists;
+        std::vector<Receiver*> const* list;
+    };
+
+    void invalidate()
+    {
+        lists.reset();
+    }
+
+    /// Active receivers of @p receivers interested in the single event @p type.
+    template<typename Receivers>
+    snapshot get(Receivers const& receivers, event_interest type)
+    {
+        if (!lists) {
+            lists = build(receivers);
+        }
+        return {lists, type};
+    }
+
+private:
+    template<typename Receivers>
+    static std::shared_ptr<lists_t const> build(Receivers const& receivers)
+    {
+        auto lists = std::make_shared<lists_t>();
+
+        for (auto receiver : receivers) {
+            if (!receiver->is_active()) {
+                continue;
+            }
+            for (size_t index = 0; index < type_count; ++index) {
+                if (flags(receiver->interests & static_cast<event_interest>(1u << index))) {
+                    lists->at(index).push_back(receiver);
+                }
+            }
+        }
+
+        return lists;
+    }
+
+    std::shared_ptr<lists_t const> lists;
+};
+
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "event.h"
+#include "event_interest.h"
 
 #include <como/utils/algorithm.h>
 
@@ -17,31 +18,13 @@ class QTabletEvent;
 namespace como::input
 {
 
-/**
- * Sends an event through all input event spies.
- * The @p function is invoked on each event_spy.
- *
- * The UnaryFunction is defined like the UnaryFunction of std::for_each.
- * The signature of the function should be equivalent to the following:
- * @code
- * void function(event_spy const* spy);
- * @endcode
- *
- * The intended usage is to std::bind the method to invoke on the spies with all arguments
- * bind.
- */
-template<typename Spies, typename UnaryFunction>
-void process_spies(Spies const& spies, UnaryFunction function)
-{
-    std::for_each(spies.cbegin(), spies.cend(), function);
-}
-
 /**
  * Base class for spying on input events inside InputRedirection.
  *
  * This class is quite similar to InputEventFilter, except that it does not
- * support event filtering. Each event_spy gets to see all input events,
- * the processing happens prior to sending events through the InputEventFilters.
+ * support event filtering. Each event_spy gets to see all input events of its @p interests
+ * while it is active, the processing happens prior to sending events through the
+ * InputEventFilters.
  *
  * Deleting an instance of event_spy automatically uninstalls it from
  * InputRedirection.
@@ -51,15 +34,17 @@ class event_spy
 {
 public:
     using motion_event_t = input::motion_event;
+    using event_interest_t = input::event_interest;
 
-    event_spy(Redirect& redirect)
-        : redirect{redirect}
+    event_spy(Redirect& redirect, event_interest interests = event_interest::all)
+        : interests{interests}
+        , redirect{redirect}
     {
     }
 
     virtual ~event_spy()
     {
-        remove_all(redirect.m_spies, this);
+        redirect.uninstall_spy(this);
     }
 
     virtual void button(button_event const& /*event*/)
@@ -150,7 +135,41 @@ public:
     {
     }
 
+    bool is_active() const
+    {
+        return active;
+    }
+
+    event_interest const interests;
     Redirect& redirect;
+
+protected:
+    void set_active(bool active)
+    {
+        if (this->active == active) {
+            return;
+        }
+        this->active = active;
+        redirect.spy_index.invalidate();
+    }
+
+private:
+    bool active{true};
 };
 
+/**
+ * Sends an event through the active input event spies interested in the event @p type.
+ * The method @p function is invoked with @p args on each event_spy.
+ */
+template<typename Redirect, typename... Params, typename... Args>
+void process_spies(Redirect& redirect,
+                   event_interest type,
+                   void (event_spy<Redirect>::*function)(Params...),
+                   Args const&... args)
+{
+    for (auto spy : redirect.spy_index.get(redirect.m_spies, type)) {
+        (spy->*function)(args...);
+    }
+}
+
 }
@@ -28,7 +28,7 @@ class decoration_event_filter : public event_filter<Redirect>
 {
 public:
     explicit decoration_event_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect, event_interest::pointer | event_interest::touch)
     {
     }
 
@@ -26,7 +26,9 @@ class dpms_filter : public event_filter<Redirect>
 {
 public:
     explicit dpms_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect,
+                                 event_interest::pointer | event_interest::key
+                                     | event_interest::touch)
         , redirect{redirect}
     {
     }
@@ -24,7 +24,9 @@ class drag_and_drop_filter : public event_filter<Redirect>
 {
 public:
     explicit drag_and_drop_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect,
+                                 event_interest::button | event_interest::motion
+                                     | event_interest::touch)
     {
     }
 
@@ -21,7 +21,9 @@ class effects_filter : public event_filter<Redirect>
 {
 public:
     explicit effects_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect,
+                                 event_interest::pointer | event_interest::keyboard
+                                     | event_interest::touch)
     {
     }
 
@@ -21,7 +21,7 @@ class fake_tablet_filter : public event_filter<Redirect>
 {
 public:
     explicit fake_tablet_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect, event_interest::tablet_tool)
     {
     }
 
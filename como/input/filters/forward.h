@@ -13,6 +13,7 @@
 #include <como/input/keyboard_redirect.h>
 #include <como/input/pointer_redirect.h>
 #include <como/input/qt_event.h>
+#include <como/render/wayland/input_latency.h>
 
 #include <Wrapland/Server/pointer_pool.h>
 #include <Wrapland/Server/seat.h>
@@ -28,6 +29,8 @@ template<typename Redirect>
 class forward_filter : public event_filter<Redirect>
 {
 public:
+    using latency_device = render::wayland::input_latency_device;
+
     explicit forward_filter(Redirect& redirect)
         : event_filter<Redirect>(redirect)
     {
@@ -39,6 +42,8 @@ public:
         this->redirect.keyboard->update();
         seat->setTimestamp(event.base.time_msec);
         pass_to_wayland_server(this->redirect, event);
+        this->redirect.record_input_delivery(
+            seat->keyboards().get_focus().surface, latency_device::keyboard, event.base.time_msec);
         return true;
     }
 
@@ -56,6 +61,8 @@ public:
             break;
         }
 
+        this->redirect.record_input_delivery(
+            seat->pointers().get_focus().surface, latency_device::pointer, event.base.time_msec);
         return true;
     }
 
@@ -65,13 +72,27 @@ public:
         seat->setTimestamp(event.base.time_msec);
 
         seat->pointers().set_position(this->redirect.pointer->pos());
-        if (!event.delta.isNull()) {
-            seat->pointers().relative_motion(
-                QSizeF(event.delta.x(), event.delta.y()),
-                QSizeF(event.unaccel_delta.x(), event.unaccel_delta.y()),
-                event.base.time_msec);
+
+        auto send_relative_motion = [&](motion_event const& motion) {
+            if (!motion.delta.isNull()) {
+                seat->pointers().relative_motion(
+                    QSizeF(motion.delta.x(), motion.delta.y()),
+                    QSizeF(motion.unaccel_delta.x(), motion.unaccel_delta.y()),
+                    motion.base.time_msec);
+            }
+        };
+
+        // Relative motions of a batch are sent one by one with their exact deltas and times.
+        if (auto const& batch = this->redirect.pointer->batched_motions; !batch.empty()) {
+            for (auto const& motion : batch) {
+                send_relative_motion(motion);
+            }
+        } else {
+            send_relative_motion(event);
         }
 
+        this->redirect.record_input_delivery(
+            seat->pointers().get_focus().surface, latency_device::pointer, event.base.time_msec);
         return true;
     }
 
@@ -80,6 +101,8 @@ public:
         auto seat = this->redirect.platform.base.server->seat();
         seat->setTimestamp(event.base.time_msec);
         this->redirect.touch->insertId(event.id, seat->touches().touch_down(event.pos));
+        this->redirect.record_input_delivery(
+            seat->touches().get_focus().surface, latency_device::touch, event.base.time_msec);
         return true;
     }
 
@@ -90,6 +113,8 @@ public:
         const qint32 wraplandId = this->redirect.touch->mappedId(event.id);
         if (wraplandId != -1) {
             seat->touches().touch_move(wraplandId, event.pos);
+            this->redirect.record_input_delivery(
+                seat->touches().get_focus().surface, latency_device::touch, event.base.time_msec);
         }
         return true;
     }
@@ -150,6 +175,8 @@ public:
             : Qt::Orientation::Vertical;
 
         seat->pointers().send_axis(orientation, event.delta, event.delta_discrete, source);
+        this->redirect.record_input_delivery(
+            seat->pointers().get_focus().surface, latency_device::pointer, event.base.time_msec);
         return true;
     }
 
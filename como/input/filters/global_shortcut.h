@@ -24,7 +24,10 @@ class global_shortcut_filter : public event_filter<Redirect>
 {
 public:
     explicit global_shortcut_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect,
+                                 event_interest::button | event_interest::axis
+                                     | event_interest::keyboard | event_interest::gesture
+                                     | event_interest::touch)
     {
         m_powerDown = new QTimer;
         m_powerDown->setSingleShot(true);
@@ -206,9 +209,9 @@ public:
             }
             if (m_touchPoints.count() >= 3 && !m_gestureCancelled) {
                 m_gestureTaken = true;
-                process_filters(
-                    this->redirect.m_filters,
-                    std::bind(&event_filter<Redirect>::touch_cancel, std::placeholders::_1));
+                process_filters(this->redirect,
+                                event_interest::touch_cancel,
+                                &event_filter<Redirect>::touch_cancel);
                 this->redirect.platform.shortcuts->processSwipeStart(
                     win::input_device_type::touchscreen, m_touchPoints.count());
                 return true;
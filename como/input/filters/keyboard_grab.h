@@ -19,7 +19,7 @@ class keyboard_grab : public event_filter<Redirect>
 {
 public:
     keyboard_grab(Redirect& redirect, KeyboardFilter* filter, xkb_keymap* keymap)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect, event_interest::keyboard)
         , filter{filter}
         , keymap{xkb_keymap_get_as_string(keymap, XKB_KEYMAP_FORMAT_TEXT_V1)}
     {
@@ -13,6 +13,7 @@
 #include <como/input/xkb/helpers.h>
 #include <como/win/input.h>
 #include <como/win/move.h>
+#include <como/win/space_qobject.h>
 
 namespace como::input
 {
@@ -22,8 +23,24 @@ class move_resize_filter : public event_filter<Redirect>
 {
 public:
     explicit move_resize_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect,
+                                 event_interest::pointer | event_interest::keyboard
+                                     | event_interest::touch)
     {
+        // Only active while a window is moved or resized.
+        auto update_active = [this] {
+            this->set_active(this->redirect.space.move_resize_window.has_value());
+        };
+        update_active();
+        notifier = QObject::connect(redirect.space.qobject.get(),
+                                    &win::space_qobject::move_resize_window_changed,
+                                    redirect.qobject.get(),
+                                    update_active);
+    }
+
+    ~move_resize_filter() override
+    {
+        QObject::disconnect(notifier);
     }
 
     bool button(button_event const& /*event*/) override
@@ -146,6 +163,7 @@ public:
 private:
     qint32 m_id = 0;
     bool m_set = false;
+    QMetaObject::Connection notifier;
 };
 
 }
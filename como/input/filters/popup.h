@@ -33,7 +33,7 @@ public:
     using space_t = typename Redirect::space_t;
 
     explicit popup_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect, event_interest::button | event_interest::keyboard)
     {
         QObject::connect(redirect.space.qobject.get(),
                          &win::space_qobject::wayland_window_added,
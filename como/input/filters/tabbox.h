@@ -24,7 +24,7 @@ class tabbox_filter : public event_filter<Redirect>
 {
 public:
     explicit tabbox_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect, event_interest::pointer | event_interest::keyboard)
     {
     }
 
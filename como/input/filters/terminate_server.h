@@ -19,7 +19,7 @@ class terminate_server_filter : public event_filter<Redirect>
 {
 public:
     explicit terminate_server_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect, event_interest::key)
     {
     }
 
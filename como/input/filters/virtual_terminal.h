@@ -19,7 +19,7 @@ class virtual_terminal_filter : public event_filter<Redirect>
 {
 public:
     explicit virtual_terminal_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect, event_interest::key)
     {
     }
 
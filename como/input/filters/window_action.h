@@ -28,7 +28,9 @@ class window_action_filter : public event_filter<Redirect>
 {
 public:
     explicit window_action_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect,
+                                 event_interest::button | event_interest::axis
+                                     | event_interest::touch_down)
     {
     }
 
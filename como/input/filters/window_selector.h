@@ -28,13 +28,16 @@ class window_selector_filter : public event_filter<Redirect>
 {
 public:
     explicit window_selector_filter(Redirect& redirect)
-        : event_filter<Redirect>(redirect)
+        : event_filter<Redirect>(redirect,
+                                 event_interest::pointer | event_interest::keyboard
+                                     | event_interest::touch)
     {
+        this->set_active(false);
     }
 
     bool button(button_event const& event) override
     {
-        if (!m_active) {
+        if (!this->is_active()) {
             return false;
         }
 
@@ -54,17 +57,17 @@ public:
 
     bool motion(motion_event const& /*event*/) override
     {
-        return m_active;
+        return this->is_active();
     }
 
     bool axis(axis_event const& /*event*/) override
     {
-        return m_active;
+        return this->is_active();
     }
 
     bool key(key_event const& event) override
     {
-        if (!m_active) {
+        if (!this->is_active()) {
             return false;
         }
 
@@ -110,7 +113,7 @@ public:
 
     bool key_repeat(key_event const& /*event*/) override
     {
-        return m_active;
+        return this->is_active();
     }
 
     bool touch_down(touch_down_event const& event) override
@@ -152,13 +155,13 @@ public:
 
     bool isActive() const
     {
-        return m_active;
+        return this->is_active();
     }
 
     void start(std::function<void(std::optional<typename Redirect::window_t>)> callback)
     {
-        Q_ASSERT(!m_active);
-        m_active = true;
+        Q_ASSERT(!this->is_active());
+        this->set_active(true);
         m_callback = callback;
         this->redirect.keyboard->update();
         this->redirect.cancelTouch();
@@ -166,8 +169,8 @@ public:
 
     void start(std::function<void(const QPoint&)> callback)
     {
-        Q_ASSERT(!m_active);
-        m_active = true;
+        Q_ASSERT(!this->is_active());
+        this->set_active(true);
         m_pointSelectionFallback = callback;
         this->redirect.keyboard->update();
         this->redirect.cancelTouch();
@@ -176,7 +179,7 @@ public:
 private:
     void deactivate()
     {
-        m_active = false;
+        this->set_active(false);
         m_callback = {};
         m_pointSelectionFallback = std::function<void(const QPoint&)>();
         this->redirect.pointer->removeWindowSelectionCursor();
@@ -212,7 +215,6 @@ private:
         accept(pos.toPoint());
     }
 
-    bool m_active = false;
     std::function<void(std::optional<typename Redirect::window_t>)> m_callback;
     std::function<void(const QPoint&)> m_pointSelectionFallback;
     QMap<quint32, QPointF> m_touchPoints;
@@ -21,8 +21,7 @@ template<typename Redirect, typename Keyboard>
 void keyboard_redirect_prepare_key(Keyboard& keys, key_event const& event)
 {
     event.base.dev->xkb->update_key(event.keycode, event.state);
-    process_spies(keys.redirect->m_spies,
-                  std::bind(&event_spy<Redirect>::key, std::placeholders::_1, event));
+    process_spies(*keys.redirect, event_interest::key, &event_spy<Redirect>::key, event);
 }
 
 class COMO_EXPORT keyboard_redirect_qobject : public QObject
@@ -18,8 +18,7 @@ template<typename Pointer>
 void pointer_redirect_process_button_spies(Pointer& ptr, button_event const& event)
 {
     using redirect_t = std::remove_pointer_t<decltype(ptr.redirect)>;
-    process_spies(ptr.redirect->m_spies,
-                  std::bind(&event_spy<redirect_t>::button, std::placeholders::_1, event));
+    process_spies(*ptr.redirect, event_interest::button, &event_spy<redirect_t>::button, event);
 }
 
 }
@@ -35,7 +35,7 @@ class keyboard_repeat_spy : public input::event_spy<Redirect>
 {
 public:
     keyboard_repeat_spy(Redirect& redirect)
-        : event_spy<Redirect>(redirect)
+        : event_spy<Redirect>(redirect, event_interest::key)
         , qobject{std::make_unique<keyboard_repeat_spy_qobject>()}
         , m_timer{std::make_unique<QTimer>()}
     {
@@ -33,7 +33,8 @@ class modifier_only_shortcuts_spy : public event_spy<Redirect>
 {
 public:
     explicit modifier_only_shortcuts_spy(Redirect& redirect)
-        : event_spy<Redirect>(redirect)
+        : event_spy<Redirect>(redirect,
+                              event_interest::key | event_interest::button | event_interest::axis)
         , qobject{std::make_unique<modifier_only_shortcuts_spy_qobject>()}
     {
         QObject::connect(redirect.space.qobject.get(),
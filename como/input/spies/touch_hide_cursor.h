@@ -16,7 +16,7 @@ class touch_hide_cursor_spy : public event_spy<Redirect>
 {
 public:
     explicit touch_hide_cursor_spy(Redirect& redirect)
-        : event_spy<Redirect>(redirect)
+        : event_spy<Redirect>(redirect, event_interest::pointer | event_interest::touch_down)
     {
     }
 
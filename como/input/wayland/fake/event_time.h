@@ -0,0 +1,22 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace como::input::wayland::fake
+{
+
+/// Time of fake events in the clock of device events, the monotonic clock in milliseconds.
+inline uint32_t get_event_time()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}
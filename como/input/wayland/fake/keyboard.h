@@ -5,6 +5,8 @@
 */
 #pragma once
 
+#include "event_time.h"
+
 #include <como/input/keyboard.h>
 
 #include <Wrapland/Server/fake_input.h>
@@ -25,17 +27,15 @@ public:
                          &Wrapland::Server::FakeInputDevice::keyboardKeyPressRequested,
                          this,
                          [this](auto button) {
-                             // TODO: Fix time
                              this->redirect.keyboard->process_key(
-                                 {button, key_state::pressed, false, {this, 0}});
+                                 {button, key_state::pressed, false, {this, get_event_time()}});
                          });
         QObject::connect(device,
                          &Wrapland::Server::FakeInputDevice::keyboardKeyReleaseRequested,
                          this,
                          [this](auto button) {
-                             // TODO: Fix time
                              this->redirect.keyboard->process_key(
-                                 {button, key_state::released, false, {this, 0}});
+                                 {button, key_state::released, false, {this, get_event_time()}});
                          });
     }
 
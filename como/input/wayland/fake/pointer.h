@@ -5,6 +5,8 @@
 */
 #pragma once
 
+#include "event_time.h"
+
 #include <como/input/pointer.h>
 
 #include <Wrapland/Server/fake_input.h>
@@ -25,17 +27,16 @@ public:
             &Wrapland::Server::FakeInputDevice::pointerMotionRequested,
             this,
             [this](auto const& delta) {
-                // TODO: Fix time
                 this->redirect.pointer->process_motion_absolute(
                     {this->redirect.globalPointer() + QPointF(delta.width(), delta.height()),
-                     {this, 0}});
+                     {this, get_event_time()}});
             });
         QObject::connect(device,
                          &Wrapland::Server::FakeInputDevice::pointerMotionAbsoluteRequested,
                          this,
                          [this](auto const& pos) {
-                             // TODO: Fix time
-                             this->redirect.pointer->process_motion_absolute({pos, {this, 0}});
+                             this->redirect.pointer->process_motion_absolute(
+                                 {pos, {this, get_event_time()}});
                          });
 
         QObject::connect(
@@ -43,28 +44,26 @@ public:
             &Wrapland::Server::FakeInputDevice::pointerButtonPressRequested,
             this,
             [this](auto button) {
-                // TODO: Fix time
-                this->redirect.pointer->process_button({button, button_state::pressed, {this, 0}});
+                this->redirect.pointer->process_button(
+                    {button, button_state::pressed, {this, get_event_time()}});
             });
         QObject::connect(
             device,
             &Wrapland::Server::FakeInputDevice::pointerButtonReleaseRequested,
             this,
             [this](auto button) {
-                // TODO: Fix time
-                this->redirect.pointer->process_button({button, button_state::released, {this, 0}});
+                this->redirect.pointer->process_button(
+                    {button, button_state::released, {this, get_event_time()}});
             });
         QObject::connect(device,
                          &Wrapland::Server::FakeInputDevice::pointerAxisRequested,
                          this,
                          [this](auto orientation, auto delta) {
-                             // TODO: Fix time
                              auto axis = (orientation == Qt::Horizontal)
                                  ? axis_orientation::horizontal
                                  : axis_orientation::vertical;
-                             // TODO: Fix time
                              this->redirect.pointer->process_axis(
-                                 {axis_source::unknown, axis, delta, 0, {this, 0}});
+                                 {axis_source::unknown, axis, delta, 0, {this, get_event_time()}});
                          });
     }
 
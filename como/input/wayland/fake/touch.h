@@ -5,6 +5,8 @@
 */
 #pragma once
 
+#include "event_time.h"
+
 #include <como/input/touch.h>
 
 #include <Wrapland/Server/fake_input.h>
@@ -25,24 +27,24 @@ public:
             &Wrapland::Server::FakeInputDevice::touchDownRequested,
             this->qobject.get(),
             [this](auto id, auto const& pos) {
-                // TODO: Fix time
-                this->redirect.touch->process_down({static_cast<int32_t>(id), pos, {nullptr, 0}});
+                this->redirect.touch->process_down(
+                    {static_cast<int32_t>(id), pos, {nullptr, get_event_time()}});
             });
         QObject::connect(
             device,
             &Wrapland::Server::FakeInputDevice::touchMotionRequested,
             this->qobject.get(),
             [this](auto id, auto const& pos) {
-                // TODO: Fix time
-                this->redirect.touch->process_motion({static_cast<int32_t>(id), pos, {nullptr, 0}});
+                this->redirect.touch->process_motion(
+                    {static_cast<int32_t>(id), pos, {nullptr, get_event_time()}});
             });
         QObject::connect(
             device,
             &Wrapland::Server::FakeInputDevice::touchUpRequested,
             this->qobject.get(),
             [this](auto id) {
-                // TODO: Fix time
-                this->redirect.touch->process_up({static_cast<int32_t>(id), {nullptr, 0}});
+                this->redirect.touch->process_up(
+                    {static_cast<int32_t>(id), {nullptr, get_event_time()}});
             });
         QObject::connect(device,
                          &Wrapland::Server::FakeInputDevice::touchCancelRequested,
@@ -24,7 +24,7 @@ class key_state_changed_spy : public event_spy<Redirect>
 {
 public:
     key_state_changed_spy(Redirect& redirect)
-        : event_spy<Redirect>(redirect)
+        : event_spy<Redirect>(redirect, event_interest::key)
     {
     }
 
@@ -39,7 +39,7 @@ class modifiers_changed_spy : public event_spy<Redirect>
 {
 public:
     modifiers_changed_spy(Redirect& redirect)
-        : event_spy<Redirect>(redirect)
+        : event_spy<Redirect>(redirect, event_interest::key)
         , m_modifiers()
     {
     }
@@ -83,15 +83,15 @@ public:
     {
         redirect->platform.xkb.numlock_config = redirect->platform.config.main;
 
-        redirect->m_spies.push_back(new key_state_changed_spy(*redirect));
+        redirect->install_spy(new key_state_changed_spy(*redirect));
         modifiers_spy = new modifiers_changed_spy(*redirect);
-        redirect->m_spies.push_back(modifiers_spy);
+        redirect->install_spy(modifiers_spy);
 
         layout_manager
             = std::make_unique<layout_manager_t>(*redirect, redirect->platform.config.xkb);
 
         if (redirect->platform.base.server->has_global_shortcut_support()) {
-            redirect->m_spies.push_back(new modifier_only_shortcuts_spy(*redirect));
+            redirect->install_spy(new modifier_only_shortcuts_spy(*redirect));
         }
 
         auto keyRepeatSpy = new keyboard_repeat_spy(*redirect);
@@ -99,7 +99,7 @@ public:
                          &keyboard_repeat_spy_qobject::key_repeated,
                          qobject.get(),
                          [this](auto const& event) { process_key_repeat(event); });
-        redirect->m_spies.push_back(keyRepeatSpy);
+        redirect->install_spy(keyRepeatSpy);
 
         QObject::connect(redirect->space.qobject.get(),
                          &space_t::qobject_t::clientActivated,
@@ -191,26 +191,32 @@ public:
 
     void process_key(key_event const& event)
     {
+        redirect->flush_motions();
+
         auto& xkb = event.base.dev->xkb;
 
         keyboard_redirect_prepare_key<Redirect>(*this, event);
 
-        process_filters(redirect->m_filters,
-                        std::bind(&event_filter<Redirect>::key, std::placeholders::_1, event));
+        process_filters(*redirect, event_interest::key, &event_filter<Redirect>::key, event);
         xkb->forward_modifiers();
     }
 
     void process_key_repeat(key_event const& event)
     {
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::key_repeat, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::key_repeat, std::placeholders::_1, event));
+        process_spies(*redirect,
+                      event_interest::key_repeat,
+                      &event_spy<Redirect>::key_repeat,
+                      event);
+        process_filters(*redirect,
+                        event_interest::key_repeat,
+                        &event_filter<Redirect>::key_repeat,
+                        event);
     }
 
     void process_modifiers(modifiers_event const& event)
     {
+        redirect->flush_motions();
+
         auto const& xkb = event.base.dev->xkb.get();
 
         // TODO: send to proper Client and also send when active Client changes
@@ -5,9 +5,13 @@
 */
 #pragma once
 
+#include <como/input/event.h>
+
 #include <QPointF>
 #include <cstdint>
 #include <deque>
+#include <optional>
+#include <vector>
 
 namespace como::input::wayland
 {
@@ -61,6 +65,46 @@ public:
         motions.emplace_back(position{{}, delta, unaccel_delta, time, false});
     }
 
+    /**
+     * Batched motions are processed together on the next flush. Relative and absolute motions are
+     * not mixed in a batch. Of absolute motions only the last one is processed.
+     */
+    void batch(motion_event const& event)
+    {
+        if (batched.absolute) {
+            flush();
+        }
+        batched.relative.push_back(event);
+    }
+
+    void batch(motion_absolute_event const& event)
+    {
+        if (!batched.relative.empty()) {
+            flush();
+        }
+        batched.absolute = event;
+    }
+
+    bool has_batch() const
+    {
+        return !batched.relative.empty() || batched.absolute;
+    }
+
+    void flush()
+    {
+        if (!batched.relative.empty()) {
+            auto const events = std::move(batched.relative);
+            batched.relative = {};
+            device.process_motion_batch(events);
+            return;
+        }
+        if (batched.absolute) {
+            auto const event = *batched.absolute;
+            batched.absolute.reset();
+            device.process_motion_absolute_batch(event);
+        }
+    }
+
 private:
     struct position {
         QPointF pos;
@@ -72,6 +116,12 @@ private:
 
     std::deque<position> motions;
     int locked{0};
+
+    struct {
+        std::vector<motion_event> relative;
+        std::optional<motion_absolute_event> absolute;
+    } batched;
+
     Device& device;
 };
 
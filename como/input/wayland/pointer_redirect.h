@@ -24,6 +24,7 @@
 #include <Wrapland/Server/pointer_pool.h>
 #include <Wrapland/Server/seat.h>
 #include <Wrapland/Server/touch_pool.h>
+#include <vector>
 
 namespace como::input::wayland
 {
@@ -381,17 +382,42 @@ public:
             return;
         }
 
+        // Only motions of devices are batched. Warps are processed directly.
+        if (redirect->batch_motions && event.base.dev) {
+            motions.batch(event);
+            redirect->schedule_motions_flush();
+            return;
+        }
+
+        motions.flush();
+        process_motion_batch({event});
+    }
+
+    /// Processes relative motions as one. Clients still receive each relative motion.
+    void process_motion_batch(std::vector<motion_event> const& events)
+    {
+        assert(!events.empty());
         blocker block(&motions);
 
+        auto event = events.back();
+        event.delta = {};
+        event.unaccel_delta = {};
+
+        for (auto const& motion : events) {
+            event.delta += motion.delta;
+            event.unaccel_delta += motion.unaccel_delta;
+        }
+
         auto const pos = this->pos() + QPointF(event.delta.x(), event.delta.y());
         update_position(pos);
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::motion, std::placeholders::_1, event));
-        process_filters(redirect->m_filters,
-                        std::bind(&event_filter<Redirect>::motion, std::placeholders::_1, event));
+        batched_motions = events;
 
+        process_spies(*redirect, event_interest::motion, &event_spy<Redirect>::motion, event);
+        process_filters(*redirect, event_interest::motion, &event_filter<Redirect>::motion, event);
+
+        batched_motions.clear();
         process_frame();
     }
 
@@ -402,6 +428,19 @@ public:
             return;
         }
 
+        if (redirect->batch_motions && event.base.dev) {
+            motions.batch(event);
+            redirect->schedule_motions_flush();
+            return;
+        }
+
+        motions.flush();
+        process_motion_absolute_batch(event);
+    }
+
+    /// Processes the last absolute motion of a batch.
+    void process_motion_absolute_batch(motion_absolute_event const& event)
+    {
         auto const& space_size = redirect->platform.base.topology.size;
         auto const pos
             = QPointF(space_size.width() * event.pos.x(), space_size.height() * event.pos.y());
@@ -412,11 +451,11 @@ public:
 
         auto motion_ev = motion_event({{}, {}, event.base});
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::motion, std::placeholders::_1, motion_ev));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::motion, std::placeholders::_1, motion_ev));
+        process_spies(*redirect, event_interest::motion, &event_spy<Redirect>::motion, motion_ev);
+        process_filters(*redirect,
+                        event_interest::motion,
+                        &event_filter<Redirect>::motion,
+                        motion_ev);
 
         process_frame();
     }
@@ -433,6 +472,8 @@ public:
 
     void process_button(button_event const& event)
     {
+        redirect->flush_motions();
+
         if (event.state == button_state::pressed) {
             // Check focus before processing spies/filters.
             device_redirect_update(this);
@@ -440,8 +481,7 @@ public:
 
         update_button(event);
         pointer_redirect_process_button_spies(*this, event);
-        process_filters(redirect->m_filters,
-                        std::bind(&event_filter<Redirect>::button, std::placeholders::_1, event));
+        process_filters(*redirect, event_interest::button, &event_filter<Redirect>::button, event);
 
         if (event.state == button_state::released) {
             // Check focus after processing spies/filters.
@@ -453,99 +493,145 @@ public:
 
     void process_axis(axis_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::axis, std::placeholders::_1, event));
-        process_filters(redirect->m_filters,
-                        std::bind(&event_filter<Redirect>::axis, std::placeholders::_1, event));
+        process_spies(*redirect, event_interest::axis, &event_spy<Redirect>::axis, event);
+        process_filters(*redirect, event_interest::axis, &event_filter<Redirect>::axis, event);
 
         process_frame();
     }
 
     void process_swipe_begin(swipe_begin_event const& event)
     {
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::swipe_begin, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::swipe_begin, std::placeholders::_1, event));
+        redirect->flush_motions();
+
+        process_spies(*redirect,
+                      event_interest::swipe_begin,
+                      &event_spy<Redirect>::swipe_begin,
+                      event);
+        process_filters(*redirect,
+                        event_interest::swipe_begin,
+                        &event_filter<Redirect>::swipe_begin,
+                        event);
     }
 
     void process_swipe_update(swipe_update_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::swipe_update, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::swipe_update, std::placeholders::_1, event));
+        process_spies(*redirect,
+                      event_interest::swipe_update,
+                      &event_spy<Redirect>::swipe_update,
+                      event);
+        process_filters(*redirect,
+                        event_interest::swipe_update,
+                        &event_filter<Redirect>::swipe_update,
+                        event);
     }
 
     void process_swipe_end(swipe_end_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::swipe_end, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::swipe_end, std::placeholders::_1, event));
+        process_spies(*redirect, event_interest::swipe_end, &event_spy<Redirect>::swipe_end, event);
+        process_filters(*redirect,
+                        event_interest::swipe_end,
+                        &event_filter<Redirect>::swipe_end,
+                        event);
     }
 
     void process_pinch_begin(pinch_begin_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::pinch_begin, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::pinch_begin, std::placeholders::_1, event));
+        process_spies(*redirect,
+                      event_interest::pinch_begin,
+                      &event_spy<Redirect>::pinch_begin,
+                      event);
+        process_filters(*redirect,
+                        event_interest::pinch_begin,
+                        &event_filter<Redirect>::pinch_begin,
+                        event);
     }
 
     void process_pinch_update(pinch_update_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::pinch_update, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::pinch_update, std::placeholders::_1, event));
+        process_spies(*redirect,
+                      event_interest::pinch_update,
+                      &event_spy<Redirect>::pinch_update,
+                      event);
+        process_filters(*redirect,
+                        event_interest::pinch_update,
+                        &event_filter<Redirect>::pinch_update,
+                        event);
     }
 
     void process_pinch_end(pinch_end_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::pinch_end, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::pinch_end, std::placeholders::_1, event));
+        process_spies(*redirect, event_interest::pinch_end, &event_spy<Redirect>::pinch_end, event);
+        process_filters(*redirect,
+                        event_interest::pinch_end,
+                        &event_filter<Redirect>::pinch_end,
+                        event);
     }
 
     void process_hold_begin(hold_begin_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::hold_begin, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&event_filter<Redirect>::hold_begin, std::placeholders::_1, event));
+        process_spies(*redirect,
+                      event_interest::hold_begin,
+                      &event_spy<Redirect>::hold_begin,
+                      event);
+        process_filters(*redirect,
+                        event_interest::hold_begin,
+                        &event_filter<Redirect>::hold_begin,
+                        event);
     }
 
     void process_hold_end(hold_end_event const& event)
     {
+        redirect->flush_motions();
+
         device_redirect_update(this);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::hold_end, std::placeholders::_1, event));
-        process_filters(redirect->m_filters,
-                        std::bind(&event_filter<Redirect>::hold_end, std::placeholders::_1, event));
+        process_spies(*redirect, event_interest::hold_end, &event_spy<Redirect>::hold_end, event);
+        process_filters(*redirect,
+                        event_interest::hold_end,
+                        &event_filter<Redirect>::hold_end,
+                        event);
+    }
+
+    void flush_motions()
+    {
+        motions.flush();
+    }
+
+    void frame()
+    {
+        if (motions.has_batch()) {
+            // Processing the batched motions sends a single frame for all of them.
+            return;
+        }
+        process_frame();
     }
 
     void process_frame()
@@ -765,6 +851,9 @@ public:
         return m_pos.toPoint();
     }
 
+    /// The relative motions of the batch being processed.
+    std::vector<motion_event> batched_motions;
+
     std::unique_ptr<QObject> qobject;
     Redirect* redirect;
 
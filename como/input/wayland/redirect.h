@@ -37,8 +37,11 @@
 #include <como/input/redirect_qobject.h>
 #include <como/input/spies/activity.h>
 #include <como/input/spies/touch_hide_cursor.h>
+#include <como/input/window_index.h>
+#include <como/render/wayland/input_latency.h>
 
 #include <KConfigWatcher>
+#include <QTimer>
 #include <Wrapland/Server/display.h>
 #include <Wrapland/Server/fake_input.h>
 #include <Wrapland/Server/keyboard_pool.h>
@@ -46,6 +49,8 @@
 #include <Wrapland/Server/seat.h>
 #include <Wrapland/Server/touch_pool.h>
 #include <Wrapland/Server/virtual_keyboard_v1.h>
+#include <algorithm>
+#include <chrono>
 #include <unordered_map>
 
 namespace como::input::wayland
@@ -73,6 +78,16 @@ public:
         setup_workspace();
 
         using base_t = std::decay_t<decltype(platform.base)>;
+        using render_t = typename base_t::render_t;
+
+        motions_flush_timer.setSingleShot(true);
+        QObject::connect(
+            &motions_flush_timer, &QTimer::timeout, qobject.get(), [this] { flush_motions(); });
+        QObject::connect(platform.base.mod.render->qobject.get(),
+                         &render_t::qobject_t::frame_started,
+                         qobject.get(),
+                         [this] { flush_motions(); });
+
         QObject::connect(platform.base.qobject.get(),
                          &base_t::qobject_t::output_added,
                          this->qobject.get(),
@@ -190,6 +205,56 @@ public:
         return window_selector && window_selector->isActive();
     }
 
+    /**
+     * Tags input that was sent to @p surface with the time of its device event. The latency is
+     * measured until the surface presents its response.
+     */
+    void record_input_delivery(Wrapland::Server::Surface* surface,
+                               render::wayland::input_latency_device device,
+                               uint32_t time_msec)
+    {
+        if (!surface) {
+            return;
+        }
+        platform.base.mod.render->presentation->latency.delivered(surface, device, time_msec);
+    }
+
+    /**
+     * Schedules processing the batched motions of all devices. They are processed when the next
+     * frame starts, but at the latest after one refresh cycle of the output with the pointer. When
+     * no frame is scheduled they are processed right away.
+     */
+    void schedule_motions_flush()
+    {
+        if (motions_flush_timer.isActive()) {
+            return;
+        }
+
+        auto const& outputs = platform.base.outputs;
+        if (std::none_of(outputs.cbegin(), outputs.cend(), [](auto output) {
+                return output->render->is_frame_scheduled();
+            })) {
+            // Waiting would only add latency. Motions are batched again once frames are painted.
+            flush_motions();
+            return;
+        }
+
+        auto interval = std::chrono::milliseconds(16);
+        auto output = base::get_nearest_output(outputs, pointer->pos().toPoint());
+        if (auto const rate = output->refresh_rate(); rate > 0) {
+            interval = std::chrono::milliseconds(std::max(1000 * 1000 / rate, 1));
+        }
+
+        motions_flush_timer.start(interval);
+    }
+
+    void flush_motions()
+    {
+        motions_flush_timer.stop();
+        pointer->flush_motions();
+        touch->flush_motions();
+    }
+
     /**
      * Adds the @p filter to the list of event filters at the last relevant position.
      *
@@ -200,6 +265,7 @@ public:
     {
         Q_ASSERT(!contains(m_filters, filter));
         m_filters.insert(m_filters_install_iterator, filter);
+        filter_index.invalidate();
     }
 
     /**
@@ -213,11 +279,27 @@ public:
     {
         Q_ASSERT(!contains(m_filters, filter));
         m_filters.insert(m_filters.begin(), filter);
+        filter_index.invalidate();
     }
 
     void uninstallInputEventFilter(event_filter<type>* filter)
     {
         remove_all(m_filters, filter);
+        filter_index.invalidate();
+    }
+
+    /// Adds the @p spy to the back of the list of event spies.
+    void install_spy(event_spy_t* spy)
+    {
+        Q_ASSERT(!contains(m_spies, spy));
+        m_spies.push_back(spy);
+        spy_index.invalidate();
+    }
+
+    void uninstall_spy(event_spy_t* spy)
+    {
+        remove_all(m_spies, spy);
+        spy_index.invalidate();
     }
 
     std::unique_ptr<keyboard_redirect<type>> keyboard;
@@ -226,12 +308,20 @@ public:
     std::unique_ptr<touch_redirect<type>> touch;
 
     std::unique_ptr<wayland::cursor<type>> cursor;
+    std::unique_ptr<input::window_index<Space>> window_index;
 
     std::list<event_filter<type>*> m_filters;
     std::vector<event_spy_t*> m_spies;
 
+    /// Active filters and spies per event type. Invalidated on changes to the lists above.
+    event_interest_index<event_filter<type>> filter_index;
+    event_interest_index<event_spy_t> spy_index;
+
     std::unique_ptr<input::dpms_filter<type>> dpms_filter;
 
+    /// Motions of devices are batched and processed once per frame.
+    bool batch_motions{false};
+
     std::unique_ptr<redirect_qobject> qobject;
     platform_t& platform;
     Space& space;
@@ -250,13 +340,17 @@ private:
                          &KConfigWatcher::configChanged,
                          qobject.get(),
                          [this](auto const& group) {
-                             if (group.name() == QLatin1String("Keyboard")) {
+                             if (group.name() == QLatin1String("Keyboard")
+                                 || group.name() == QLatin1String("Mouse")) {
                                  reconfigure();
                              }
                          });
 
         cursor = std::make_unique<wayland::cursor<type>>(*this);
 
+        window_index = std::make_unique<input::window_index<Space>>(space);
+        window_index_setup(*this);
+
         pointer = std::make_unique<wayland::pointer_redirect<type>>(this);
         keyboard = std::make_unique<wayland::keyboard_redirect<type>>(this);
         touch = std::make_unique<wayland::touch_redirect<type>>(this);
@@ -299,6 +393,7 @@ private:
                          [this](auto pointer) { handle_pointer_added(pointer); });
         QObject::connect(
             platform.qobject.get(), &platform_qobject::pointer_removed, qobject.get(), [this]() {
+                flush_motions();
                 if (platform.pointers.empty()) {
                     auto seat = platform.base.server->seat();
                     unset_focus(pointer.get());
@@ -331,6 +426,7 @@ private:
                          [this](auto touch) { handle_touch_added(touch); });
         QObject::connect(
             platform.qobject.get(), &platform_qobject::touch_removed, qobject.get(), [this]() {
+                flush_motions();
                 if (platform.touchs.empty()) {
                     auto seat = platform.base.server->seat();
                     unset_focus(touch.get());
@@ -355,8 +451,8 @@ private:
             m_filters.emplace_back(new virtual_terminal_filter<type>(*this));
         }
 
-        m_spies.push_back(new activity_spy(*this));
-        m_spies.push_back(new touch_hide_cursor_spy(*this));
+        install_spy(new activity_spy(*this));
+        install_spy(new touch_hide_cursor_spy(*this));
         if (has_global_shortcuts) {
             m_filters.emplace_back(new terminate_server_filter<type>(*this));
         }
@@ -387,6 +483,7 @@ private:
         m_filters_install_iterator
             = m_filters.insert(m_filters.cend(), new forward_filter<type>(*this));
         m_filters.emplace_back(new fake_tablet_filter(*this));
+        filter_index.invalidate();
     }
 
     void reconfigure()
@@ -405,6 +502,9 @@ private:
         if (auto seat = platform.base.server->seat(); seat->hasKeyboard()) {
             seat->keyboards().set_repeat_info(enabled ? rate : 0, delay);
         }
+
+        batch_motions
+            = input_config->group(QStringLiteral("Mouse")).readEntry("BatchMotions", false);
     }
 
     void handle_pointer_added(input::pointer* pointer)
@@ -475,7 +575,7 @@ private:
             [pointer_red](auto const& event) { pointer_red->process_hold_end(event); });
 
         QObject::connect(pointer, &pointer::frame, pointer_red->qobject.get(), [pointer_red] {
-            pointer_red->process_frame();
+            pointer_red->frame();
         });
 
         auto seat = platform.base.server->seat();
@@ -564,6 +664,7 @@ private:
     {
         QObject::connect(
             switch_device, &switch_device::toggle, qobject.get(), [this](auto const& event) {
+                flush_motions();
                 if (event.type == switch_type::tablet_mode) {
                     Q_EMIT qobject->has_tablet_mode_switch_changed(event.state == switch_state::on);
                 }
@@ -634,6 +735,7 @@ private:
     }
 
     KConfigWatcher::Ptr config_watcher;
+    QTimer motions_flush_timer;
 
     std::unique_ptr<wayland::input_method<type>> input_method;
     std::unique_ptr<dbus::tablet_mode_manager<type>> tablet_mode_manager;
@@ -58,6 +58,8 @@ public:
                          quint64 /*toolId*/,
                          void* /*device*/)
     {
+        redirect->flush_motions();
+
         last_position = pos;
 
         auto t = QEvent::None;
@@ -88,11 +90,14 @@ public:
                         button,
                         button);
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::tabletToolEvent, std::placeholders::_1, &ev));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&input::event_filter<Redirect>::tabletToolEvent, std::placeholders::_1, &ev));
+        process_spies(*redirect,
+                      event_interest::tablet_tool,
+                      &event_spy<Redirect>::tabletToolEvent,
+                      &ev);
+        process_filters(*redirect,
+                        event_interest::tablet_tool,
+                        &input::event_filter<Redirect>::tabletToolEvent,
+                        &ev);
 
         tip.down = tip_down;
         tip.near = tip_near;
@@ -100,70 +105,78 @@ public:
 
     void tabletToolButtonEvent(uint button, bool isPressed)
     {
+        redirect->flush_motions();
+
         if (isPressed) {
             pressed_buttons.tool.insert(button);
         } else {
             pressed_buttons.tool.remove(button);
         }
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::tabletToolButtonEvent,
-                                std::placeholders::_1,
-                                pressed_buttons.tool));
-        process_filters(redirect->m_filters,
-                        std::bind(&input::event_filter<Redirect>::tabletToolButtonEvent,
-                                  std::placeholders::_1,
-                                  pressed_buttons.tool));
+        process_spies(*redirect,
+                      event_interest::tablet_tool_button,
+                      &event_spy<Redirect>::tabletToolButtonEvent,
+                      pressed_buttons.tool);
+        process_filters(*redirect,
+                        event_interest::tablet_tool_button,
+                        &input::event_filter<Redirect>::tabletToolButtonEvent,
+                        pressed_buttons.tool);
     }
 
     void tabletPadButtonEvent(uint button, bool isPressed)
     {
+        redirect->flush_motions();
+
         if (isPressed) {
             pressed_buttons.pad.insert(button);
         } else {
             pressed_buttons.pad.remove(button);
         }
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::tabletPadButtonEvent,
-                                std::placeholders::_1,
-                                pressed_buttons.pad));
-        process_filters(redirect->m_filters,
-                        std::bind(&input::event_filter<Redirect>::tabletPadButtonEvent,
-                                  std::placeholders::_1,
-                                  pressed_buttons.pad));
+        process_spies(*redirect,
+                      event_interest::tablet_pad_button,
+                      &event_spy<Redirect>::tabletPadButtonEvent,
+                      pressed_buttons.pad);
+        process_filters(*redirect,
+                        event_interest::tablet_pad_button,
+                        &input::event_filter<Redirect>::tabletPadButtonEvent,
+                        pressed_buttons.pad);
     }
 
     void tabletPadStripEvent(int number, int position, bool is_finger)
     {
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::tabletPadStripEvent,
-                                std::placeholders::_1,
-                                number,
-                                position,
-                                is_finger));
-        process_filters(redirect->m_filters,
-                        std::bind(&input::event_filter<Redirect>::tabletPadStripEvent,
-                                  std::placeholders::_1,
-                                  number,
-                                  position,
-                                  is_finger));
+        redirect->flush_motions();
+
+        process_spies(*redirect,
+                      event_interest::tablet_pad_strip,
+                      &event_spy<Redirect>::tabletPadStripEvent,
+                      number,
+                      position,
+                      is_finger);
+        process_filters(*redirect,
+                        event_interest::tablet_pad_strip,
+                        &input::event_filter<Redirect>::tabletPadStripEvent,
+                        number,
+                        position,
+                        is_finger);
     }
 
     void tabletPadRingEvent(int number, int position, bool is_finger)
     {
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::tabletPadRingEvent,
-                                std::placeholders::_1,
-                                number,
-                                position,
-                                is_finger));
-        process_filters(redirect->m_filters,
-                        std::bind(&input::event_filter<Redirect>::tabletPadRingEvent,
-                                  std::placeholders::_1,
-                                  number,
-                                  position,
-                                  is_finger));
+        redirect->flush_motions();
+
+        process_spies(*redirect,
+                      event_interest::tablet_pad_ring,
+                      &event_spy<Redirect>::tabletPadRingEvent,
+                      number,
+                      position,
+                      is_finger);
+        process_filters(*redirect,
+                        event_interest::tablet_pad_ring,
+                        &input::event_filter<Redirect>::tabletPadRingEvent,
+                        number,
+                        position,
+                        is_finger);
     }
 
     void cleanupInternalWindow(QWindow* /*old*/, QWindow* /*now*/)
@@ -19,6 +19,8 @@
 #include <Wrapland/Server/drag_pool.h>
 #include <Wrapland/Server/seat.h>
 #include <Wrapland/Server/touch_pool.h>
+#include <map>
+#include <utility>
 
 namespace como::input::wayland
 {
@@ -71,6 +73,8 @@ public:
 
     void process_down(touch_down_event const& event)
     {
+        redirect->flush_motions();
+
         auto const event_abs = touch_down_event({event.id,
                                                  get_abs_pos(event.pos, event.base.dev),
                                                  {event.base.dev, event.base.time_msec}});
@@ -81,25 +85,28 @@ public:
         if (m_touches == 1) {
             device_redirect_update(this);
         }
-        process_spies(
-            redirect->m_spies,
-            std::bind(&event_spy<Redirect>::touch_down, std::placeholders::_1, event_abs));
-        process_filters(redirect->m_filters,
-                        std::bind(&input::event_filter<Redirect>::touch_down,
-                                  std::placeholders::_1,
-                                  event_abs));
+        process_spies(*redirect,
+                      event_interest::touch_down,
+                      &event_spy<Redirect>::touch_down,
+                      event_abs);
+        process_filters(*redirect,
+                        event_interest::touch_down,
+                        &input::event_filter<Redirect>::touch_down,
+                        event_abs);
         window_already_updated_this_cycle = false;
     }
 
     void process_up(touch_up_event const& event)
     {
+        redirect->flush_motions();
+
         window_already_updated_this_cycle = false;
 
-        process_spies(redirect->m_spies,
-                      std::bind(&event_spy<Redirect>::touch_up, std::placeholders::_1, event));
-        process_filters(
-            redirect->m_filters,
-            std::bind(&input::event_filter<Redirect>::touch_up, std::placeholders::_1, event));
+        process_spies(*redirect, event_interest::touch_up, &event_spy<Redirect>::touch_up, event);
+        process_filters(*redirect,
+                        event_interest::touch_up,
+                        &input::event_filter<Redirect>::touch_up,
+                        event);
 
         window_already_updated_this_cycle = false;
         m_touches--;
@@ -115,18 +122,33 @@ public:
                                                    get_abs_pos(event.pos, event.base.dev),
                                                    {event.base.dev, event.base.time_msec}});
 
-        m_lastPosition = event_abs.pos;
-        window_already_updated_this_cycle = false;
+        if (redirect->batch_motions && event.base.dev) {
+            // Of each touch point only the last motion in a batch is processed.
+            batched.motions.insert_or_assign(event.id, event_abs);
+            redirect->schedule_motions_flush();
+            return;
+        }
+
+        flush_motions();
+        process_motion_abs(event_abs);
+    }
 
-        process_spies(
-            redirect->m_spies,
-            std::bind(&event_spy<Redirect>::touch_motion, std::placeholders::_1, event_abs));
-        process_filters(redirect->m_filters,
-                        std::bind(&input::event_filter<Redirect>::touch_motion,
-                                  std::placeholders::_1,
-                                  event_abs));
+    /// Processes the batched motions and the touch frame that followed them.
+    void flush_motions()
+    {
+        if (batched.motions.empty()) {
+            return;
+        }
 
-        window_already_updated_this_cycle = false;
+        auto const motions = std::move(batched.motions);
+        batched.motions = {};
+
+        for (auto const& [id, event] : motions) {
+            process_motion_abs(event);
+        }
+        if (std::exchange(batched.frame, false)) {
+            frame();
+        }
     }
 
     bool focusUpdatesBlocked()
@@ -150,6 +172,8 @@ public:
 
     void cancel()
     {
+        redirect->flush_motions();
+
         if (!redirect->platform.base.server->seat()->hasTouch()) {
             return;
         }
@@ -159,11 +183,17 @@ public:
 
     void frame()
     {
+        if (!batched.motions.empty()) {
+            // The frame is processed after the batched motions.
+            batched.frame = true;
+            return;
+        }
         if (!redirect->platform.base.server->seat()->hasTouch()) {
             return;
         }
-        process_filters(redirect->m_filters,
-                        std::bind(&event_filter<Redirect>::touch_frame, std::placeholders::_1));
+        process_filters(*redirect,
+                        event_interest::touch_frame,
+                        &event_filter<Redirect>::touch_frame);
     }
 
     void insertId(qint32 internalId, qint32 wraplandId)
@@ -302,6 +332,23 @@ private:
         return QPointF(geo.x() + geo.width() * pos.x(), geo.y() + geo.height() * pos.y());
     }
 
+    void process_motion_abs(touch_motion_event const& event_abs)
+    {
+        m_lastPosition = event_abs.pos;
+        window_already_updated_this_cycle = false;
+
+        process_spies(*redirect,
+                      event_interest::touch_motion,
+                      &event_spy<Redirect>::touch_motion,
+                      event_abs);
+        process_filters(*redirect,
+                        event_interest::touch_motion,
+                        &input::event_filter<Redirect>::touch_motion,
+                        event_abs);
+
+        window_already_updated_this_cycle = false;
+    }
+
     qint32 m_decorationId = -1;
     qint32 m_internalId = -1;
 
@@ -314,6 +361,11 @@ private:
     QPointF m_lastPosition;
 
     int m_touches = 0;
+
+    struct {
+        std::map<int32_t, touch_motion_event> motions;
+        bool frame{false};
+    } batched;
 };
 
 }
@@ -16,17 +16,9 @@ auto find_controlled_window(Redirect const& redirect, QPoint const& pos)
     -> std::optional<typename Redirect::window_t>
 {
     auto const isScreenLocked = base::wayland::is_screen_locked(redirect.platform.base);
-    auto const& stacking = redirect.space.stacking.order.stack;
-    if (stacking.empty()) {
-        return {};
-    }
-
-    auto it = stacking.end();
 
-    do {
-        --it;
-
-        if (std::visit(overload{[&](auto&& win) {
+    auto accepts = [&](auto const& var_win) {
+        return std::visit(overload{[&](auto&& win) {
                            if (win->remnant) {
                                // a deleted window doesn't get mouse events
                                return false;
@@ -59,12 +51,20 @@ auto find_controlled_window(Redirect const& redirect, QPoint const& pos)
                            return win::input_geometry(win).contains(pos)
                                && win::wayland::accepts_input(win, pos);
                        }},
-                       *it)) {
-            return *it;
-        }
-    } while (it != stacking.begin());
+                       var_win);
+    };
 
-    return {};
+    if constexpr (requires { redirect.window_index; }) {
+        return redirect.window_index->stack().find(pos, accepts);
+    } else {
+        auto const& stacking = redirect.space.stacking.order.stack;
+        for (auto it = stacking.crbegin(); it != stacking.crend(); ++it) {
+            if (accepts(*it)) {
+                return *it;
+            }
+        }
+        return {};
+    }
 }
 
 template<typename Redirect>
@@ -82,15 +82,25 @@ auto find_window(Redirect const& redirect, QPoint const& pos)
     }
 
     // Check windows without control (important for Xwayland unmanageds).
-    for (auto const& win : redirect.space.windows) {
-        if (std::visit(overload{[&](auto&& win) {
-                           return !win->control && !win->remnant
-                               && win::input_geometry(win).contains(pos)
-                               && win::wayland::accepts_input(win, pos);
-                       }},
-                       win)) {
+    auto accepts = [&](auto const& var_win) {
+        return std::visit(overload{[&](auto&& win) {
+                              return !win->control && !win->remnant
+                                  && win::input_geometry(win).contains(pos)
+                                  && win::wayland::accepts_input(win, pos);
+                          }},
+                          var_win);
+    };
+
+    if constexpr (requires { redirect.window_index; }) {
+        if (auto win = redirect.window_index->windows().find(pos, accepts)) {
             return win;
         }
+    } else {
+        for (auto const& win : redirect.space.windows) {
+            if (accepts(win)) {
+                return win;
+            }
+        }
     }
 
     return find_controlled_window(redirect, pos);
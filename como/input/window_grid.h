@@ -0,0 +1,142 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QPoint>
+#include <QRect>
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace como::input
+{
+
+/**
+ * Uniform grid of window rects over an area, such that only the windows with a rect in the cell of
+ * a point must be checked to find the window at that point.
+ *
+ * Windows are checked in the order they were added. Points outside of the area are checked against
+ * all windows.
+ */
+template<typename Window>
+class window_grid
+{
+public:
+    static constexpr int cell_size{256};
+
+    using entry_t = std::pair<QRect, Window>;
+
+    void build(QRect const& area, std::vector<entry_t> entries)
+    {
+        this->area = area;
+        this->entries = std::move(entries);
+
+        columns = area.isEmpty() ? 0 : (area.width() + cell_size - 1) / cell_size;
+        rows = area.isEmpty() ? 0 : (area.height() + cell_size - 1) / cell_size;
+
+        cells.assign(columns * rows, {});
+
+        for (size_t index = 0; index < this->entries.size(); ++index) {
+            for_each_cell(this->entries.at(index).first,
+                          [index](auto& cell) { cell.push_back(index); });
+        }
+    }
+
+    /**
+     * Sets the rect of @p window to @p rect. Only the cells of its previous and its new rect are
+     * changed. Returns false if the window is not in the grid.
+     */
+    bool update(Window const& window, QRect const& rect)
+    {
+        auto it = std::find_if(entries.begin(), entries.end(), [&](auto const& entry) {
+            return entry.second == window;
+        });
+        if (it == entries.end()) {
+            return false;
+        }
+
+        auto const index = static_cast<size_t>(it - entries.begin());
+
+        for_each_cell(it->first, [index](auto& cell) {
+            auto const pos = std::lower_bound(cell.begin(), cell.end(), index);
+            assert(pos != cell.end() && *pos == index);
+            cell.erase(pos);
+        });
+
+        it->first = rect;
+
+        // Keep the order of the entries in the cells.
+        for_each_cell(rect, [index](auto& cell) {
+            cell.insert(std::lower_bound(cell.begin(), cell.end(), index), index);
+        });
+
+        return true;
+    }
+
+    /// Returns the first window with a rect containing @p pos for which @p predicate is true.
+    template<typename Predicate>
+    std::optional<Window> find(QPoint const& pos, Predicate&& predicate) const
+    {
+        auto check = [&](size_t index) {
+            auto const& entry = entries.at(index);
+            return entry.first.contains(pos) && predicate(entry.second);
+        };
+
+        if (!area.contains(pos)) {
+            for (size_t index = 0; index < entries.size(); ++index) {
+                if (check(index)) {
+                    return entries.at(index).second;
+                }
+            }
+            return {};
+        }
+
+        auto const cell = get_cell_pos(pos);
+        for (auto index : cells.at(cell.y() * columns + cell.x())) {
+            if (check(index)) {
+                return entries.at(index).second;
+            }
+        }
+        return {};
+    }
+
+private:
+    QPoint get_cell_pos(QPoint const& pos) const
+    {
+        return {(pos.x() - area.x()) / cell_size, (pos.y() - area.y()) / cell_size};
+    }
+
+    template<typename Function>
+    void for_each_cell(QRect const& rect, Function&& function)
+    {
+        auto const area_rect = rect & area;
+        if (area_rect.isEmpty()) {
+            return;
+        }
+
+        auto const first = get_cell_pos(area_rect.topLeft());
+        auto const last = get_cell_pos(area_rect.bottomRight());
+
+        for (auto row = first.y(); row <= last.y(); ++row) {
+            for (auto column = first.x(); column <= last.x(); ++column) {
+                function(cells.at(row * columns + column));
+            }
+        }
+    }
+
+    QRect area;
+    int columns{0};
+    int rows{0};
+
+    std::vector<entry_t> entries;
+
+    // Per cell the indices of the entries with a rect in the cell, in the order of the entries.
+    std::vector<std::vector<size_t>> cells;
+};
+
+}
@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "window_grid.h"
+
+#include <como/base/platform_qobject.h>
+#include <como/win/geo.h>
+#include <como/win/space_qobject.h>
+#include <como/win/stacking_order.h>
+#include <como/win/window_qobject.h>
+
+namespace como::input
+{
+
+/**
+ * Grids of the input geometries of all windows in a space for finding the window at a position.
+ *
+ * The grids are rebuilt on the next lookup after windows were added, removed or restacked, or the
+ * topology changed. When a window changes its geometry only its own cells are updated. Other state,
+ * for example if a window is minimized, is checked on lookup.
+ */
+template<typename Space>
+class window_index
+{
+public:
+    using window_t = typename Space::window_t;
+    using grid_t = window_grid<window_t>;
+
+    window_index(Space& space)
+        : space{space}
+    {
+    }
+
+    void invalidate()
+    {
+        dirty = true;
+    }
+
+    void update_geometry(window_t const& var_win)
+    {
+        if (dirty) {
+            // Rebuilt anyway on the next lookup.
+            return;
+        }
+
+        auto const rect
+            = std::visit(overload{[](auto&& win) { return win::input_geometry(win); }}, var_win);
+        if (!list.update(var_win, rect) || !stacking.update(var_win, rect)) {
+            invalidate();
+        }
+    }
+
+    /// All windows in the order of the space's window list.
+    grid_t const& windows()
+    {
+        update();
+        return list;
+    }
+
+    /// All windows in the stacking order from top to bottom.
+    grid_t const& stack()
+    {
+        update();
+        return stacking;
+    }
+
+private:
+    void update()
+    {
+        if (!dirty) {
+            return;
+        }
+
+        auto const area = QRect({}, space.base.topology.size);
+        auto get_entry = [](auto const& var_win) {
+            return typename grid_t::entry_t{
+                std::visit(overload{[](auto&& win) { return win::input_geometry(win); }}, var_win),
+                var_win};
+        };
+
+        std::vector<typename grid_t::entry_t> entries;
+        entries.reserve(space.windows.size());
+        for (auto const& win : space.windows) {
+            entries.push_back(get_entry(win));
+        }
+        list.build(area, std::move(entries));
+
+        auto const& order = space.stacking.order.stack;
+        entries = {};
+        entries.reserve(order.size());
+        for (auto it = order.crbegin(); it != order.crend(); ++it) {
+            entries.push_back(get_entry(*it));
+        }
+        stacking.build(area, std::move(entries));
+
+        dirty = false;
+    }
+
+    Space& space;
+    grid_t list;
+    grid_t stacking;
+    bool dirty{true};
+};
+
+template<typename Redirect>
+void window_index_setup(Redirect& redirect)
+{
+    auto& space = redirect.space;
+    auto& index = *redirect.window_index;
+    auto qobject = redirect.qobject.get();
+
+    auto invalidate = [&index] { index.invalidate(); };
+
+    auto connect_window = [&index, qobject](auto const& var_win) {
+        std::visit(overload{[&](auto&& win) {
+                       QObject::connect(win->qobject.get(),
+                                        &win::window_qobject::frame_geometry_changed,
+                                        qobject,
+                                        [&index, var_win] { index.update_geometry(var_win); });
+                   }},
+                   var_win);
+    };
+    auto connect_window_id = [&space, connect_window, invalidate](auto win_id) {
+        connect_window(space.windows_map.at(win_id));
+        invalidate();
+    };
+
+    for (auto const& win : space.windows) {
+        connect_window(win);
+    }
+
+    auto space_qobject = space.qobject.get();
+    for (auto signal : {&win::space_qobject::clientAdded,
+                        &win::space_qobject::wayland_window_added,
+                        &win::space_qobject::unmanagedAdded,
+                        &win::space_qobject::internalClientAdded}) {
+        QObject::connect(space_qobject, signal, qobject, connect_window_id);
+    }
+    for (auto signal : {&win::space_qobject::clientRemoved,
+                        &win::space_qobject::wayland_window_removed,
+                        &win::space_qobject::unmanagedRemoved,
+                        &win::space_qobject::internalClientRemoved,
+                        &win::space_qobject::remnant_created,
+                        &win::space_qobject::window_deleted}) {
+        QObject::connect(space_qobject, signal, qobject, invalidate);
+    }
+
+    QObject::connect(space.stacking.order.qobject.get(),
+                     &win::stacking_order_qobject::changed,
+                     qobject,
+                     invalidate);
+    QObject::connect(space.base.qobject.get(),
+                     &base::platform_qobject::topology_changed,
+                     qobject,
+                     invalidate);
+}
+
+}
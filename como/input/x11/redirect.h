@@ -78,7 +78,22 @@ public:
     std::unique_ptr<pointer_redirect<type>> pointer;
     std::unique_ptr<x11::cursor> cursor;
 
+    /// Adds the @p spy to the back of the list of event spies.
+    void install_spy(event_spy_t* spy)
+    {
+        Q_ASSERT(!contains(m_spies, spy));
+        m_spies.push_back(spy);
+        spy_index.invalidate();
+    }
+
+    void uninstall_spy(event_spy_t* spy)
+    {
+        remove_all(m_spies, spy);
+        spy_index.invalidate();
+    }
+
     std::vector<event_spy_t*> m_spies;
+    event_interest_index<event_spy_t> spy_index;
 
     Space& space;
     std::unique_ptr<xinput_integration<type>> xinput;
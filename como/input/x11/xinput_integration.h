@@ -304,7 +304,7 @@ public:
         filter.key_release = std::make_unique<xinput_key_filter<type>>(XCB_KEY_RELEASE, *this);
 
         // install the input event spies also relevant for X11 platform
-        redirect.m_spies.push_back(new input::modifier_only_shortcuts_spy(redirect));
+        redirect.install_spy(new input::modifier_only_shortcuts_spy(redirect));
     }
 
     xinput_devices<typename Redirect::platform_t> fake_devices;
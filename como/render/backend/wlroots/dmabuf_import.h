@@ -0,0 +1,196 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "wlr_includes.h"
+
+#include <QSize>
+#include <Wrapland/Server/linux_dmabuf_v1.h>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sys/stat.h>
+#include <unordered_map>
+
+namespace como::render::backend::wlroots
+{
+
+struct dmabuf_import_plane {
+    dev_t device{0};
+    ino_t inode{0};
+    uint32_t offset{0};
+    uint32_t stride{0};
+
+    bool operator==(dmabuf_import_plane const& other) const = default;
+};
+
+/**
+ * Identifies the memory behind a dmabuf independent of the file descriptors and the wl_buffer the
+ * client used to send it to us. Imports are not shared between clients.
+ */
+struct dmabuf_import_key {
+    void const* client{nullptr};
+    std::array<dmabuf_import_plane, WLR_DMABUF_MAX_PLANES> planes{};
+    size_t planes_count{0};
+    uint64_t modifier{0};
+    uint32_t format{0};
+    QSize size;
+
+    bool operator==(dmabuf_import_key const& other) const = default;
+};
+
+struct dmabuf_import_key_hash {
+    size_t operator()(dmabuf_import_key const& key) const noexcept
+    {
+        auto hash = std::hash<void const*>{}(key.client);
+        auto combine = [&hash](size_t value) {
+            hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        };
+
+        for (size_t i = 0; i < key.planes_count; i++) {
+            auto const& plane = key.planes.at(i);
+            combine(std::hash<dev_t>{}(plane.device));
+            combine(std::hash<ino_t>{}(plane.inode));
+            combine(std::hash<uint32_t>{}(plane.offset));
+            combine(std::hash<uint32_t>{}(plane.stride));
+        }
+        combine(std::hash<uint64_t>{}(key.modifier));
+        combine(std::hash<uint32_t>{}(key.format));
+        return hash;
+    }
+};
+
+/**
+ * Texture imported from a dmabuf. It is shared by all client buffers referring to the same dmabuf
+ * memory and lives as long as the last of these buffers.
+ */
+struct dmabuf_import {
+    dmabuf_import() = default;
+    dmabuf_import(dmabuf_import const&) = delete;
+    dmabuf_import& operator=(dmabuf_import const&) = delete;
+
+    ~dmabuf_import()
+    {
+        wlr_texture_destroy(native);
+    }
+
+    wlr_texture* native{nullptr};
+};
+
+template<typename Dmabuf>
+bool get_dmabuf_import_key(Dmabuf const& dmabuf, void const* client, dmabuf_import_key& key)
+{
+    if (dmabuf.planes.empty() || dmabuf.planes.size() > key.planes.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < dmabuf.planes.size(); i++) {
+        auto const& plane = dmabuf.planes.at(i);
+
+        struct stat stat_buf;
+        if (fstat(plane.fd, &stat_buf) != 0) {
+            return false;
+        }
+
+        key.planes.at(i) = {stat_buf.st_dev, stat_buf.st_ino, plane.offset, plane.stride};
+    }
+
+    key.client = client;
+    key.planes_count = dmabuf.planes.size();
+    key.modifier = dmabuf.modifier;
+    key.format = dmabuf.format;
+    key.size = dmabuf.size;
+    return true;
+}
+
+/**
+ * Looks up texture imports by the identity of the dmabuf memory per client. Clients cycling
+ * through a swapchain get each of its images imported exactly once.
+ */
+class dmabuf_import_cache
+{
+public:
+    dmabuf_import_cache() = default;
+    dmabuf_import_cache(dmabuf_import_cache const&) = delete;
+    dmabuf_import_cache& operator=(dmabuf_import_cache const&) = delete;
+
+    ~dmabuf_import_cache()
+    {
+        clear();
+    }
+
+    template<typename Dmabuf>
+    std::shared_ptr<dmabuf_import> get(Dmabuf const& dmabuf, void const* client)
+    {
+        dmabuf_import_key key;
+        if (!client || !get_dmabuf_import_key(dmabuf, client, key)) {
+            // Can not identify the memory. Use an import exclusive to this buffer.
+            return std::make_shared<dmabuf_import>();
+        }
+
+        std::erase_if(imports, [](auto const& entry) { return entry.second.expired(); });
+
+        if (auto it = imports.find(key); it != imports.end()) {
+            return it->second.lock();
+        }
+
+        auto tex_import = std::make_shared<dmabuf_import>();
+        imports.insert({key, tex_import});
+        return tex_import;
+    }
+
+    /// Releases all textures. Must be called while the renderer is still alive.
+    void clear()
+    {
+        for (auto& [key, entry] : imports) {
+            if (auto tex_import = entry.lock()) {
+                wlr_texture_destroy(tex_import->native);
+                tex_import->native = nullptr;
+            }
+        }
+        imports.clear();
+    }
+
+private:
+    std::unordered_map<dmabuf_import_key, std::weak_ptr<dmabuf_import>, dmabuf_import_key_hash>
+        imports;
+};
+
+/**
+ * Client dmabuf buffer carrying its shared texture import. Created by the linux-dmabuf global of
+ * the EGL backend for every buffer a client creates. The import is looked up on first use, when
+ * the client of the buffer is known.
+ */
+class dmabuf_buffer : public Wrapland::Server::linux_dmabuf_buffer_v1
+{
+public:
+    template<typename Planes, typename Flags>
+    dmabuf_buffer(Planes const& planes,
+                  uint32_t format,
+                  uint64_t modifier,
+                  QSize const& size,
+                  Flags flags,
+                  dmabuf_import_cache& cache)
+        : Wrapland::Server::linux_dmabuf_buffer_v1(planes, format, modifier, size, flags)
+        , cache{cache}
+    {
+    }
+
+    std::shared_ptr<dmabuf_import> get_texture_import(void const* client)
+    {
+        if (!texture_import) {
+            texture_import = cache.get(*this, client);
+        }
+        return texture_import;
+    }
+
+private:
+    dmabuf_import_cache& cache;
+    std::shared_ptr<dmabuf_import> texture_import;
+};
+
+}
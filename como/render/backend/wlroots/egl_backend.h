@@ -7,6 +7,7 @@
 
 #include <config-como.h>
 
+#include "dmabuf_import.h"
 #include "egl_helpers.h"
 #include "egl_output.h"
 #include "egl_texture.h"
@@ -76,9 +77,10 @@ public:
 
             dmabuf = std::make_unique<Wrapland::Server::linux_dmabuf_v1>(
                 backend.frontend->base.server->display.get(),
-                [](auto const& planes, auto format, auto modifier, auto const& size, auto flags) {
-                    return std::make_unique<Wrapland::Server::linux_dmabuf_buffer_v1>(
-                        planes, format, modifier, size, flags);
+                [this](auto const& planes, auto format, auto modifier, auto const& size, auto flags)
+                    -> std::unique_ptr<Wrapland::Server::linux_dmabuf_buffer_v1> {
+                    return std::make_unique<dmabuf_buffer>(
+                        planes, format, modifier, size, flags, dmabuf_imports);
                 });
             dmabuf->set_formats(formats_map);
         }
@@ -292,6 +294,7 @@ public:
     Backend& backend;
 
     std::unique_ptr<Wrapland::Server::linux_dmabuf_v1> dmabuf;
+    dmabuf_import_cache dmabuf_imports;
     wayland::egl_data data;
 
     std::stack<framebuffer*> render_targets;
@@ -301,6 +304,7 @@ public:
 private:
     void cleanup()
     {
+        dmabuf_imports.clear();
         cleanupGL();
         doneCurrent();
         cleanupSurfaces();
@@ -315,25 +319,6 @@ private:
         }
     }
 
-    template<typename Output>
-    void set_output_damage(Output* output, QRegion const& src_damage) const
-    {
-        auto damage = create_pixman_region(src_damage);
-
-        int width, height;
-        wlr_output_transformed_resolution(output->native, &width, &height);
-
-        enum wl_output_transform transform = wlr_output_transform_invert(output->native->transform);
-        wlr_region_transform(&damage, &damage, transform, width, height);
-
-#if WLR_HAVE_NEW_PIXEL_COPY_API
-        wlr_output_state_set_damage(output->next_state->get_native(), &damage);
-#else
-        wlr_output_set_damage(output->native, &damage);
-#endif
-        pixman_region32_fini(&damage);
-    }
-
 #if WLR_HAVE_NEW_PIXEL_COPY_API
     wlr_render_pass* current_render_pass{nullptr};
 #endif
@@ -5,6 +5,7 @@
 */
 #pragma once
 
+#include "dmabuf_import.h"
 #include "texture_update.h"
 #include "wlr_includes.h"
 
@@ -34,6 +35,10 @@ public:
         if (m_image != EGL_NO_IMAGE_KHR) {
             eglDestroyImageKHR(m_backend->data.base.display, m_image);
         }
+        if (dmabuf_texture) {
+            // The GL texture is owned by the import and possibly still in use by other textures.
+            this->m_texture = 0;
+        }
         wlr_texture_destroy(native);
     }
 
@@ -49,6 +54,7 @@ public:
 
     gl::texture<typename Backend::abstract_type>* q;
     wlr_texture* native{nullptr};
+    std::shared_ptr<dmabuf_import> dmabuf_texture;
     EGLImageKHR m_image{EGL_NO_IMAGE_KHR};
     bool m_hasSubImageUnpack{false};
 
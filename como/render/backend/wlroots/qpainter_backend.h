@@ -42,9 +42,9 @@ public:
         tear_down();
     }
 
-    void begin_render(base_output_t& output) override
+    QImage* begin_render(base_output_t& output) override
     {
-        get_qpainter_output(output)->begin_render();
+        return get_qpainter_output(output)->begin_render();
     }
 
     void present(base_output_t* output, QRegion const& damage) override
@@ -55,9 +55,14 @@ public:
         get_qpainter_output(*output)->present(damage);
     }
 
-    QImage* bufferForScreen(base_output_t* output) override
+    QImage bufferForScreen(base_output_t* output) override
     {
-        return get_qpainter_output(*output)->buffer.get();
+        return get_qpainter_output(*output)->copy_buffer();
+    }
+
+    QRegion get_output_render_region(base_output_t* output) const override
+    {
+        return get_qpainter_output(*output)->get_repair_region();
     }
 
     bool needsFullRepaint() const override
@@ -5,11 +5,15 @@
 */
 #pragma once
 
+#include "wlr_helpers.h"
 #include "wlr_includes.h"
 
 #include <como/base/logging.h>
 
 #include <QImage>
+#include <QRectF>
+#include <QRegion>
+#include <deque>
 #include <memory>
 
 struct wlr_renderer;
@@ -32,54 +36,82 @@ public:
     qpainter_output(qpainter_output&& other) noexcept = default;
     qpainter_output& operator=(qpainter_output&& other) noexcept = default;
 
-    void begin_render()
+    QImage* begin_render()
     {
         auto& output_base_impl = static_cast<typename Output::base_t&>(output.base);
         auto native_out = output_base_impl.native;
-        auto const size = output.base.geometry().size();
 
 #if WLR_HAVE_NEW_PIXEL_COPY_API
         output_base_impl.ensure_next_state();
 
         assert(!current_render_pass);
         current_render_pass = wlr_output_begin_render_pass(
-            native_out, output_base_impl.next_state->get_native(), nullptr, nullptr);
+            native_out, output_base_impl.next_state->get_native(), &buffer_age, nullptr);
 #else
-        wlr_output_attach_render(native_out, nullptr);
-        wlr_renderer_begin(renderer, size.width(), size.height());
+        wlr_output_attach_render(native_out, &buffer_age);
+        wlr_renderer_begin(renderer, native_out->width, native_out->height);
 #endif
 
-        if (!buffer || size != buffer->size()) {
-#if WLR_HAVE_NEW_PIXEL_COPY_API
-            auto img = wlr_pixman_renderer_get_buffer_image(
-                renderer, output_base_impl.next_state->get_native()->buffer);
-#else
-            auto img = wlr_pixman_renderer_get_current_image(renderer);
-#endif
-            auto pixman_format = pixman_image_get_format(img);
-            buffer = std::make_unique<QImage>(size, pixman_to_qt_image_format(pixman_format));
-            if (buffer->isNull()) {
-                // TODO(romangg): handle oom
-                buffer.reset();
-                return;
-            }
-            buffer->fill(Qt::gray);
+        // Paint directly into the pixman image of the output buffer we render to now.
+        auto img = get_pixman_image();
+        auto const img_size = QSize(pixman_image_get_width(img), pixman_image_get_height(img));
+        auto const transform = get_transform(output_base_impl);
+
+        if (img_size != history_size || transform != history_transform) {
+            // Content of the pixman buffers and our damage history are no longer related.
+            damage_history.clear();
+            buffer_age = 0;
+            history_size = img_size;
+            history_transform = transform;
         }
+
+        buffer = std::make_unique<QImage>(reinterpret_cast<uchar*>(pixman_image_get_data(img)),
+                                          img_size.width(),
+                                          img_size.height(),
+                                          pixman_image_get_stride(img),
+                                          pixman_to_qt_image_format(pixman_image_get_format(img)));
+        if (buffer->isNull()) {
+            buffer.reset();
+        }
+        return buffer.get();
     }
 
-    void present(QRegion const& /*damage*/)
+    /// Region in global coordinates that must be repainted to bring the current buffer up to date.
+    QRegion get_repair_region() const
+    {
+        auto const geo = output.base.geometry();
+
+        if (buffer_age <= 0 || buffer_age > static_cast<int>(damage_history.size()) + 1) {
+            // Either the buffer content is undefined or older than our damage history.
+            return geo;
+        }
+
+        QRegion region;
+        for (int i = 0; i < buffer_age - 1; i++) {
+            region |= damage_history[i];
+        }
+        return map_from_device(region).intersected(geo);
+    }
+
+    /// Copy of the last rendered content so no reference to the swapchain memory is handed out.
+    QImage copy_buffer() const
+    {
+        return buffer ? buffer->copy() : QImage();
+    }
+
+    void present(QRegion const& damage)
     {
         auto& base = static_cast<typename Output::base_t&>(output.base);
-        auto buffer_bits = buffer->constBits();
 
-#if WLR_HAVE_NEW_PIXEL_COPY_API
-        auto pixman_data = pixman_image_get_data(
-            wlr_pixman_renderer_get_buffer_image(renderer, base.next_state->get_native()->buffer));
-#else
-        auto pixman_data = pixman_image_get_data(wlr_pixman_renderer_get_current_image(renderer));
-#endif
+        auto const geo = output.base.geometry();
+        auto const output_damage = damage.intersected(geo);
 
-        memcpy(pixman_data, buffer_bits, buffer->width() * buffer->height() * 4);
+        damage_history.push_front(map_to_device(output_damage));
+        if (damage_history.size() > max_damage_history) {
+            damage_history.pop_back();
+        }
+
+        set_output_damage(&base, output_damage.translated(-geo.topLeft()));
 
 #if WLR_HAVE_NEW_PIXEL_COPY_API
         assert(current_render_pass);
@@ -121,9 +153,53 @@ public:
     Output& output;
     wlr_renderer* renderer;
 
-    std::unique_ptr<QImage> buffer;
-
 private:
+    /// Maps a region in global coordinates to pixels of the output buffer as the scene paints it.
+    QRegion map_to_device(QRegion const& region) const
+    {
+        auto const geo = output.base.geometry();
+        auto const scale_x = history_size.width() / static_cast<double>(geo.width());
+        auto const scale_y = history_size.height() / static_cast<double>(geo.height());
+
+        QRegion device;
+        for (auto const& rect : region) {
+            device |= QRectF((rect.x() - geo.x()) * scale_x,
+                             (rect.y() - geo.y()) * scale_y,
+                             rect.width() * scale_x,
+                             rect.height() * scale_y)
+                          .toAlignedRect();
+        }
+        return device;
+    }
+
+    QRegion map_from_device(QRegion const& device) const
+    {
+        auto const geo = output.base.geometry();
+        auto const scale_x = geo.width() / static_cast<double>(history_size.width());
+        auto const scale_y = geo.height() / static_cast<double>(history_size.height());
+
+        QRegion region;
+        for (auto const& rect : device) {
+            region |= QRectF(rect.x() * scale_x + geo.x(),
+                             rect.y() * scale_y + geo.y(),
+                             rect.width() * scale_x,
+                             rect.height() * scale_y)
+                          .toAlignedRect();
+        }
+        return region;
+    }
+
+    pixman_image_t* get_pixman_image() const
+    {
+#if WLR_HAVE_NEW_PIXEL_COPY_API
+        auto& base = static_cast<typename Output::base_t&>(output.base);
+        return wlr_pixman_renderer_get_buffer_image(renderer,
+                                                    base.next_state->get_native()->buffer);
+#else
+        return wlr_pixman_renderer_get_current_image(renderer);
+#endif
+    }
+
     QImage::Format pixman_to_qt_image_format(pixman_format_code_t format)
     {
         switch (format) {
@@ -144,6 +220,17 @@ private:
         }
     }
 
+    static constexpr size_t max_damage_history{4};
+
+    int buffer_age{0};
+
+    // In pixels of buffers with the size and transform below.
+    std::deque<QRegion> damage_history;
+    QSize history_size;
+    base::wayland::output_transform history_transform{base::wayland::output_transform::normal};
+
+    std::unique_ptr<QImage> buffer;
+
 #if WLR_HAVE_NEW_PIXEL_COPY_API
     wlr_render_pass* current_render_pass{nullptr};
 #endif
@@ -5,6 +5,7 @@
 */
 #pragma once
 
+#include "dmabuf_import.h"
 #include "platform.h"
 #include "wlr_helpers.h"
 #include "wlr_includes.h"
@@ -155,6 +156,8 @@ bool update_texture_from_internal_image_object(Texture& texture, WinBuffer const
 template<typename Texture>
 bool update_texture_from_egl(Texture& texture, Wrapland::Server::Buffer* buffer)
 {
+    release_dmabuf_texture(texture);
+
     if (!texture.m_texture) {
         if (!texture.m_backend->data.query_wl_buffer) {
             return false;
@@ -180,40 +183,69 @@ bool update_texture_from_egl(Texture& texture, Wrapland::Server::Buffer* buffer)
     return true;
 }
 
+template<typename Texture>
+void release_dmabuf_texture(Texture& texture)
+{
+    if (!texture.dmabuf_texture) {
+        return;
+    }
+
+    // The GL texture is owned by the import. Make sure we neither reuse nor delete it.
+    texture.m_texture = 0;
+    texture.dmabuf_texture.reset();
+}
+
+template<typename Dmabuf>
+wlr_texture* import_dmabuf_texture(wlr_renderer* renderer, Dmabuf const& dmabuf)
+{
+    wlr_dmabuf_attributes dmabuf_attribs;
+    auto const& planes = dmabuf.planes;
+    dmabuf_attribs.width = dmabuf.size.width();
+    dmabuf_attribs.height = dmabuf.size.height();
+    dmabuf_attribs.format = dmabuf.format;
+    dmabuf_attribs.modifier = dmabuf.modifier;
+    dmabuf_attribs.n_planes = planes.size();
+
+    auto planes_count = std::min(planes.size(), static_cast<size_t>(WLR_DMABUF_MAX_PLANES));
+    for (size_t i = 0; i < planes_count; i++) {
+        auto plane = planes.at(i);
+        dmabuf_attribs.offset[i] = plane.offset;
+        dmabuf_attribs.stride[i] = plane.stride;
+        dmabuf_attribs.fd[i] = plane.fd;
+    }
+
+    return wlr_texture_from_dmabuf(renderer, &dmabuf_attribs);
+}
+
 template<typename Texture, typename Dmabuf>
-bool update_texture_from_dmabuf(Texture& texture, Dmabuf* dmabuf)
+bool update_texture_from_dmabuf(Texture& texture, Dmabuf* dmabuf, void const* client)
 {
     assert(dmabuf);
     assert(texture.m_image == EGL_NO_IMAGE_KHR);
 
-    if (texture.m_size != dmabuf->size) {
-        // First time update or size has changed.
-        // TODO(romangg): Should we also recreate the texture on other param changes?
-        wlr_dmabuf_attributes dmabuf_attribs;
-        auto const& planes = dmabuf->planes;
-        dmabuf_attribs.width = dmabuf->size.width();
-        dmabuf_attribs.height = dmabuf->size.height();
-        dmabuf_attribs.format = dmabuf->format;
-        dmabuf_attribs.modifier = dmabuf->modifier;
-        dmabuf_attribs.n_planes = planes.size();
-
-        auto planes_count = std::min(planes.size(), static_cast<size_t>(WLR_DMABUF_MAX_PLANES));
-        for (size_t i = 0; i < planes_count; i++) {
-            auto plane = planes.at(i);
-            dmabuf_attribs.offset[i] = plane.offset;
-            dmabuf_attribs.stride[i] = plane.stride;
-            dmabuf_attribs.fd[i] = plane.fd;
-        }
+    std::shared_ptr<dmabuf_import> tex_import;
+    if (auto buffer = dynamic_cast<dmabuf_buffer*>(dmabuf)) {
+        tex_import = buffer->get_texture_import(client);
+    } else {
+        // Not created by the linux-dmabuf global of our EGL backend. Import it for this commit.
+        tex_import = std::make_shared<dmabuf_import>();
+    }
 
-        wlr_texture_destroy(texture.native);
-        texture.native
-            = wlr_texture_from_dmabuf(texture.m_backend->backend.renderer, &dmabuf_attribs);
-        if (!texture.native) {
+    if (!tex_import->native) {
+        // First commit of this dmabuf memory. Every later commit only rebinds the import.
+        tex_import->native = import_dmabuf_texture(texture.m_backend->backend.renderer, *dmabuf);
+        if (!tex_import->native) {
             return false;
         }
+    }
+
+    if (texture.dmabuf_texture != tex_import) {
+        wlr_texture_destroy(texture.native);
+        texture.native = nullptr;
+        texture.dmabuf_texture = tex_import;
 
         wlr_gles2_texture_attribs tex_attribs;
-        wlr_gles2_texture_get_attribs(texture.native, &tex_attribs);
+        wlr_gles2_texture_get_attribs(tex_import->native, &tex_attribs);
 
         texture.m_texture = tex_attribs.tex;
         texture.q->setWrapMode(GL_CLAMP_TO_EDGE);
@@ -222,8 +254,6 @@ bool update_texture_from_dmabuf(Texture& texture, Dmabuf* dmabuf)
         texture.updateMatrix();
     }
 
-    assert(texture.native);
-
     // The origin in a dmabuf-buffer is at the upper-left corner, so the meaning
     // of Y-inverted is the inverse of OpenGL.
     if (dmabuf->flags & Wrapland::Server::linux_dmabuf_flag_v1::y_inverted) {
@@ -244,8 +274,9 @@ bool update_texture_from_data(Texture& texture,
                               int32_t scale,
                               void* data)
 {
-    if (size != texture.m_size) {
-        // First time update or size has changed.
+    if (!texture.native || size != texture.m_size) {
+        // First time update, size has changed or we sampled from a dmabuf before.
+        release_dmabuf_texture(texture);
         wlr_texture_destroy(texture.native);
         texture.native = wlr_texture_from_pixels(
             texture.m_backend->backend.renderer, format, stride, size.width(), size.height(), data);
@@ -309,7 +340,8 @@ bool update_texture_from_external(Texture& texture, WinBuffer const& buffer)
     assert(extbuf);
 
     if (auto dmabuf = extbuf->linuxDmabufBuffer()) {
-        ret = update_texture_from_dmabuf(texture, dmabuf);
+        auto surface = extbuf->surface();
+        ret = update_texture_from_dmabuf(texture, dmabuf, surface ? surface->client() : nullptr);
     } else if (auto shm = extbuf->shmBuffer()) {
         ret = update_texture_from_shm(texture, buffer);
     } else {
@@ -10,6 +10,9 @@
 #include "wlr_includes.h"
 #include <como/base/wayland/output_transform.h>
 
+#include <QRegion>
+#include <vector>
+
 namespace como::render::backend::wlroots
 {
 
@@ -94,6 +97,26 @@ pixman_region32_t create_pixman_region(Region const& src_region)
     return create_scaled_pixman_region(src_region, 1);
 }
 
+/// Sets the damage of the next commit. The damage is in output-local logical coordinates.
+template<typename Output>
+void set_output_damage(Output* output, QRegion const& src_damage)
+{
+    auto damage = create_pixman_region(src_damage);
+
+    int width, height;
+    wlr_output_transformed_resolution(output->native, &width, &height);
+
+    enum wl_output_transform transform = wlr_output_transform_invert(output->native->transform);
+    wlr_region_transform(&damage, &damage, transform, width, height);
+
+#if WLR_HAVE_NEW_PIXEL_COPY_API
+    wlr_output_state_set_damage(output->next_state->get_native(), &damage);
+#else
+    wlr_output_set_damage(output->native, &damage);
+#endif
+    pixman_region32_fini(&damage);
+}
+
 template<typename Format>
 std::vector<Format> get_drm_formats(wlr_drm_format_set const* set)
 {
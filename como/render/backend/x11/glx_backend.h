@@ -117,16 +117,57 @@ public:
         render_targets.pop();
         assert(render_targets.empty());
 
-        output_render_count++;
         accum_render |= renderedRegion;
         accum_damage |= damagedRegion;
+    }
 
-        if (output_render_count != platform.base.outputs.size()) {
-            return;
+    void try_present() override
+    {
+        end_frame();
+        present_buffer();
+    }
+
+    bool makeCurrent() override
+    {
+        if (auto context = QOpenGLContext::currentContext()) {
+            // Workaround to tell Qt that no QOpenGLContext is current
+            context->doneCurrent();
         }
+        const bool current = glXMakeCurrent(data.display, data.window, data.context);
+        return current;
+    }
+
+    void doneCurrent() override
+    {
+        glXMakeCurrent(data.display, None, nullptr);
+    }
+
+    bool hasSwapEvent() const override
+    {
+        return !m_needsCompositeTimerStart;
+    }
 
-        output_render_count = 0;
+    int visualDepth(xcb_visualid_t visual) const
+    {
+        auto it = visual_depth_hash.find(visual);
+        return it == visual_depth_hash.end() ? 0 : it->second;
+    }
+
+    glx_data data;
 
+    Window window{None};
+    std::unique_ptr<typename Platform::overlay_window_t> overlay_window;
+    std::unique_ptr<swap_event_filter<Platform>> swap_filter;
+    std::unordered_map<xcb_visualid_t, fb_config_info*> fb_configs;
+    std::unordered_map<xcb_visualid_t, int> visual_depth_hash;
+
+    Platform& platform;
+
+private:
+    /// Finishes the frame of all outputs painted since the last present. Outputs that were not
+    /// painted keep the content of the front buffer.
+    void end_frame()
+    {
         if (GLPlatform::instance()->driver() == Driver_NVidia && !GLPlatform::instance()->isGLES()
             && !this->supportsBufferAge()) {
             if (auto const space = QRegion(QRect({}, platform.base.topology.size));
@@ -172,48 +213,6 @@ public:
         accum_render = {};
     }
 
-    void try_present() override
-    {
-        present_buffer();
-    }
-
-    bool makeCurrent() override
-    {
-        if (auto context = QOpenGLContext::currentContext()) {
-            // Workaround to tell Qt that no QOpenGLContext is current
-            context->doneCurrent();
-        }
-        const bool current = glXMakeCurrent(data.display, data.window, data.context);
-        return current;
-    }
-
-    void doneCurrent() override
-    {
-        glXMakeCurrent(data.display, None, nullptr);
-    }
-
-    bool hasSwapEvent() const override
-    {
-        return !m_needsCompositeTimerStart;
-    }
-
-    int visualDepth(xcb_visualid_t visual) const
-    {
-        auto it = visual_depth_hash.find(visual);
-        return it == visual_depth_hash.end() ? 0 : it->second;
-    }
-
-    glx_data data;
-
-    Window window{None};
-    std::unique_ptr<typename Platform::overlay_window_t> overlay_window;
-    std::unique_ptr<swap_event_filter<Platform>> swap_filter;
-    std::unordered_map<xcb_visualid_t, fb_config_info*> fb_configs;
-    std::unordered_map<xcb_visualid_t, int> visual_depth_hash;
-
-    Platform& platform;
-
-private:
     void present_buffer()
     {
         if (this->lastDamage().isEmpty()) {
@@ -270,7 +269,6 @@ private:
     GLFramebuffer native_fbo;
     int m_bufferAge{0};
     bool m_needsCompositeTimerStart = false;
-    size_t output_render_count{0};
     QRegion accum_render;
     QRegion accum_damage;
 };
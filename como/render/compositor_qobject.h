@@ -35,6 +35,9 @@ Q_SIGNALS:
     void aboutToDestroy();
     void aboutToToggleCompositing();
 
+    /// Emitted when an output starts a frame, before its repaints are collected.
+    void frame_started();
+
 private:
     std::function<bool(QTimerEvent*)> timer_event_handler;
 };
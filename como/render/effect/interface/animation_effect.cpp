@@ -85,6 +85,11 @@ bool AnimationEffect::isActive() const
     return !d->m_animations.isEmpty() && !effects->isScreenLocked();
 }
 
+bool AnimationEffect::blocksDirectScanout() const
+{
+    return true;
+}
+
 #define RELATIVE_XY(_FIELD_)                                                                       \
     const bool relative[2] = {static_cast<bool>(metaData(Relative##_FIELD_##X, meta)),             \
                               static_cast<bool>(metaData(Relative##_FIELD_##Y, meta))}
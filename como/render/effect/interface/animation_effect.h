@@ -299,6 +299,12 @@ public:
 
     bool isActive() const override;
 
+    /**
+     * Animated windows must be painted by the compositor. Blocks showing fullscreen windows without
+     * compositing as long as there are animations.
+     */
+    bool blocksDirectScanout() const override;
+
     /**
      * Gets stored metadata.
      *
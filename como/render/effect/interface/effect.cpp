@@ -80,6 +80,11 @@ bool Effect::isActive() const
     return true;
 }
 
+bool Effect::blocksDirectScanout() const
+{
+    return false;
+}
+
 QString Effect::debug(const QString&) const
 {
     return QString();
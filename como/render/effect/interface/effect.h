@@ -308,6 +308,18 @@ public:
      */
     virtual bool isActive() const;
 
+    /**
+     * Overwrite this method to indicate whether your effect, while active, must paint over
+     * fullscreen windows. As long as an active effect blocks it, fullscreen windows are not shown
+     * without compositing.
+     *
+     * An AnimationEffect blocks it while it animates. Fullscreen effects do not need to block it
+     * since they are set as the active fullscreen effect.
+     *
+     * The default implementation of this method returns @c false.
+     */
+    virtual bool blocksDirectScanout() const;
+
     /**
      * Reimplement this method to provide online debugging.
      * This could be as trivial as printing specific detail information about the effect state
@@ -27,6 +27,7 @@
 #include <QTimer>
 #include <QTouchEvent>
 #include <QWindow>
+#include <utility>
 
 // for QMutableEventPoint
 #include <QtGui/private/qeventpoint_p.h>
@@ -49,6 +50,8 @@ public:
     // if we should capture a QImage after rendering into our BO.
     // Used for either software QtQuick rendering and nonGL kwin rendering
     bool m_useBlit = false;
+    // if the next update should capture a QImage in addition to the texture
+    bool m_imageRequested = false;
     bool m_visible = true;
     bool m_hasAlphaChannel = true;
     bool m_automaticRepaint = true;
@@ -266,13 +269,15 @@ void OffscreenQuickView::update()
         QQuickOpenGLUtils::resetOpenGLState();
     }
 
-    if (d->m_useBlit) {
+    if (d->m_useBlit || std::exchange(d->m_imageRequested, false)) {
         if (usingGl) {
             d->m_image = d->m_fbo->toImage();
             d->m_image.setDevicePixelRatio(d->m_view->devicePixelRatio());
         } else {
             d->m_image = d->m_view->grabWindow();
         }
+    } else {
+        d->m_image = {};
     }
 
     if (usingGl) {
@@ -485,6 +490,11 @@ QImage OffscreenQuickView::bufferAsImage() const
     return d->m_image;
 }
 
+void OffscreenQuickView::requestImage()
+{
+    d->m_imageRequested = true;
+}
+
 QSize OffscreenQuickView::size() const
 {
     return d->m_view->geometry().size();
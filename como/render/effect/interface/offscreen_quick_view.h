@@ -37,7 +37,7 @@ class COMO_EXPORT OffscreenQuickView : public QObject
 public:
     enum class ExportMode {
         /** The contents will be available as a texture in the shared contexts. Image will be
-           blank*/
+           blank unless requested*/
         Texture,
         /** The contents will be blit during the update into a QImage buffer. */
         Image
@@ -106,6 +106,12 @@ public:
      */
     QImage bufferAsImage() const;
 
+    /**
+     * Blits the output of the next update into the image buffer, also when exporting as texture.
+     * The image is only available until the update after that.
+     */
+    void requestImage();
+
     /**
      * Inject any mouse event into the QQuickWindow.
      * Local co-ordinates are transformed
@@ -23,6 +23,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <como/render/gl/interface/platform.h>
 
 #include <KDecoration2/DecorationSettings>
+#include <algorithm>
 
 namespace como::render
 {
@@ -187,6 +188,13 @@ bool effects_handler_wrap::hasActiveFullScreenEffect() const
     return fullscreen_effect;
 }
 
+bool effects_handler_wrap::blocksDirectScanout() const
+{
+    return std::any_of(loaded_effects.cbegin(), loaded_effects.cend(), [](auto const& effect) {
+        return effect.second->isActive() && effect.second->blocksDirectScanout();
+    });
+}
+
 bool effects_handler_wrap::grabKeyboard(Effect* effect)
 {
     if (keyboard_grab_effect != nullptr)
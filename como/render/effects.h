@@ -117,6 +117,9 @@ public:
     Effect* activeFullScreenEffect() const override;
     bool hasActiveFullScreenEffect() const override;
 
+    /// Whether an active effect prevents showing fullscreen windows without compositing.
+    bool blocksDirectScanout() const;
+
     double animationTimeFactor() const override;
     WindowQuadType newWindowQuadType() override;
 
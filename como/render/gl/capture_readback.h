@@ -0,0 +1,209 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/render/gl/interface/platform.h>
+#include <como/render/gl/interface/utils.h>
+
+#include <QRegion>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <epoxy/gl.h>
+
+namespace como::render::gl
+{
+
+/**
+ * Reads back painted frames of an output for its capture streams without stalling the pipeline.
+ *
+ * Pixel pack buffers in a small ring mirror the output's framebuffer content. After painting only
+ * the damaged parts and the parts a buffer missed while the others were used are read into a free
+ * buffer, followed by a fence. Buffers are mapped only once their fence signalled, in the order
+ * they were read.
+ */
+class capture_readback
+{
+public:
+    capture_readback() = default;
+    capture_readback(capture_readback const&) = delete;
+    capture_readback& operator=(capture_readback const&) = delete;
+
+    /// Must be destroyed with the context current.
+    ~capture_readback()
+    {
+        clear();
+    }
+
+    static bool is_supported()
+    {
+        if (GLPlatform::instance()->isGLES()) {
+            return hasGLVersion(3, 0);
+        }
+        return hasGLVersion(3, 2) || hasGLExtension(QByteArrayLiteral("GL_ARB_sync"));
+    }
+
+    /**
+     * Starts reading @p rect of the current framebuffer with @p damage in buffer coordinates.
+     * When all buffers are still in flight the frame is skipped and its damage carried over.
+     */
+    void read(QRect const& rect, bool y_inverted, QRegion const& damage)
+    {
+        if (rect.size() != size || y_inverted != this->y_inverted) {
+            clear();
+            size = rect.size();
+            this->y_inverted = y_inverted;
+            for (auto& slot : slots) {
+                slot.stale = QRect({}, size);
+            }
+            pending_damage = QRect({}, size);
+        }
+
+        auto const frame_damage = damage.intersected(QRect({}, size));
+        for (auto& slot : slots) {
+            slot.stale |= frame_damage;
+        }
+        pending_damage |= frame_damage;
+
+        if (pending_damage.isEmpty()) {
+            return;
+        }
+
+        auto slot_it = std::find_if(
+            slots.begin(), slots.end(), [](auto const& slot) { return !slot.fence; });
+        if (slot_it == slots.end()) {
+            // The GPU is behind. The next frame reads our damage as well.
+            return;
+        }
+
+        auto& slot = *slot_it;
+        auto const stride = size.width() * 4;
+
+        if (!slot.buffer) {
+            glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER,
+                         static_cast<GLsizeiptr>(stride) * size.height(),
+                         nullptr,
+                         GL_STREAM_READ);
+        } else {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        }
+
+        // With a pack buffer bound the pointer argument is an offset into the buffer.
+        glPixelStorei(GL_PACK_ROW_LENGTH, size.width());
+        for (auto const& stale_rect : slot.stale) {
+            auto const offset = static_cast<intptr_t>(stale_rect.y()) * stride + stale_rect.x() * 4;
+            glReadPixels(rect.x() + stale_rect.x(),
+                         rect.y() + stale_rect.y(),
+                         stale_rect.width(),
+                         stale_rect.height(),
+                         GL_RGBA,
+                         GL_UNSIGNED_BYTE,
+                         reinterpret_cast<void*>(offset));
+        }
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.stale = {};
+        slot.damage = pending_damage;
+        pending_damage = {};
+
+        in_flight.push_back(&slot);
+    }
+
+    /**
+     * Hands finished frames in order to @p submit, which is called with the frame size, whether
+     * its rows are y-inverted, its damage and a function to copy from it. Returns whether frames
+     * are still in flight.
+     */
+    template<typename Submit>
+    bool process(Submit&& submit)
+    {
+        while (!in_flight.empty()) {
+            auto& slot = *in_flight.front();
+
+            auto const status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                break;
+            }
+
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+            in_flight.pop_front();
+
+            auto const stride = size.width() * 4;
+            uchar const* data{nullptr};
+
+            if (status != GL_WAIT_FAILED) {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+                auto const buffer_size = static_cast<GLsizeiptr>(stride) * size.height();
+                data = static_cast<uchar const*>(
+                    glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, buffer_size, GL_MAP_READ_BIT));
+            }
+
+            if (!data) {
+                // Read everything again next time and report the damage with the next frame.
+                slot.stale = QRect({}, size);
+                pending_damage |= slot.damage;
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                continue;
+            }
+
+            auto copy = [&](QRect const& rect, uchar* dst, int dst_stride) {
+                for (int row = 0; row < rect.height(); row++) {
+                    std::memcpy(dst + row * dst_stride,
+                                data + (rect.y() + row) * stride + rect.x() * 4,
+                                rect.width() * 4);
+                }
+            };
+            submit(size, y_inverted, slot.damage, copy);
+
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        return !in_flight.empty();
+    }
+
+private:
+    struct slot_t {
+        GLuint buffer{0};
+        GLsync fence{nullptr};
+
+        // Parts where the buffer content is older than the last painted frame.
+        QRegion stale;
+
+        // Damage reported with the frame in flight.
+        QRegion damage;
+    };
+
+    void clear()
+    {
+        for (auto& slot : slots) {
+            if (slot.fence) {
+                glDeleteSync(slot.fence);
+            }
+            if (slot.buffer) {
+                glDeleteBuffers(1, &slot.buffer);
+            }
+            slot = {};
+        }
+        in_flight.clear();
+    }
+
+    QSize size;
+    bool y_inverted{false};
+
+    std::array<slot_t, 3> slots;
+    std::deque<slot_t*> in_flight;
+    QRegion pending_damage;
+};
+
+}
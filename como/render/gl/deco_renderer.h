@@ -12,8 +12,16 @@
 // Must be included before.
 #include <epoxy/gl.h>
 
+#include <como/render/gl/interface/decoration_texture.h>
+#include <como/render/gl/interface/framebuffer.h>
+#include <como/render/gl/interface/shader.h>
+#include <como/render/gl/interface/shader_manager.h>
+#include <como/render/gl/interface/texture.h>
 #include <como/render/gl/interface/utils.h>
+#include <como/render/gl/interface/vertex_buffer.h>
 
+#include <QVector>
+#include <array>
 #include <cmath>
 
 namespace como::render::gl
@@ -60,6 +68,10 @@ public:
 
     std::unique_ptr<GLTexture> texture;
 
+    // For copying from decorations that provide their content as a texture.
+    std::unique_ptr<GLFramebuffer> framebuffer;
+    std::unique_ptr<GLVertexBuffer> vbo;
+
 private:
     Scene& scene;
 };
@@ -101,10 +113,16 @@ public:
         // We pad each part in the decoration atlas in order to avoid texture bleeding.
         const int padding = 1;
 
-        auto renderPart = [=, this](const QRect& geo,
-                                    const QRect& partRect,
-                                    const QPoint& position,
-                                    bool rotated = false) {
+        // Decorations rendering on the GPU are copied into the atlas without a roundtrip through
+        // system memory.
+        auto source = qobject_cast<DecorationTextureSource*>(this->window.deco);
+        auto source_texture = source ? source->decorationTexture() : nullptr;
+        QVector<GLVertex2D> copy_vertices;
+
+        auto renderPart = [=, this, &copy_vertices](const QRect& geo,
+                                                    const QRect& partRect,
+                                                    const QPoint& position,
+                                                    bool rotated = false) {
             if (!geo.isValid()) {
                 return;
             }
@@ -128,6 +146,17 @@ public:
                 rect.setBottom(rect.bottom() + padding);
             }
 
+            if (source_texture) {
+                add_copy_vertices(copy_vertices,
+                                  *source_texture,
+                                  source->decorationTextureRect(),
+                                  rect,
+                                  partRect,
+                                  position,
+                                  rotated);
+                return;
+            }
+
             QRect viewport = geo.translated(-rect.x(), -rect.y());
             auto const devicePixelRatio = this->window.scale();
 
@@ -170,6 +199,10 @@ public:
         renderPart(top.intersected(geometry), top, topPosition);
         renderPart(right.intersected(geometry), right, rightPosition, true);
         renderPart(bottom.intersected(geometry), bottom, bottomPosition);
+
+        if (!copy_vertices.isEmpty()) {
+            copy_to_texture(*source_texture, copy_vertices);
+        }
     }
 
     GLTexture* texture()
@@ -187,6 +220,116 @@ private:
         return static_cast<deco_render_data<Scene>&>(*this->data);
     }
 
+    /**
+     * Adds the vertices for copying @p rect of the decoration part @p part_rect from @p source to
+     * the atlas at @p position.
+     */
+    void add_copy_vertices(QVector<GLVertex2D>& vertices,
+                           GLTexture const& source,
+                           QRect const& source_rect,
+                           QRect const& rect,
+                           QRect const& part_rect,
+                           QPoint const& position,
+                           bool rotated)
+    {
+        auto const deco_rect = this->window.deco->rect();
+        if (deco_rect.isEmpty()) {
+            return;
+        }
+
+        auto const scale_x = source_rect.width() / static_cast<double>(deco_rect.width());
+        auto const scale_y = source_rect.height() / static_cast<double>(deco_rect.height());
+        auto const src_rect = QRectF(source_rect.x() + (rect.x() - deco_rect.x()) * scale_x,
+                                     source_rect.y() + (rect.y() - deco_rect.y()) * scale_y,
+                                     rect.width() * scale_x,
+                                     rect.height() * scale_y);
+
+        // The first row of the source texture is its bottom row.
+        auto texcoord = [&source](QPointF const& point) {
+            return QVector2D(point.x() / source.width(), 1. - point.y() / source.height());
+        };
+        auto const src_tl = texcoord(src_rect.topLeft());
+        auto const src_tr = texcoord(src_rect.topRight());
+        auto const src_bl = texcoord(src_rect.bottomLeft());
+        auto const src_br = texcoord(src_rect.bottomRight());
+
+        // Rotated parts are stored transposed in the atlas, see rotate_and_flip.
+        auto const part_offset = rect.topLeft() - part_rect.topLeft();
+        auto const offset = rotated ? QPoint(part_offset.y(), part_offset.x()) : part_offset;
+        auto const size = rotated ? rect.size().transposed() : rect.size();
+        auto const scale = this->window.scale();
+        auto const dst_rect = QRectF(QPointF(position + offset) * scale, QSizeF(size) * scale);
+
+        auto add = [&vertices](QPointF const& position, QVector2D const& texcoord) {
+            vertices.push_back(GLVertex2D{
+                .position = QVector2D(position),
+                .texcoord = texcoord,
+            });
+        };
+
+        auto const dst_tr_tex = rotated ? src_bl : src_tr;
+        auto const dst_bl_tex = rotated ? src_tr : src_bl;
+
+        add(dst_rect.topLeft(), src_tl);
+        add(dst_rect.bottomLeft(), dst_bl_tex);
+        add(dst_rect.bottomRight(), src_br);
+        add(dst_rect.bottomRight(), src_br);
+        add(dst_rect.topRight(), dst_tr_tex);
+        add(dst_rect.topLeft(), src_tl);
+    }
+
+    void copy_to_texture(GLTexture& source, QVector<GLVertex2D> const& vertices)
+    {
+        auto& data = get_data();
+        if (!data.framebuffer) {
+            data.framebuffer = std::make_unique<GLFramebuffer>(data.texture.get());
+        }
+        if (!data.framebuffer->valid()) {
+            return;
+        }
+        if (!data.vbo) {
+            data.vbo = std::make_unique<GLVertexBuffer>(GLVertexBuffer::Stream);
+        }
+
+        // We are called while a window is painted and must leave its state intact.
+        GLint previous_framebuffer;
+        std::array<GLint, 4> viewport;
+        std::array<GLint, 4> scissor;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+        glGetIntegerv(GL_VIEWPORT, viewport.data());
+        glGetIntegerv(GL_SCISSOR_BOX, scissor.data());
+        auto const scissor_enabled = glIsEnabled(GL_SCISSOR_TEST);
+        auto const blend_enabled = glIsEnabled(GL_BLEND);
+
+        data.framebuffer->bind();
+        glDisable(GL_BLEND);
+
+        // The atlas is filled top to bottom like with image uploads.
+        QMatrix4x4 projection;
+        projection.ortho(0, data.texture->width(), 0, data.texture->height(), 0, 65535);
+
+        {
+            ShaderBinder binder(ShaderTrait::MapTexture);
+            binder.shader()->setUniform(GLShader::ModelViewProjectionMatrix, projection);
+
+            source.bind();
+            data.vbo->reset();
+            data.vbo->setVertices(vertices);
+            data.vbo->render(GL_TRIANGLES);
+            source.unbind();
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        glScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
+        if (!scissor_enabled) {
+            glDisable(GL_SCISSOR_TEST);
+        }
+        if (blend_enabled) {
+            glEnable(GL_BLEND);
+        }
+    }
+
     static void clamp_row(int left, int width, int right, const uint32_t* src, uint32_t* dest)
     {
         std::fill_n(dest, left, *src);
@@ -261,10 +404,12 @@ private:
         }
 
         if (size.isEmpty()) {
+            data.framebuffer.reset();
             data.texture.reset();
             return;
         }
 
+        data.framebuffer.reset();
         data.texture = std::make_unique<GLTexture>(GL_RGBA8, size.width(), size.height());
         data.texture->set_content_transform(effect::transform_type::flipped_180);
         data.texture->setWrapMode(GL_CLAMP_TO_EDGE);
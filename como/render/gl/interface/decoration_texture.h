@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+#include <QRect>
+
+namespace como
+{
+
+class GLTexture;
+
+/**
+ * Interface for decorations which render their content on the GPU.
+ *
+ * An OpenGL scene copies the content of such a decoration on the GPU from its texture instead of
+ * painting it with QPainter and uploading the result.
+ */
+class DecorationTextureSource
+{
+public:
+    virtual ~DecorationTextureSource() = default;
+
+    /**
+     * The texture with the current content of the decoration. The first row of the texture is its
+     * bottom row. Returns null when the decoration can only be painted with QPainter.
+     * @note The compositor's OpenGL context must be current.
+     */
+    virtual GLTexture* decorationTexture() = 0;
+
+    /// The area in native pixels of the texture that shows the decoration's rect.
+    virtual QRect decorationTextureRect() const = 0;
+};
+
+}
+
+Q_DECLARE_INTERFACE(como::DecorationTextureSource, "org.kde.como.DecorationTextureSource")
@@ -8,6 +8,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "backend.h"
 #include "buffer.h"
+#include "capture_readback.h"
 #include "deco_renderer.h"
 #include "lanczos_filter.h"
 #include "window.h"
@@ -22,6 +23,8 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <como/render/gl/interface/utils.h>
 
 #include <KNotification>
+#include <QTimer>
+#include <map>
 #include <memory>
 #include <unistd.h>
 #include <unordered_map>
@@ -80,6 +83,20 @@ public:
             glBindVertexArray(vao);
         }
 
+        // Reading back synchronously would stall every frame until the GPU is done. Without sync
+        // objects and pixel buffer objects capture streams do not receive frames.
+        capture_supported = capture_readback::is_supported();
+        if (!capture_supported) {
+            qCDebug(KWIN_CORE) << "Output capture not supported by the OpenGL driver";
+        }
+
+        // Polls readbacks while no frames are painted.
+        capture_timer.setInterval(4);
+        QObject::connect(&capture_timer, &QTimer::timeout, this, [this] {
+            makeOpenGLContextCurrent();
+            process_capture_readbacks();
+        });
+
         qCDebug(KWIN_CORE) << "OpenGL 2 compositing successfully initialized";
     }
 
@@ -89,6 +106,7 @@ public:
 
         // Need to reset early, otherwise the GL context is gone.
         sw_cursor.texture.reset();
+        capture_readbacks.clear();
 
         if (lanczos) {
             delete lanczos;
@@ -113,6 +131,9 @@ public:
         auto render = m_backend->set_render_target_to_output(*output);
         auto const repaint = m_backend->get_output_render_region(*output);
 
+        // Readbacks of previous frames have likely finished by now.
+        process_capture_readbacks();
+
         GLVertexBuffer::streamingBuffer()->beginFrame();
 
         GLenum const status = glGetGraphicsResetStatus();
@@ -133,6 +154,12 @@ public:
 
         assert(render.targets.size() == 1);
 
+        if constexpr (requires(Platform platform) { platform.capture; }) {
+            if (capture_supported && this->platform.capture->is_capturing(*output)) {
+                capture_output(*output, render, update);
+            }
+        }
+
         GLVertexBuffer::streamingBuffer()->endOfFrame();
         m_backend->endRenderingFrameForScreen(output, valid, update);
 
@@ -511,6 +538,60 @@ protected:
     }
 
 private:
+    /// Starts reading back the damaged parts of the painted frame for the capture streams.
+    void capture_output(output_t const& output,
+                        effect::render_data const& render,
+                        QRegion const& damage)
+    {
+        // The output's area in the framebuffer. Capture buffers contain it in framebuffer row
+        // order, which is top-down when the scene renders with a flipped y-axis.
+        auto const output_rect = effect::map_to_viewport(render, output.geometry());
+
+        QRegion buffer_damage;
+        for (auto const& rect : damage) {
+            buffer_damage |= effect::map_to_viewport(render, rect)
+                                 .intersected(output_rect)
+                                 .translated(-output_rect.topLeft());
+        }
+
+        auto& readback = capture_readbacks[&output];
+        if (!readback) {
+            readback = std::make_unique<capture_readback>();
+        }
+        readback->read(output_rect, !render.flip_y, buffer_damage);
+
+        if (!capture_timer.isActive()) {
+            capture_timer.start();
+        }
+    }
+
+    /// Submits read back frames to the capture streams once the GPU has finished them.
+    void process_capture_readbacks()
+    {
+        if constexpr (requires(Platform platform) { platform.capture; }) {
+            bool pending{false};
+
+            for (auto it = capture_readbacks.begin(); it != capture_readbacks.end();) {
+                auto output = it->first;
+                if (!this->platform.capture->is_capturing(*output)) {
+                    it = capture_readbacks.erase(it);
+                    continue;
+                }
+
+                pending |= it->second->process(
+                    [&](auto const& size, auto y_inverted, auto const& damage, auto const& copy) {
+                        this->platform.capture->submit(
+                            *output, size, QImage::Format_RGBX8888, y_inverted, damage, copy);
+                    });
+                ++it;
+            }
+
+            if (!pending) {
+                capture_timer.stop();
+            }
+        }
+    }
+
     bool viewportLimitsMatched(const QSize& size) const
     {
         if (!this->windowing_integration.handle_viewport_limits_alarm) {
@@ -591,6 +672,10 @@ private:
 
     QMatrix4x4 vp_projection;
     GLuint vao{0};
+
+    bool capture_supported{false};
+    std::map<output_t const*, std::unique_ptr<capture_readback>> capture_readbacks;
+    QTimer capture_timer;
 };
 
 template<typename Platform>
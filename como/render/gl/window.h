@@ -201,6 +201,11 @@ public:
             quad_count += quad_list.size();
         }
 
+        // Leaf nodes are set up before mapping the streaming buffer since the decoration renderer
+        // may draw into its texture.
+        std::vector<LeafNode> nodes;
+        setupLeafNodes(nodes, quads, has_previous_content, data);
+
         GLVertexBuffer* vbo = GLVertexBuffer::streamingBuffer();
         auto map = vbo->map<GLVertex2D>(verticesPerQuad * quad_count);
         if (!map) {
@@ -208,9 +213,6 @@ public:
             return;
         }
 
-        std::vector<LeafNode> nodes;
-        setupLeafNodes(nodes, quads, has_previous_content, data);
-
         for (size_t i = 0, v = 0; i < quads.size(); i++) {
             if (quads[i].isEmpty() || !nodes[i].texture)
                 continue;
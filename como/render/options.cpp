@@ -109,6 +109,15 @@ void options_qobject::setWindowsBlockCompositing(bool value)
     Q_EMIT windowsBlockCompositingChanged();
 }
 
+void options_qobject::setUnredirectFullscreen(bool value)
+{
+    if (m_unredirectFullscreen == value) {
+        return;
+    }
+    m_unredirectFullscreen = value;
+    Q_EMIT unredirectFullscreenChanged();
+}
+
 void options_qobject::setAnimationCurve(render::animation_curve curve)
 {
     if (m_animationCurve == curve) {
@@ -155,6 +164,7 @@ void options::loadConfig()
 void options::syncFromKcfgc()
 {
     qobject->setWindowsBlockCompositing(m_settings->windowsBlockCompositing());
+    qobject->setUnredirectFullscreen(m_settings->unredirectFullscreen());
     qobject->setAnimationCurve(m_settings->animationCurve());
 }
 
@@ -62,6 +62,12 @@ public:
         return m_windowsBlockCompositing;
     }
 
+    /// Whether fullscreen windows are shown without compositing when possible. Only on X11.
+    bool isUnredirectFullscreen() const
+    {
+        return m_unredirectFullscreen;
+    }
+
     render::animation_curve animationCurve() const
     {
         return m_animationCurve;
@@ -77,6 +83,7 @@ public:
     void setGlStrictBinding(bool glStrictBinding);
     void setGlStrictBindingFollowsDriver(bool glStrictBindingFollowsDriver);
     void setWindowsBlockCompositing(bool set);
+    void setUnredirectFullscreen(bool set);
     void setAnimationCurve(render::animation_curve curve);
 
     static bool defaultUseCompositing()
@@ -125,6 +132,7 @@ Q_SIGNALS:
     void glStrictBindingFollowsDriverChanged();
     void hiddenPreviewsChanged();
     void windowsBlockCompositingChanged();
+    void unredirectFullscreenChanged();
     void animationSpeedChanged();
     void animationCurveChanged();
 
@@ -142,6 +150,7 @@ private:
     bool m_glStrictBinding{defaultGlStrictBinding()};
     bool m_glStrictBindingFollowsDriver{defaultGlStrictBindingFollowsDriver()};
     bool m_windowsBlockCompositing{true};
+    bool m_unredirectFullscreen{false};
     render::animation_curve m_animationCurve{render::animation_curve::linear};
 
     friend class options;
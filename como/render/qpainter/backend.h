@@ -5,7 +5,8 @@
 */
 #pragma once
 
-class QImage;
+#include <QImage>
+
 class QRegion;
 
 namespace como::render::qpainter
@@ -19,10 +20,15 @@ public:
 
     virtual ~backend() = default;
 
-    virtual void begin_render(output_t& output) = 0;
+    /// Returns the image to paint into. It is only valid until the next call to present.
+    virtual QImage* begin_render(output_t& output) = 0;
     virtual void present(output_t* output, QRegion const& damage) = 0;
 
-    virtual QImage* bufferForScreen(output_t* output) = 0;
+    /// Copy of the content last rendered to the output.
+    virtual QImage bufferForScreen(output_t* output) = 0;
+
+    /// Region that must be repainted in addition to the damage to bring the buffer up to date.
+    virtual QRegion get_output_render_region(output_t* output) const = 0;
 
     virtual bool needsFullRepaint() const = 0;
 };
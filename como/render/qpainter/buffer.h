@@ -10,6 +10,7 @@
 
 #include <Wrapland/Server/buffer.h>
 #include <Wrapland/Server/surface.h>
+#include <cstring>
 
 namespace como::render::qpainter
 {
@@ -48,9 +49,7 @@ public:
                                return;
                            }
 
-                           // performing deep copy, this could probably be improved
-                           image = win_integrate.external->shmImage()->createQImage().copy();
-                           win->surface->resetTrackedDamage();
+                           update_image(*win->surface, *win_integrate.external);
                        } else {
                            // That's an internal client.
                            image = win_integrate.internal.image;
@@ -89,18 +88,72 @@ public:
                                     image = QImage();
                                     return;
                                 }
-                                if (b == oldBuffer) {
+                                if (b == oldBuffer && win->surface->trackedDamage().isEmpty()) {
                                     return;
                                 }
 
-                                // perform deep copy
-                                image = b->shmImage()->createQImage().copy();
-                                win->surface->resetTrackedDamage();
+                                update_image(*win->surface, *b);
                             }},
                    *this->window->ref_win);
     }
 
     QImage image;
+
+private:
+    /**
+     * Updates our persistent copy of the client's shm buffer. Only the damaged area is copied
+     * as long as the buffer layout stays the same.
+     */
+    void update_image(Wrapland::Server::Surface& surface, Wrapland::Server::Buffer& shm_buffer)
+    {
+        auto const src = shm_buffer.shmImage()->createQImage();
+        auto const damage = get_buffer_damage(surface);
+
+        if (image.isNull() || image.size() != src.size() || image.format() != src.format()
+            || damage.isEmpty()) {
+            // Initial copy or the layout has changed.
+            image = src.copy();
+            surface.resetTrackedDamage();
+            return;
+        }
+
+        auto const stride = src.bytesPerLine();
+        auto const pixel_size = src.depth() / 8;
+        auto dst_bits = image.bits();
+        auto const src_bits = src.constBits();
+        auto const dst_stride = image.bytesPerLine();
+
+        for (auto const& rect : damage.intersected(src.rect())) {
+            auto const x_offset = rect.x() * pixel_size;
+            auto const row_size = rect.width() * pixel_size;
+
+            for (int y = rect.top(); y <= rect.bottom(); y++) {
+                memcpy(dst_bits + y * dst_stride + x_offset,
+                       src_bits + y * stride + x_offset,
+                       row_size);
+            }
+        }
+
+        surface.resetTrackedDamage();
+    }
+
+    /// Returns the damage in buffer coordinates or an empty region if it can not be mapped.
+    QRegion get_buffer_damage(Wrapland::Server::Surface& surface) const
+    {
+        auto const& state = surface.state();
+        if (state.source_rectangle.isValid()) {
+            // Mapping through the viewport is not worth it. Copy everything.
+            return {};
+        }
+
+        auto const scale = state.scale;
+        QRegion damage;
+
+        for (auto const& rect : surface.trackedDamage()) {
+            damage += QRect(rect.topLeft() * scale, rect.size() * scale);
+        }
+        return damage;
+    }
 };
 
 }
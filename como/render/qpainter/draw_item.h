@@ -0,0 +1,49 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QRegion>
+#include <QTransform>
+#include <optional>
+#include <vector>
+
+namespace como::render::qpainter
+{
+
+struct draw_image {
+    QRectF target;
+    QImage image;
+    QRectF source;
+};
+
+/**
+ * Recorded paint operation of a window or the background. Clip and transform are in device
+ * coordinates of the output buffer, so the item can be rasterized on any tile of it.
+ */
+struct draw_item {
+    QRegion clip;
+    QTransform transform;
+    qreal opacity{1.};
+    std::vector<draw_image> images;
+
+    // Instead of drawing images fill the clip with this color.
+    std::optional<QColor> fill;
+
+    // Filter scaled images bilinearly instead of picking the nearest pixel.
+    bool smooth{false};
+};
+
+inline void draw_images(QPainter& painter, std::vector<draw_image> const& images)
+{
+    for (auto const& img : images) {
+        painter.drawImage(img.target, img.image, img.source);
+    }
+}
+
+}
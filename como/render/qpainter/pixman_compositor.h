@@ -0,0 +1,245 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "draw_item.h"
+
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <pixman.h>
+
+namespace como::render::qpainter
+{
+
+struct pixman_image_deleter {
+    void operator()(pixman_image_t* image) const
+    {
+        pixman_image_unref(image);
+    }
+};
+
+using pixman_image_ptr = std::unique_ptr<pixman_image_t, pixman_image_deleter>;
+
+/// Only formats with the same memory layout in Qt and pixman on any endianness are supported.
+inline std::optional<pixman_format_code_t> get_pixman_format(QImage::Format format)
+{
+    switch (format) {
+    case QImage::Format_ARGB32_Premultiplied:
+        return PIXMAN_a8r8g8b8;
+    case QImage::Format_RGB32:
+        return PIXMAN_x8r8g8b8;
+    default:
+        return {};
+    }
+}
+
+/**
+ * Wraps the memory of @p image in @p bounds without copying. The image must outlive the pixman
+ * image.
+ */
+inline pixman_image_ptr create_pixman_image(QImage const& image, QRect const& bounds)
+{
+    auto format = get_pixman_format(image.format());
+    assert(format);
+    assert(image.rect().contains(bounds));
+
+    // Pixman writes only to destination images. Those wrap memory we paint into anyway.
+    auto bits = const_cast<uchar*>(image.constScanLine(bounds.y())) + bounds.x() * 4;
+    return pixman_image_ptr(pixman_image_create_bits(*format,
+                                                     bounds.width(),
+                                                     bounds.height(),
+                                                     reinterpret_cast<uint32_t*>(bits),
+                                                     image.bytesPerLine()));
+}
+
+inline pixman_image_ptr create_pixman_image(QImage const& image)
+{
+    return create_pixman_image(image, image.rect());
+}
+
+inline bool is_pixman_compatible(draw_item const& item)
+{
+    if (item.transform.type() > QTransform::TxScale || item.transform.m11() <= 0
+        || item.transform.m22() <= 0) {
+        return false;
+    }
+
+    for (auto const& img : item.images) {
+        if (!get_pixman_format(img.image.format())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Composites one image onto @p dst. The transform maps device coordinates of the output buffer to
+ * image coordinates, so the composite operation can use the same coordinates for source and
+ * destination. Pure integer translations skip the transform to hit pixman's SIMD fast paths.
+ */
+inline void composite_image_pixman(pixman_image_t* dst,
+                                   draw_image const& img,
+                                   QTransform const& transform,
+                                   bool smooth,
+                                   pixman_image_t* mask,
+                                   QRegion const& clip,
+                                   QPoint const& dst_offset)
+{
+    auto const device_target = transform.mapRect(img.target);
+    auto const region = clip.intersected(device_target.toAlignedRect());
+    auto const src_bounds = img.source.toAlignedRect().intersected(img.image.rect());
+    if (region.isEmpty() || src_bounds.isEmpty()) {
+        return;
+    }
+
+    // Only the source rectangle is wrapped. Filtering at its edges repeats the edge pixels instead
+    // of blending in neighboring content of the image, like other parts of an atlas or buffer.
+    auto src = create_pixman_image(img.image, src_bounds);
+    pixman_image_set_repeat(src.get(), PIXMAN_REPEAT_PAD);
+
+    auto const scale_x = img.source.width() / device_target.width();
+    auto const scale_y = img.source.height() / device_target.height();
+    auto const offset_x = img.source.x() - src_bounds.x() - device_target.x() * scale_x;
+    auto const offset_y = img.source.y() - src_bounds.y() - device_target.y() * scale_y;
+
+    auto const is_integer_translation = qFuzzyCompare(scale_x, 1.)
+        && qFuzzyCompare(scale_y, 1.) && qFuzzyIsNull(offset_x - qRound(offset_x))
+        && qFuzzyIsNull(offset_y - qRound(offset_y));
+
+    auto src_shift = QPoint(0, 0);
+
+    if (is_integer_translation) {
+        src_shift = QPoint(qRound(offset_x), qRound(offset_y));
+    } else {
+        pixman_f_transform ftransform;
+        pixman_f_transform_init_scale(&ftransform, scale_x, scale_y);
+        pixman_f_transform_translate(&ftransform, nullptr, offset_x, offset_y);
+
+        pixman_transform fixed_transform;
+        pixman_transform_from_pixman_f_transform(&fixed_transform, &ftransform);
+        pixman_image_set_transform(src.get(), &fixed_transform);
+        pixman_image_set_filter(
+            src.get(), smooth ? PIXMAN_FILTER_BILINEAR : PIXMAN_FILTER_NEAREST, nullptr, 0);
+    }
+
+    for (auto const& rect : region) {
+        auto const src_pos = rect.topLeft() + src_shift;
+        auto const dst_pos = rect.topLeft() - dst_offset;
+        pixman_image_composite32(PIXMAN_OP_OVER,
+                                 src.get(),
+                                 mask,
+                                 dst,
+                                 src_pos.x(),
+                                 src_pos.y(),
+                                 0,
+                                 0,
+                                 dst_pos.x(),
+                                 dst_pos.y(),
+                                 rect.width(),
+                                 rect.height());
+    }
+}
+
+inline pixman_image_ptr create_opacity_mask(qreal opacity)
+{
+    pixman_color const color{
+        .red = 0, .green = 0, .blue = 0, .alpha = static_cast<uint16_t>(qRound(opacity * 0xffff))};
+    return pixman_image_ptr(pixman_image_create_solid_fill(&color));
+}
+
+/**
+ * Composites @p item with pixman onto @p target, which covers @p area in device coordinates.
+ * Returns false without touching the target if the item can not be composited this way, for
+ * example because it is rotated. Then it must be painted with QPainter instead.
+ */
+inline bool draw_item_pixman(QImage& target, draw_item const& item, QRect const& area)
+{
+    if (!get_pixman_format(target.format())) {
+        return false;
+    }
+
+    auto const clip = item.clip.intersected(area);
+    if (clip.isEmpty()) {
+        return true;
+    }
+
+    auto dst = create_pixman_image(target);
+
+    if (item.fill) {
+        auto const color = item.fill->rgba64().premultiplied();
+        pixman_color const fill_color{.red = color.red(),
+                                      .green = color.green(),
+                                      .blue = color.blue(),
+                                      .alpha = color.alpha()};
+        for (auto const& rect : clip) {
+            pixman_box32_t const box{rect.left() - area.x(),
+                                     rect.top() - area.y(),
+                                     rect.right() + 1 - area.x(),
+                                     rect.bottom() + 1 - area.y()};
+            pixman_image_fill_boxes(PIXMAN_OP_OVER, dst.get(), &fill_color, 1, &box);
+        }
+        return true;
+    }
+
+    if (!is_pixman_compatible(item)) {
+        return false;
+    }
+
+    if (qFuzzyCompare(1.0, item.opacity)) {
+        for (auto const& img : item.images) {
+            composite_image_pixman(
+                dst.get(), img, item.transform, item.smooth, nullptr, clip, area.topLeft());
+        }
+        return true;
+    }
+
+    auto mask = create_opacity_mask(item.opacity);
+
+    if (item.images.size() == 1) {
+        composite_image_pixman(dst.get(),
+                               item.images.front(),
+                               item.transform,
+                               item.smooth,
+                               mask.get(),
+                               clip,
+                               area.topLeft());
+        return true;
+    }
+
+    // Like in the QPainter path overlapping images of a translucent item are composited into a
+    // layer first, so they are not blended twice with the item's opacity.
+    auto const layer_rect = clip.boundingRect();
+    auto layer = pixman_image_ptr(pixman_image_create_bits(
+        PIXMAN_a8r8g8b8, layer_rect.width(), layer_rect.height(), nullptr, 0));
+
+    for (auto const& img : item.images) {
+        composite_image_pixman(
+            layer.get(), img, item.transform, item.smooth, nullptr, clip, layer_rect.topLeft());
+    }
+
+    for (auto const& rect : clip) {
+        auto const src_pos = rect.topLeft() - layer_rect.topLeft();
+        auto const dst_pos = rect.topLeft() - area.topLeft();
+        pixman_image_composite32(PIXMAN_OP_OVER,
+                                 layer.get(),
+                                 mask.get(),
+                                 dst.get(),
+                                 src_pos.x(),
+                                 src_pos.y(),
+                                 0,
+                                 0,
+                                 dst_pos.x(),
+                                 dst_pos.y(),
+                                 rect.width(),
+                                 rect.height());
+    }
+
+    return true;
+}
+
+}
@@ -7,13 +7,16 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "backend.h"
 #include "buffer.h"
+#include "scratch_image_pool.h"
 #include "shadow.h"
+#include "tiled_rasterizer.h"
 #include "window.h"
 
 #include <como/render/interface/framebuffer.h>
 #include <como/render/scene.h>
 
 #include <QElapsedTimer>
+#include <cstring>
 
 namespace como::render::qpainter
 {
@@ -38,6 +41,17 @@ public:
         , m_painter(new QPainter())
     {
         QQuickWindow::setSceneGraphBackend("software");
+
+        use_pixman = qEnvironmentVariable("COMO_QPAINTER_PIXMAN") != QStringLiteral("0");
+        if (!use_pixman) {
+            qCDebug(KWIN_CORE) << "Compositing QPainter scene without pixman fast paths";
+        }
+
+        if (auto const tile_size = qEnvironmentVariableIntValue("COMO_QPAINTER_TILE_SIZE");
+            tile_size > 0) {
+            qCDebug(KWIN_CORE) << "Rasterizing QPainter scene in tiles of size" << tile_size;
+            rasterizer = std::make_unique<tiled_rasterizer>(tile_size, use_pixman);
+        }
     }
 
     int64_t paint_output(output_t* output,
@@ -51,7 +65,7 @@ public:
         this->createStackingOrder(ref_wins);
 
         auto mask = paint_type::none;
-        m_backend->begin_render(*output);
+        auto buffer = m_backend->begin_render(*output);
 
         auto const needsFullRepaint = m_backend->needsFullRepaint();
         if (needsFullRepaint) {
@@ -61,7 +75,6 @@ public:
 
         auto const geometry = output->geometry();
 
-        auto buffer = m_backend->bufferForScreen(output);
         if (!buffer || buffer->isNull()) {
             return renderTimer.nsecsElapsed();
         }
@@ -79,6 +92,10 @@ public:
         effect::render_data render{
             .targets = targets, .view = view, .projection = proj, .viewport = geometry};
 
+        if (rasterizer) {
+            rasterizer->begin(*buffer);
+        }
+
         m_painter->begin(buffer);
         m_painter->save();
         m_painter->setWindow(geometry);
@@ -86,17 +103,31 @@ public:
         this->repaint_output = output;
         QRegion updateRegion, validRegion;
 
+        // We paint directly into the output buffer that may contain the content of an older frame.
+        auto const repaint = m_backend->get_output_render_region(output);
+
         this->paintScreen(render,
                           mask,
                           damage.intersected(geometry),
-                          QRegion(),
+                          repaint,
                           &updateRegion,
                           &validRegion,
                           presentTime);
+
+        if (rasterizer) {
+            rasterizer->end();
+        }
         paintCursor();
 
         m_painter->restore();
         m_painter->end();
+        scratch_images.end_frame();
+
+        if constexpr (requires(Platform platform) { platform.capture; }) {
+            if (this->platform.capture->is_capturing(*output)) {
+                capture_output(*output, *buffer, updateRegion);
+            }
+        }
 
         m_backend->present(output, updateRegion);
 
@@ -139,6 +170,16 @@ public:
     }
 
     QPainter* scenePainter() const override
+    {
+        if (rasterizer) {
+            // Effects paint directly. Recorded window paints must be rasterized before.
+            rasterizer->flush();
+        }
+        return m_painter.data();
+    }
+
+    /// Painter for the scene's own paint operations without flushing recorded ones.
+    QPainter* painter() const
     {
         return m_painter.data();
     }
@@ -148,9 +189,32 @@ public:
         return m_backend;
     }
 
+    // Only set when the scene is rasterized in tiles on multiple threads.
+    std::unique_ptr<tiled_rasterizer> rasterizer;
+
+    // Composite windows with pixman directly when their transform allows it.
+    bool use_pixman{true};
+
+    // Temporary render targets for translucent windows, reused across frames.
+    scratch_image_pool scratch_images;
+
 protected:
     void paintBackground(QRegion const& region, QMatrix4x4 const& /*projection*/) override
     {
+        if (rasterizer && rasterizer->is_active()) {
+            // The region might be infinite. Limit it to what is visible on the device.
+            auto const transform = m_painter->combinedTransform();
+            auto const device = m_painter->device();
+            auto const bounds
+                = transform.inverted().mapRect(QRect(0, 0, device->width(), device->height()));
+
+            rasterizer->add({
+                .clip = transform.map(region.intersected(bounds)),
+                .fill = QColor(Qt::black),
+            });
+            return;
+        }
+
         m_painter->setBrush(Qt::black);
         for (const QRect& rect : region) {
             m_painter->drawRect(rect);
@@ -192,6 +256,38 @@ protected:
     }
 
 private:
+    /// Copies the damaged parts of the painted @p buffer to the capture streams of @p output.
+    void capture_output(output_t const& output, QImage const& buffer, QRegion const& damage)
+    {
+        if (buffer.depth() != 32) {
+            return;
+        }
+
+        auto const geometry = output.geometry();
+        auto const to_buffer = QTransform::fromTranslate(-geometry.x(), -geometry.y())
+            * QTransform::fromScale(static_cast<double>(buffer.width()) / geometry.width(),
+                                    static_cast<double>(buffer.height()) / geometry.height());
+
+        QRegion buffer_damage;
+        for (auto const& rect : damage) {
+            buffer_damage |= to_buffer.mapRect(rect).intersected(buffer.rect());
+        }
+
+        this->platform.capture->submit(
+            output,
+            buffer.size(),
+            buffer.format(),
+            false,
+            buffer_damage,
+            [&](QRect const& rect, uchar* data, int stride) {
+                for (int row = 0; row < rect.height(); row++) {
+                    std::memcpy(data + row * stride,
+                                buffer.constScanLine(rect.y() + row) + rect.x() * 4,
+                                rect.width() * 4);
+                }
+            });
+    }
+
     qpainter::backend<type>* m_backend;
     QScopedPointer<QPainter> m_painter;
 };
@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <cstdint>
+#include <deque>
+
+namespace como::render::qpainter
+{
+
+/**
+ * Pool of temporary images reused within and across frames, for example as render targets for
+ * translucent windows. Image sizes are rounded up to buckets so that slowly growing or shrinking
+ * windows still hit an existing image. Images not used for some frames are released.
+ */
+class scratch_image_pool
+{
+public:
+    /**
+     * Returns an image at least as large as @p size that is not handed out otherwise until it is
+     * released or the current frame ends. Its content is undefined.
+     */
+    QImage& acquire(QSize const& size)
+    {
+        auto const bucket = get_bucket_size(size);
+
+        entry* best{nullptr};
+        for (auto& entry : entries) {
+            if (entry.in_use || entry.image.width() < bucket.width()
+                || entry.image.height() < bucket.height()) {
+                continue;
+            }
+            if (!best || area(entry.image.size()) < area(best->image.size())) {
+                best = &entry;
+            }
+        }
+
+        if (!best) {
+            entries.push_back({QImage(bucket, QImage::Format_ARGB32_Premultiplied)});
+            best = &entries.back();
+        }
+
+        best->in_use = true;
+        best->used = true;
+        best->unused_frames = 0;
+        return best->image;
+    }
+
+    /// Makes @p image available again for later acquisitions in the current frame.
+    void release(QImage const& image)
+    {
+        for (auto& entry : entries) {
+            if (&entry.image == &image) {
+                entry.in_use = false;
+                return;
+            }
+        }
+    }
+
+    /// Makes all images available again and releases the ones not needed for a while.
+    void end_frame()
+    {
+        for (auto& entry : entries) {
+            if (!entry.used) {
+                entry.unused_frames++;
+            }
+            entry.in_use = false;
+            entry.used = false;
+        }
+
+        std::erase_if(entries,
+                      [](auto const& entry) { return entry.unused_frames > max_unused_frames; });
+    }
+
+private:
+    struct entry {
+        QImage image;
+        bool in_use{false};
+        bool used{false};
+        int unused_frames{0};
+    };
+
+    static QSize get_bucket_size(QSize const& size)
+    {
+        auto round_up
+            = [](int value) { return (value + bucket_step - 1) / bucket_step * bucket_step; };
+        return {round_up(size.width()), round_up(size.height())};
+    }
+
+    static int64_t area(QSize const& size)
+    {
+        return static_cast<int64_t>(size.width()) * size.height();
+    }
+
+    static constexpr int bucket_step{64};
+    static constexpr int max_unused_frames{120};
+
+    std::deque<entry> entries;
+};
+
+}
@@ -0,0 +1,199 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "draw_item.h"
+#include "pixman_compositor.h"
+
+#include <QtConcurrentMap>
+#include <cassert>
+
+namespace como::render::qpainter
+{
+
+/// @p layer is reused between calls for the translucent items of the tile.
+inline void
+draw_item_on_tile(QPainter& painter, draw_item const& item, QRect const& tile, QImage& layer)
+{
+    auto const clip = item.clip.intersected(tile);
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    auto const tile_offset = QTransform::fromTranslate(-tile.x(), -tile.y());
+    auto const tile_clip = clip.translated(-tile.topLeft());
+
+    if (item.fill) {
+        for (auto const& rect : tile_clip) {
+            painter.fillRect(rect, *item.fill);
+        }
+        return;
+    }
+
+    painter.save();
+    painter.setClipRegion(tile_clip);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, item.smooth);
+
+    if (qFuzzyCompare(1.0, item.opacity)) {
+        painter.setTransform(item.transform * tile_offset);
+        draw_images(painter, item.images);
+        painter.restore();
+        return;
+    }
+
+    // Translucent items are painted into a temporary layer first, which is then blended with the
+    // item's opacity. That way overlapping parts like shadow and content are not blended twice.
+    auto const layer_rect = clip.boundingRect();
+    auto const layer_size_rect = QRect(QPoint(0, 0), layer_rect.size());
+    if (layer.width() < layer_rect.width() || layer.height() < layer_rect.height()) {
+        // The clip is capped by the tile, so a tile sized layer fits all items of the tile.
+        layer = QImage(tile.size().expandedTo(layer.size()), QImage::Format_ARGB32_Premultiplied);
+    }
+
+    QPainter layer_painter(&layer);
+    layer_painter.setCompositionMode(QPainter::CompositionMode_Source);
+    layer_painter.fillRect(layer_size_rect, Qt::transparent);
+    layer_painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    layer_painter.setClipRect(layer_size_rect);
+    layer_painter.setRenderHint(QPainter::SmoothPixmapTransform, item.smooth);
+    layer_painter.setTransform(item.transform
+                               * QTransform::fromTranslate(-layer_rect.x(), -layer_rect.y()));
+    draw_images(layer_painter, item.images);
+
+    layer_painter.resetTransform();
+    layer_painter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+    QColor translucent(Qt::transparent);
+    translucent.setAlphaF(item.opacity);
+    layer_painter.fillRect(layer_size_rect, translucent);
+    layer_painter.end();
+
+    painter.drawImage(layer_rect.topLeft() - tile.topLeft(), layer, layer_size_rect);
+    painter.restore();
+}
+
+/**
+ * Rasterizes recorded paint operations in parallel. The output buffer is split into square tiles
+ * and every tile intersecting the recorded clips is painted on the global thread pool with its own
+ * QPainter on a sub-image of the buffer. Items that pixman can composite skip QPainter entirely.
+ * Layers for translucent items are kept per tile and reused across frames.
+ */
+class tiled_rasterizer
+{
+public:
+    tiled_rasterizer(int tile_size, bool use_pixman)
+        : tile_size{tile_size}
+        , use_pixman{use_pixman}
+    {
+    }
+
+    void begin(QImage& buffer)
+    {
+        assert(items.empty());
+        target = &buffer;
+        target_bits = buffer.bits();
+    }
+
+    void end()
+    {
+        flush();
+        target = nullptr;
+        target_bits = nullptr;
+    }
+
+    bool is_active() const
+    {
+        return target;
+    }
+
+    void add(draw_item item)
+    {
+        assert(is_active());
+        items.push_back(std::move(item));
+    }
+
+    /// Paints all recorded items into the buffer. Must be called before painting on it directly.
+    void flush()
+    {
+        if (items.empty()) {
+            return;
+        }
+
+        QRegion region;
+        for (auto const& item : items) {
+            region |= item.clip;
+        }
+
+        auto tiles = get_tiles(region.intersected(target->rect()));
+        if (tile_layers.size() < tiles.size()) {
+            tile_layers.resize(tiles.size());
+        }
+
+        std::vector<tile_job> jobs;
+        jobs.reserve(tiles.size());
+        for (size_t index = 0; index < tiles.size(); index++) {
+            jobs.push_back({tiles.at(index), &tile_layers.at(index)});
+        }
+
+        auto const stride = target->bytesPerLine();
+        auto const pixel_size = target->depth() / 8;
+        auto const format = target->format();
+
+        QtConcurrent::blockingMap(jobs, [&](tile_job const& job) {
+            auto const& tile = job.tile;
+            QImage tile_image(target_bits + tile.y() * stride + tile.x() * pixel_size,
+                              tile.width(),
+                              tile.height(),
+                              stride,
+                              format);
+            QPainter painter(&tile_image);
+            for (auto const& item : items) {
+                if (!use_pixman || !draw_item_pixman(tile_image, item, tile)) {
+                    draw_item_on_tile(painter, item, tile, *job.layer);
+                }
+            }
+        });
+
+        items.clear();
+    }
+
+private:
+    struct tile_job {
+        QRect tile;
+        QImage* layer;
+    };
+
+    std::vector<QRect> get_tiles(QRegion const& region) const
+    {
+        std::vector<QRect> tiles;
+        if (region.isEmpty()) {
+            return tiles;
+        }
+
+        auto const bounds = region.boundingRect();
+        auto const first_x = bounds.left() - bounds.left() % tile_size;
+        auto const first_y = bounds.top() - bounds.top() % tile_size;
+
+        for (auto y = first_y; y <= bounds.bottom(); y += tile_size) {
+            for (auto x = first_x; x <= bounds.right(); x += tile_size) {
+                auto const tile = QRect(x, y, tile_size, tile_size).intersected(target->rect());
+                if (region.intersects(tile)) {
+                    tiles.push_back(tile);
+                }
+            }
+        }
+
+        return tiles;
+    }
+
+    int tile_size;
+    bool use_pixman;
+    QImage* target{nullptr};
+    uchar* target_bits{nullptr};
+    std::vector<draw_item> items;
+    std::vector<QImage> tile_layers;
+};
+
+}
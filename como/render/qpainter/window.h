@@ -8,7 +8,9 @@
 
 #include "buffer.h"
 #include "deco_renderer.h"
+#include "pixman_compositor.h"
 #include "shadow.h"
+#include "tiled_rasterizer.h"
 
 #include <como/win/scene.h>
 
@@ -61,13 +63,53 @@ private:
             win.render_data.damage_region = {};
         }
 
-        auto scenePainter = scene.scenePainter();
-        auto painter = scenePainter;
+        std::vector<draw_image> images;
+        add_shadow_images(win, images);
+        add_decoration_images(win, images);
+        add_content_image(win, *buffer, images);
+
+        auto painter = scene.painter();
+        auto const win_pos = win.geo.pos();
+
+        if (scene.use_pixman || (scene.rasterizer && scene.rasterizer->is_active())) {
+            // Describe the paint operation in device coordinates. It is either rasterized later in
+            // tiles or composited directly with pixman.
+            QTransform transform;
+            transform.translate(win_pos.x(), win_pos.y());
+
+            if (flags(mask & paint_type::window_transformed)) {
+                transform.translate(data.paint.geo.translation.x(), data.paint.geo.translation.y());
+                transform.scale(data.paint.geo.scale.x(), data.paint.geo.scale.y());
+            }
+
+            auto const device_transform = painter->combinedTransform();
+            draw_item item{
+                .clip = device_transform.map(data.paint.region),
+                .transform = transform * device_transform,
+                .opacity = data.paint.opacity,
+                .images = std::move(images),
+                .smooth = painter->testRenderHint(QPainter::SmoothPixmapTransform),
+            };
+
+            if (scene.rasterizer && scene.rasterizer->is_active()) {
+                scene.rasterizer->add(std::move(item));
+                return;
+            }
+
+            auto device = painter->device();
+            if (device->devType() == QInternal::Image) {
+                auto& target = *static_cast<QImage*>(device);
+                if (draw_item_pixman(target, item, target.rect())) {
+                    return;
+                }
+            }
+
+            images = std::move(item.images);
+        }
+
         painter->save();
         painter->setClipRegion(data.paint.region);
         painter->setClipping(true);
-
-        auto const win_pos = win.geo.pos();
         painter->translate(win_pos.x(), win_pos.y());
 
         if (flags(mask & paint_type::window_transformed)) {
@@ -75,24 +117,50 @@ private:
             painter->scale(data.paint.geo.scale.x(), data.paint.geo.scale.y());
         }
 
-        auto const opaque = qFuzzyCompare(1.0, data.paint.opacity);
-        QImage tempImage;
-        QPainter tempPainter;
+        if (qFuzzyCompare(1.0, data.paint.opacity)) {
+            draw_images(*painter, images);
+            painter->restore();
+            return;
+        }
 
-        if (!opaque) {
-            // need a temp render target which we later on blit to the screen
-            tempImage = QImage(win::visible_rect(&win).size(), QImage::Format_ARGB32_Premultiplied);
-            tempImage.fill(Qt::transparent);
-            tempPainter.begin(&tempImage);
-            tempPainter.save();
-            tempPainter.translate(win.geo.frame.topLeft() - win::visible_rect(&win).topLeft());
-            painter = &tempPainter;
+        // Need a temp render target which we later on blit to the screen. Its content outside of
+        // the painted region would be clipped away anyway, so only that part is rendered.
+        auto layer_rect = win::visible_rect(&win).translated(-win_pos);
+        if (!(mask & (paint_type::window_transformed | paint_type::screen_transformed))) {
+            layer_rect &= data.paint.region.boundingRect().translated(-win_pos);
+        }
+        if (layer_rect.isEmpty()) {
+            painter->restore();
+            return;
         }
 
-        render_shadow(win, painter);
-        render_decorations(win, painter);
+        auto const layer_size_rect = QRect(QPoint(0, 0), layer_rect.size());
+        auto& layer = scene.scratch_images.acquire(layer_rect.size());
+
+        QPainter tempPainter(&layer);
+        tempPainter.setCompositionMode(QPainter::CompositionMode_Source);
+        tempPainter.fillRect(layer_size_rect, Qt::transparent);
+        tempPainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        tempPainter.setClipRect(layer_size_rect);
+        tempPainter.translate(-layer_rect.topLeft());
+        draw_images(tempPainter, images);
+
+        tempPainter.resetTransform();
+        tempPainter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+        QColor translucent(Qt::transparent);
+        translucent.setAlphaF(data.paint.opacity);
+        tempPainter.fillRect(layer_size_rect, translucent);
+        tempPainter.end();
+
+        painter->drawImage(layer_rect.topLeft(), layer, layer_size_rect);
+        painter->restore();
+
+        scene.scratch_images.release(layer);
+    }
 
-        // render content
+    template<typename Win>
+    void add_content_image(Win& win, buffer_t const& buffer, std::vector<draw_image>& images)
+    {
         QRectF source;
         QRectF target;
         QRectF viewportRectangle;
@@ -118,30 +186,16 @@ private:
                 source = QRectF(viewportRectangle.topLeft() * imageScale,
                                 viewportRectangle.bottomRight() * imageScale);
             } else {
-                source = buffer->image.rect();
+                source = buffer.image.rect();
             }
             target = win::render_geometry(&win).translated(-win.geo.pos());
         }
 
-        painter->drawImage(target, buffer->image, source);
-
-        if (!opaque) {
-            tempPainter.restore();
-            tempPainter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
-            QColor translucent(Qt::transparent);
-            translucent.setAlphaF(data.paint.opacity);
-            tempPainter.fillRect(QRect(QPoint(0, 0), win::visible_rect(&win).size()), translucent);
-            tempPainter.end();
-            painter = scenePainter;
-            painter->drawImage(win::visible_rect(&win).topLeft() - win.geo.frame.topLeft(),
-                               tempImage);
-        }
-
-        painter->restore();
+        images.push_back({target, buffer.image, source});
     }
 
     template<typename Win>
-    void render_shadow(Win& win, QPainter* painter)
+    void add_shadow_images(Win& win, std::vector<draw_image>& images)
     {
         if (!win::shadow(&win)) {
             return;
@@ -162,12 +216,12 @@ private:
                           topLeft.textureY(),
                           bottomRight.textureX() - topLeft.textureX(),
                           bottomRight.textureY() - topLeft.textureY());
-            painter->drawImage(target, shadowTexture, source);
+            images.push_back({target, shadowTexture, source});
         }
     }
 
     template<typename Win>
-    void render_decorations(Win& win, QPainter* painter)
+    void add_decoration_images(Win& win, std::vector<draw_image>& images)
     {
         // TODO: custom decoration opacity
         auto const& ctrl = win.control;
@@ -199,10 +253,15 @@ private:
             return;
         }
 
-        painter->drawImage(dtr, deco_data->image(DecorationPart::Top));
-        painter->drawImage(dlr, deco_data->image(DecorationPart::Left));
-        painter->drawImage(drr, deco_data->image(DecorationPart::Right));
-        painter->drawImage(dbr, deco_data->image(DecorationPart::Bottom));
+        auto add_part = [&](QRect const& rect, DecorationPart part) {
+            auto const& image = deco_data->image(part);
+            images.push_back({rect, image, image.rect()});
+        };
+
+        add_part(dtr, DecorationPart::Top);
+        add_part(dlr, DecorationPart::Left);
+        add_part(drr, DecorationPart::Right);
+        add_part(dbr, DecorationPart::Bottom);
     }
 
     Scene& scene;
@@ -0,0 +1,203 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <Wrapland/Server/buffer.h>
+#include <Wrapland/Server/linux_dmabuf_v1.h>
+#include <Wrapland/Server/surface.h>
+#include <fcntl.h>
+#include <functional>
+#include <linux/dma-buf.h>
+#include <memory>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace como::render::wayland
+{
+
+/**
+ * Checks without blocking if the client's GPU work on the buffer has finished. A dmabuf polls
+ * readable once all of its implicit write fences are signalled. Sampling it before that point
+ * would stall our rendering in the driver.
+ */
+inline bool is_buffer_ready(Wrapland::Server::Buffer& buffer)
+{
+    auto dmabuf = buffer.linuxDmabufBuffer();
+    if (!dmabuf) {
+        // Shm buffers are copied on the CPU and wl_drm buffers can not be queried.
+        return true;
+    }
+
+    std::vector<pollfd> fds;
+    fds.reserve(dmabuf->planes.size());
+    for (auto const& plane : dmabuf->planes) {
+        fds.push_back({.fd = plane.fd, .events = POLLIN, .revents = 0});
+    }
+
+    auto const count = poll(fds.data(), fds.size(), 0);
+    if (count < 0) {
+        // Do not hold back the buffer forever in case of an error.
+        return true;
+    }
+
+    return count == static_cast<int>(fds.size());
+}
+
+/**
+ * Exports the current write fences of a dmabuf as a sync_file. It becomes readable once the
+ * fences are signalled. Returns -1 on error.
+ */
+inline int export_sync_file(int dmabuf_fd)
+{
+#ifdef DMA_BUF_IOCTL_EXPORT_SYNC_FILE
+    dma_buf_export_sync_file request{.flags = DMA_BUF_SYNC_READ, .fd = -1};
+    if (ioctl(dmabuf_fd, DMA_BUF_IOCTL_EXPORT_SYNC_FILE, &request) == 0) {
+        return request.fd;
+    }
+#endif
+
+    // The kernel can not export the fences. The dmabuf itself polls readable at the same time.
+    return fcntl(dmabuf_fd, F_DUPFD_CLOEXEC, 0);
+}
+
+/**
+ * Calls back once when all file descriptors became readable. Takes ownership of the descriptors.
+ * The callback is not called anymore after @p context was destroyed.
+ */
+class buffer_fence
+{
+public:
+    buffer_fence(std::vector<int> fds, QObject* context, std::function<void()> ready)
+    {
+        for (auto fd : fds) {
+            auto& fence_fd = this->fds.emplace_back(std::make_unique<buffer_fence_fd>(fd));
+            auto notifier = fence_fd->notifier.get();
+
+            QObject::connect(
+                notifier, &QSocketNotifier::activated, context, [this, notifier, ready] {
+                    notifier->setEnabled(false);
+                    if (--pending == 0) {
+                        ready();
+                    }
+                });
+        }
+
+        pending = this->fds.size();
+    }
+
+    buffer_fence(buffer_fence const&) = delete;
+    buffer_fence& operator=(buffer_fence const&) = delete;
+
+    bool is_signaled() const
+    {
+        return pending == 0;
+    }
+
+private:
+    struct buffer_fence_fd {
+        explicit buffer_fence_fd(int fd)
+            : fd{fd}
+            , notifier{std::make_unique<QSocketNotifier>(fd, QSocketNotifier::Read)}
+        {
+        }
+
+        ~buffer_fence_fd()
+        {
+            notifier.reset();
+            close(fd);
+        }
+
+        int fd;
+        std::unique_ptr<QSocketNotifier> notifier;
+    };
+
+    std::vector<std::unique_ptr<buffer_fence_fd>> fds;
+    size_t pending{0};
+};
+
+/**
+ * Holds back dmabuf buffers of surfaces until the client's GPU work on them has finished.
+ *
+ * The state is per surface and shared by all outputs. While the latest buffer of a surface is
+ * pending, its fences are watched and the surface's window is repainted once they signalled.
+ */
+class buffer_sync
+{
+public:
+    buffer_sync() = default;
+    buffer_sync(buffer_sync const&) = delete;
+    buffer_sync& operator=(buffer_sync const&) = delete;
+
+    ~buffer_sync()
+    {
+        for (auto& [surface, watch] : watches) {
+            QObject::disconnect(watch.destroyed);
+        }
+    }
+
+    bool is_pending(Wrapland::Server::Surface* surface) const
+    {
+        return watches.contains(surface);
+    }
+
+    /**
+     * Returns if the latest buffer of @p surface can be sampled. Otherwise its fences are watched
+     * and @p ready is called once they signalled, unless @p context was destroyed before.
+     */
+    bool check(Wrapland::Server::Surface* surface, QObject* context, std::function<void()> ready)
+    {
+        auto const& buffer = surface->state().buffer;
+
+        if (auto it = watches.find(surface); it != watches.end()) {
+            if (it->second.buffer.lock() == buffer && !it->second.fence->is_signaled()) {
+                return false;
+            }
+
+            // Signalled or replaced by a newer buffer.
+            QObject::disconnect(it->second.destroyed);
+            watches.erase(it);
+        }
+
+        if (!buffer || is_buffer_ready(*buffer)) {
+            return true;
+        }
+
+        std::vector<int> fds;
+        for (auto const& plane : buffer->linuxDmabufBuffer()->planes) {
+            if (auto fd = export_sync_file(plane.fd); fd >= 0) {
+                fds.push_back(fd);
+            }
+        }
+        if (fds.empty()) {
+            return true;
+        }
+
+        auto& watch = watches[surface];
+        watch.buffer = buffer;
+        watch.fence = std::make_unique<buffer_fence>(std::move(fds), context, std::move(ready));
+        watch.destroyed = QObject::connect(
+            surface, &Wrapland::Server::Surface::resourceDestroyed, [this, surface] {
+                watches.erase(surface);
+            });
+        return false;
+    }
+
+private:
+    struct surface_watch {
+        std::weak_ptr<Wrapland::Server::Buffer> buffer;
+        std::unique_ptr<buffer_fence> fence;
+        QMetaObject::Connection destroyed;
+    };
+
+    std::unordered_map<Wrapland::Server::Surface*, surface_watch> watches;
+};
+
+}
@@ -0,0 +1,261 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "capture_manager.h"
+
+#include "capturestreamadaptor.h"
+
+#include <como/desktop/kde/service_utils.h>
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMetaType>
+#include <QDBusReply>
+#include <QDBusServiceWatcher>
+#include <algorithm>
+
+namespace como::render::wayland
+{
+
+static QString const s_dbusInterface = QStringLiteral("org.kde.KWin.CaptureStream");
+static QString const s_dbusObjectPath = QStringLiteral("/CaptureStream");
+
+static QString const s_errorNotAuthorized
+    = QStringLiteral("org.kde.KWin.CaptureStream.Error.NoAuthorized");
+static QString const s_errorNotAuthorizedMessage
+    = QStringLiteral("The process is not authorized to capture the screen");
+static QString const s_errorInvalidScreen
+    = QStringLiteral("org.kde.KWin.CaptureStream.Error.InvalidScreen");
+static QString const s_errorInvalidScreenMessage = QStringLiteral("Invalid screen requested");
+static QString const s_errorInvalidStream
+    = QStringLiteral("org.kde.KWin.CaptureStream.Error.InvalidStream");
+static QString const s_errorInvalidStreamMessage = QStringLiteral("Invalid stream requested");
+static QString const s_errorInvalidBuffer
+    = QStringLiteral("org.kde.KWin.CaptureStream.Error.InvalidBuffer");
+static QString const s_errorInvalidBufferMessage = QStringLiteral("Invalid buffer requested");
+
+capture_manager::capture_manager()
+    : watcher{new QDBusServiceWatcher(this)}
+{
+    qDBusRegisterMetaType<QList<QRect>>();
+
+    watcher->setConnection(QDBusConnection::sessionBus());
+    watcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    QObject::connect(
+        watcher, &QDBusServiceWatcher::serviceUnregistered, this, [this](auto const& service) {
+            watcher->removeWatchedService(service);
+
+            std::vector<uint> owned;
+            for (auto const& [id, entry] : streams) {
+                if (entry.owner == service) {
+                    owned.push_back(id);
+                }
+            }
+            for (auto id : owned) {
+                streams.erase(id);
+            }
+        });
+
+    new CaptureStreamAdaptor(this);
+    QDBusConnection::sessionBus().registerObject(s_dbusObjectPath, this);
+}
+
+capture_manager::~capture_manager()
+{
+    QDBusConnection::sessionBus().unregisterObject(s_dbusObjectPath);
+}
+
+bool capture_manager::is_capturing(base::output const& output) const
+{
+    return std::any_of(streams.cbegin(), streams.cend(), [&](auto const& entry) {
+        return &entry.second.stream->output == &output;
+    });
+}
+
+void capture_manager::submit(base::output const& output,
+                             QSize const& size,
+                             QImage::Format format,
+                             bool y_inverted,
+                             QRegion const& damage,
+                             capture_stream::copy_function const& copy)
+{
+    for (auto& [id, entry] : streams) {
+        if (&entry.stream->output == &output) {
+            entry.stream->submit(size, format, y_inverted, damage, copy);
+        }
+    }
+}
+
+void capture_manager::remove_output(base::output const& output)
+{
+    std::vector<uint> removed;
+    for (auto const& [id, entry] : streams) {
+        if (&entry.stream->output == &output) {
+            removed.push_back(id);
+        }
+    }
+    for (auto id : removed) {
+        close_stream(id);
+    }
+}
+
+uint capture_manager::CreateStream(QString const& name)
+{
+    if (!check_permissions()) {
+        return 0;
+    }
+
+    auto output = integration.get_output(name);
+    if (!output) {
+        sendErrorReply(s_errorInvalidScreen, s_errorInvalidScreenMessage);
+        return 0;
+    }
+
+    auto const id = next_stream++;
+    auto const owner = message().service();
+
+    // Three buffers allow the consumer to hold one frame while the next one is already written.
+    auto stream = std::make_unique<capture_stream>(*output, 3);
+
+    QObject::connect(stream.get(), &capture_stream::buffers_changed, this, [this, id, owner] {
+        send_signal(owner, QStringLiteral("BuffersChanged"), {id});
+    });
+    QObject::connect(stream.get(),
+                     &capture_stream::frame_ready,
+                     this,
+                     [this, id, owner](auto index, auto const& damage, auto sequence) {
+                         QList<QRect> rects;
+                         for (auto const& rect : damage) {
+                             rects.push_back(rect);
+                         }
+                         send_signal(owner,
+                                     QStringLiteral("FrameReady"),
+                                     {id,
+                                      static_cast<uint>(index),
+                                      static_cast<qulonglong>(sequence),
+                                      QVariant::fromValue(rects)});
+                     });
+
+    streams.insert({id, {owner, std::move(stream)}});
+    watcher->addWatchedService(owner);
+
+    // The first frame must contain the complete output.
+    integration.repaint(*output);
+    return id;
+}
+
+void capture_manager::DestroyStream(uint stream)
+{
+    if (!get_owned_stream(stream)) {
+        return;
+    }
+    streams.erase(stream);
+}
+
+QVariantMap capture_manager::GetStreamInfo(uint stream)
+{
+    auto entry = get_owned_stream(stream);
+    if (!entry) {
+        return {};
+    }
+
+    auto const& capture = *entry->stream;
+    return {
+        {QStringLiteral("width"), static_cast<uint>(capture.size.width())},
+        {QStringLiteral("height"), static_cast<uint>(capture.size.height())},
+        {QStringLiteral("stride"), static_cast<uint>(capture.stride)},
+        {QStringLiteral("format"), capture.drm_format()},
+        {QStringLiteral("y-inverted"), capture.y_inverted},
+        {QStringLiteral("buffers"), static_cast<uint>(capture.buffers.size())},
+    };
+}
+
+QDBusUnixFileDescriptor capture_manager::GetBuffer(uint stream, uint index)
+{
+    auto entry = get_owned_stream(stream);
+    if (!entry) {
+        return {};
+    }
+
+    auto const& buffers = entry->stream->buffers;
+    if (index >= buffers.size()) {
+        sendErrorReply(s_errorInvalidBuffer, s_errorInvalidBufferMessage);
+        return {};
+    }
+
+    // The descriptor is duplicated and sent with the reply.
+    return QDBusUnixFileDescriptor(buffers.at(index).fd.fd);
+}
+
+void capture_manager::ReleaseBuffer(uint stream, uint index)
+{
+    auto entry = get_owned_stream(stream);
+    if (!entry) {
+        return;
+    }
+
+    if (!entry->stream->release(static_cast<int>(index))) {
+        sendErrorReply(s_errorInvalidBuffer, s_errorInvalidBufferMessage);
+    }
+}
+
+bool capture_manager::check_permissions() const
+{
+    if (!calledFromDBus()) {
+        return false;
+    }
+
+    QDBusReply<uint> const reply = connection().interface()->servicePid(message().service());
+    if (!reply.isValid()) {
+        return false;
+    }
+
+    auto const interfaces = desktop::kde::fetchRestrictedDBusInterfacesFromPid(reply.value());
+    if (!interfaces.contains(s_dbusInterface)) {
+        sendErrorReply(s_errorNotAuthorized, s_errorNotAuthorizedMessage);
+        return false;
+    }
+
+    return true;
+}
+
+capture_manager::stream_entry* capture_manager::get_owned_stream(uint stream)
+{
+    if (!calledFromDBus()) {
+        return nullptr;
+    }
+
+    auto it = streams.find(stream);
+    if (it == streams.end() || it->second.owner != message().service()) {
+        sendErrorReply(s_errorInvalidStream, s_errorInvalidStreamMessage);
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+void capture_manager::close_stream(uint stream)
+{
+    auto it = streams.find(stream);
+    if (it == streams.end()) {
+        return;
+    }
+
+    auto const owner = it->second.owner;
+    streams.erase(it);
+    send_signal(owner, QStringLiteral("StreamClosed"), {stream});
+}
+
+void capture_manager::send_signal(QString const& owner,
+                                  QString const& name,
+                                  QVariantList const& args)
+{
+    // Frames are only sent to the owner of the stream and not broadcast on the bus.
+    auto msg = QDBusMessage::createTargetedSignal(owner, s_dbusObjectPath, s_dbusInterface, name);
+    msg.setArguments(args);
+    QDBusConnection::sessionBus().send(msg);
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "capture_stream.h"
+#include "como_export.h"
+
+#include <como/base/output.h>
+#include <como/base/platform_qobject.h>
+
+#include <QDBusContext>
+#include <QDBusUnixFileDescriptor>
+#include <QList>
+#include <QObject>
+#include <QRect>
+#include <QVariantMap>
+#include <functional>
+#include <map>
+#include <memory>
+
+class QDBusServiceWatcher;
+
+namespace como::render::wayland
+{
+
+struct capture_manager_integration {
+    std::function<base::output*(QString const&)> get_output;
+    std::function<void(base::output const&)> repaint;
+};
+
+/**
+ * Provides capture streams of outputs over D-Bus. Each stream belongs to the D-Bus connection that
+ * created it and ends when that connection goes away.
+ */
+class COMO_EXPORT capture_manager : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.KWin.CaptureStream")
+
+public:
+    capture_manager();
+    ~capture_manager() override;
+
+    bool is_capturing(base::output const& output) const;
+
+    /// Submits a painted frame of @p output to all of its streams.
+    void submit(base::output const& output,
+                QSize const& size,
+                QImage::Format format,
+                bool y_inverted,
+                QRegion const& damage,
+                capture_stream::copy_function const& copy);
+
+    /// Closes all streams of @p output.
+    void remove_output(base::output const& output);
+
+    capture_manager_integration integration;
+
+public Q_SLOTS:
+    uint CreateStream(QString const& name);
+    void DestroyStream(uint stream);
+    QVariantMap GetStreamInfo(uint stream);
+    QDBusUnixFileDescriptor GetBuffer(uint stream, uint index);
+    void ReleaseBuffer(uint stream, uint index);
+
+private:
+    struct stream_entry {
+        QString owner;
+        std::unique_ptr<capture_stream> stream;
+    };
+
+    bool check_permissions() const;
+    stream_entry* get_owned_stream(uint stream);
+    void close_stream(uint stream);
+    void send_signal(QString const& owner, QString const& name, QVariantList const& args);
+
+    QDBusServiceWatcher* watcher;
+    std::map<uint, stream_entry> streams;
+    uint next_stream{1};
+};
+
+template<typename Platform>
+void capture_setup(Platform& platform)
+{
+    auto& capture = *platform.capture;
+
+    capture.integration.get_output = [&platform](auto const& name) -> base::output* {
+        for (auto output : platform.base.outputs) {
+            if (output->name() == name) {
+                return output;
+            }
+        }
+        return nullptr;
+    };
+    capture.integration.repaint
+        = [&platform](auto const& output) { platform.addRepaint(output.geometry()); };
+
+    QObject::connect(platform.base.qobject.get(),
+                     &base::platform_qobject::output_removed,
+                     &capture,
+                     [&capture](auto output) { capture.remove_output(*output); });
+}
+
+}
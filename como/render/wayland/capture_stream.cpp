@@ -0,0 +1,172 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "capture_stream.h"
+
+#include <como/base/logging.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace como::render::wayland
+{
+
+capture_stream::capture_stream(base::output const& output, int buffer_count)
+    : output{output}
+    , buffer_count{buffer_count}
+{
+}
+
+capture_stream::~capture_stream()
+{
+    clear_buffers();
+}
+
+void capture_stream::submit(QSize const& size,
+                            QImage::Format format,
+                            bool y_inverted,
+                            QRegion const& damage,
+                            copy_function const& copy)
+{
+    auto const rect = QRect(QPoint(0, 0), size);
+
+    if (size != this->size || format != this->format || y_inverted != this->y_inverted
+        || buffers.empty()) {
+        this->size = size;
+        this->format = format;
+        this->y_inverted = y_inverted;
+
+        if (!allocate_buffers()) {
+            return;
+        }
+
+        pending_damage = rect;
+        Q_EMIT buffers_changed();
+    } else {
+        auto const frame_damage = damage.intersected(rect);
+        pending_damage |= frame_damage;
+        for (auto& buffer : buffers) {
+            buffer.stale |= frame_damage;
+        }
+    }
+
+    if (pending_damage.isEmpty()) {
+        // Nothing changed since the last emitted frame.
+        return;
+    }
+
+    auto it = std::find_if(
+        buffers.begin(), buffers.end(), [](auto const& buffer) { return !buffer.held; });
+    if (it == buffers.end()) {
+        // The consumer is too slow. Keep the damage for the next frame.
+        return;
+    }
+
+    for (auto const& stale_rect : it->stale) {
+        copy(stale_rect, it->data + stale_rect.y() * stride + stale_rect.x() * 4, stride);
+    }
+
+    it->stale = {};
+    it->held = true;
+
+    auto const frame_damage = pending_damage;
+    pending_damage = {};
+
+    Q_EMIT frame_ready(static_cast<int>(std::distance(buffers.begin(), it)),
+                       frame_damage,
+                       ++sequence);
+}
+
+bool capture_stream::release(int index)
+{
+    if (index < 0 || index >= static_cast<int>(buffers.size()) || !buffers.at(index).held) {
+        return false;
+    }
+
+    buffers.at(index).held = false;
+    return true;
+}
+
+static constexpr uint32_t fourcc_code(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8)
+        | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+uint32_t capture_stream::drm_format() const
+{
+    // DRM formats describe little-endian words, Qt's 32-bit formats native-endian ones.
+    switch (format) {
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        return QSysInfo::ByteOrder == QSysInfo::LittleEndian ? fourcc_code('A', 'R', '2', '4') : 0;
+    case QImage::Format_RGB32:
+        return QSysInfo::ByteOrder == QSysInfo::LittleEndian ? fourcc_code('X', 'R', '2', '4') : 0;
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        return fourcc_code('A', 'B', '2', '4');
+    case QImage::Format_RGBX8888:
+        return fourcc_code('X', 'B', '2', '4');
+    default:
+        return 0;
+    }
+}
+
+bool capture_stream::allocate_buffers()
+{
+    clear_buffers();
+
+    stride = size.width() * 4;
+    auto const buffer_size = static_cast<size_t>(stride) * size.height();
+    if (!buffer_size) {
+        return false;
+    }
+
+    for (int i = 0; i < buffer_count; i++) {
+        file_descriptor fd{memfd_create("como-capture", MFD_CLOEXEC | MFD_ALLOW_SEALING)};
+        if (!fd.is_valid()) {
+            qCWarning(KWIN_CORE) << "Failed to create capture buffer:" << strerror(errno);
+            clear_buffers();
+            return false;
+        }
+
+        if (ftruncate(fd.fd, buffer_size) == -1) {
+            qCWarning(KWIN_CORE) << "Failed to resize capture buffer:" << strerror(errno);
+            clear_buffers();
+            return false;
+        }
+
+        // The consumer may map the buffer but must not change its size.
+        fcntl(fd.fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+
+        auto data = mmap(nullptr, buffer_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.fd, 0);
+        if (data == MAP_FAILED) {
+            qCWarning(KWIN_CORE) << "Failed to map capture buffer:" << strerror(errno);
+            clear_buffers();
+            return false;
+        }
+
+        buffers.push_back({.fd = std::move(fd),
+                           .data = static_cast<uchar*>(data),
+                           .size = buffer_size,
+                           .stale = QRect(QPoint(0, 0), size)});
+    }
+
+    return true;
+}
+
+void capture_stream::clear_buffers()
+{
+    for (auto& buffer : buffers) {
+        munmap(buffer.data, buffer.size);
+    }
+    buffers.clear();
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "como_export.h"
+
+#include <como/utils/file_descriptor.h>
+
+#include <QImage>
+#include <QObject>
+#include <QRegion>
+#include <QSize>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace como::base
+{
+class output;
+}
+
+namespace como::render::wayland
+{
+
+/// Shared memory buffer of a capture stream. The consumer maps it through a duplicate of @ref fd.
+struct capture_buffer {
+    file_descriptor fd;
+    uchar* data{nullptr};
+    size_t size{0};
+
+    /// Parts of the buffer that are outdated compared to the last frame submitted to the stream.
+    QRegion stale;
+
+    /// Whether the consumer currently reads from the buffer.
+    bool held{false};
+};
+
+/**
+ * Captures the content of an output into a ring of compositor-allocated buffers.
+ *
+ * The scene submits the damage of every painted frame. Only outdated parts of a free buffer are
+ * copied, and frames without damage are not emitted at all. When the consumer holds all buffers
+ * the frame is dropped and its damage is carried over to the next one.
+ */
+class COMO_EXPORT capture_stream : public QObject
+{
+    Q_OBJECT
+public:
+    /// Copies @p rect of the painted frame in buffer coordinates to @p data with @p stride.
+    using copy_function = std::function<void(QRect const& rect, uchar* data, int stride)>;
+
+    capture_stream(base::output const& output, int buffer_count);
+    ~capture_stream() override;
+
+    /**
+     * Submits a painted frame of @p size with @p damage in buffer coordinates. The @p format must
+     * have four bytes per pixel.
+     */
+    void submit(QSize const& size,
+                QImage::Format format,
+                bool y_inverted,
+                QRegion const& damage,
+                copy_function const& copy);
+
+    /// Gives the buffer at @p index back to the stream. Returns false if it is not held.
+    bool release(int index);
+
+    /// The DRM fourcc code matching the memory layout of @ref format or 0 if there is none.
+    uint32_t drm_format() const;
+
+    base::output const& output;
+
+    QSize size;
+    int stride{0};
+    QImage::Format format{QImage::Format_Invalid};
+    bool y_inverted{false};
+
+    std::vector<capture_buffer> buffers;
+    uint64_t sequence{0};
+
+Q_SIGNALS:
+    /// The buffers were reallocated. Previously received buffers must not be used anymore.
+    void buffers_changed();
+    void frame_ready(int index, QRegion const& damage, quint64 sequence);
+
+private:
+    bool allocate_buffers();
+    void clear_buffers();
+
+    int buffer_count;
+    QRegion pending_damage;
+};
+
+}
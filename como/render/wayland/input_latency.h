@@ -0,0 +1,276 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <Wrapland/Server/client.h>
+#include <Wrapland/Server/surface.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace como::render::wayland
+{
+
+enum class input_latency_device {
+    keyboard,
+    pointer,
+    touch,
+};
+
+/**
+ * Histogram of latencies with buckets of powers of two milliseconds. The first bucket holds
+ * latencies below 1 ms, the last one latencies of at least 128 ms.
+ */
+struct latency_histogram {
+    static constexpr size_t bucket_count{9};
+
+    void add(std::chrono::nanoseconds latency)
+    {
+        size_t index = 0;
+        for (auto bound = std::chrono::nanoseconds(std::chrono::milliseconds(1));
+             index < bucket_count - 1 && latency >= bound;
+             bound *= 2) {
+            index++;
+        }
+
+        buckets.at(index)++;
+        count++;
+        sum += latency;
+        max = std::max(max, latency);
+    }
+
+    std::chrono::nanoseconds mean() const
+    {
+        if (!count) {
+            return {};
+        }
+        return sum / static_cast<int64_t>(count);
+    }
+
+    std::array<uint64_t, bucket_count> buckets{};
+    uint64_t count{0};
+    std::chrono::nanoseconds sum{0};
+    std::chrono::nanoseconds max{0};
+};
+
+/**
+ * Measures the latency from an input event on a device to the presentation of the first commit
+ * of the surface the event was sent to.
+ *
+ * Per surface and device only the oldest input without a presented response is measured.
+ * Commits that do not lead to a repaint discard the pending inputs of their surface.
+ */
+class input_latency
+{
+public:
+    input_latency() = default;
+    input_latency(input_latency const&) = delete;
+    input_latency& operator=(input_latency const&) = delete;
+
+    ~input_latency()
+    {
+        for (auto& [surface, pending] : surfaces) {
+            disconnect(pending);
+        }
+    }
+
+    /// Input with the kernel time @p time_msec of @p device was sent to @p surface.
+    void delivered(Wrapland::Server::Surface* surface,
+                   input_latency_device device,
+                   uint32_t time_msec)
+    {
+        auto [it, inserted] = surfaces.try_emplace(surface);
+        if (inserted) {
+            auto& pending = it->second;
+            pending.committed = QObject::connect(
+                surface, &Wrapland::Server::Surface::committed, [&pending] {
+                    for (auto& [device, pending_input] : pending.inputs) {
+                        pending_input.committed = true;
+                    }
+                });
+            pending.destroyed
+                = QObject::connect(surface,
+                                   &Wrapland::Server::Surface::resourceDestroyed,
+                                   [this, surface] { remove_surface(surface); });
+        }
+
+        it->second.inputs.try_emplace(device, input{time_msec, false});
+    }
+
+    /// @p surface is painted on @p output and waits for its presentation.
+    void lock(void const* output, Wrapland::Server::Surface* surface)
+    {
+        auto it = surfaces.find(surface);
+        if (it == surfaces.end()) {
+            return;
+        }
+
+        auto& inputs = it->second.inputs;
+        for (auto input_it = inputs.begin(); input_it != inputs.end();) {
+            if (!input_it->second.committed) {
+                ++input_it;
+                continue;
+            }
+            outputs[output].push_back({input_it->first,
+                                       input_it->second.time_msec,
+                                       surface->client()->executablePath()});
+            input_it = inputs.erase(input_it);
+        }
+
+        if (inputs.empty()) {
+            remove_surface(surface);
+        }
+    }
+
+    /// @p surface committed but is not repainted.
+    void skip(Wrapland::Server::Surface* surface)
+    {
+        auto it = surfaces.find(surface);
+        if (it == surfaces.end()) {
+            return;
+        }
+
+        std::erase_if(it->second.inputs, [](auto const& entry) { return entry.second.committed; });
+        if (it->second.inputs.empty()) {
+            remove_surface(surface);
+        }
+    }
+
+    /// The surfaces locked to @p output were presented at monotonic time @p when.
+    void presented(void const* output, std::chrono::nanoseconds when)
+    {
+        auto it = outputs.find(output);
+        if (it == outputs.end()) {
+            return;
+        }
+
+        auto const when_msec = std::chrono::duration_cast<std::chrono::milliseconds>(when);
+
+        for (auto const& record : it->second) {
+            // Input times are the lower 32 bit of the monotonic clock in milliseconds.
+            auto const age = std::chrono::milliseconds(
+                static_cast<uint32_t>(when_msec.count()) - record.time_msec);
+            if (age > max_latency) {
+                // Not a monotonic time, for example from a fake device.
+                continue;
+            }
+
+            auto const latency = when - when_msec + age;
+            devices[record.device].add(latency);
+            clients[record.client].add(latency);
+        }
+
+        outputs.erase(it);
+    }
+
+    /// The surfaces locked to @p output will not be presented.
+    void discard(void const* output)
+    {
+        outputs.erase(output);
+    }
+
+    /// Whether input still waits for the response of a client or for its presentation.
+    bool is_pending() const
+    {
+        return !surfaces.empty() || !outputs.empty();
+    }
+
+    /// Latencies per device type and per client executable for the support information.
+    QString get_support_info() const
+    {
+        auto to_ms = [](std::chrono::nanoseconds time) {
+            return QString::number(std::chrono::duration<double, std::milli>(time).count(), 'f', 1);
+        };
+        auto print = [&](QString const& name, latency_histogram const& histogram) {
+            auto info = QStringLiteral("%1: count %2, mean %3 ms, max %4 ms\n")
+                            .arg(name)
+                            .arg(histogram.count)
+                            .arg(to_ms(histogram.mean()))
+                            .arg(to_ms(histogram.max));
+            info.append(QStringLiteral("   "));
+            for (size_t index = 0; index < histogram.buckets.size(); ++index) {
+                auto const bound = 1 << std::min(index, histogram.buckets.size() - 2);
+                auto const is_last = index == histogram.buckets.size() - 1;
+                info.append(QStringLiteral(" %1%2 ms: %3")
+                                .arg(is_last ? QStringLiteral(">=") : QStringLiteral("<"))
+                                .arg(bound)
+                                .arg(histogram.buckets.at(index)));
+            }
+            return info + QStringLiteral("\n");
+        };
+
+        QString info;
+        for (auto const& [device, histogram] : devices) {
+            switch (device) {
+            case input_latency_device::keyboard:
+                info.append(print(QStringLiteral("Keyboard"), histogram));
+                break;
+            case input_latency_device::pointer:
+                info.append(print(QStringLiteral("Pointer"), histogram));
+                break;
+            case input_latency_device::touch:
+                info.append(print(QStringLiteral("Touch"), histogram));
+                break;
+            }
+        }
+        for (auto const& [client, histogram] : clients) {
+            info.append(print(QString::fromStdString(client), histogram));
+        }
+        return info;
+    }
+
+    std::map<input_latency_device, latency_histogram> devices;
+    std::map<std::string, latency_histogram> clients;
+
+    static constexpr std::chrono::milliseconds max_latency{10000};
+
+private:
+    struct input {
+        uint32_t time_msec;
+        bool committed;
+    };
+
+    struct pending_surface {
+        std::map<input_latency_device, input> inputs;
+        QMetaObject::Connection committed;
+        QMetaObject::Connection destroyed;
+    };
+
+    struct record {
+        input_latency_device device;
+        uint32_t time_msec;
+        std::string client;
+    };
+
+    static void disconnect(pending_surface& pending)
+    {
+        QObject::disconnect(pending.committed);
+        QObject::disconnect(pending.destroyed);
+    }
+
+    void remove_surface(Wrapland::Server::Surface* surface)
+    {
+        auto it = surfaces.find(surface);
+        if (it == surfaces.end()) {
+            return;
+        }
+
+        disconnect(it->second);
+        surfaces.erase(it);
+    }
+
+    std::unordered_map<Wrapland::Server::Surface*, pending_surface> surfaces;
+    std::unordered_map<void const*, std::vector<record>> outputs;
+};
+
+}
@@ -5,6 +5,7 @@
 */
 #pragma once
 
+#include "buffer_sync.h"
 #include "duration_record.h"
 #include "presentation.h"
 
@@ -15,6 +16,7 @@
 #include <como/render/gl/timer_query.h>
 #include <como/win/remnant.h>
 #include <como/win/space_window_release.h>
+#include <como/win/wayland/scene.h>
 
 #include <como/render/gl/interface/platform.h>
 
@@ -69,6 +71,13 @@ public:
         delay_timer.stop();
         frame_timer.stop();
     }
+
+    /// Whether the output starts a frame soon, either on its timer or after the pending swap.
+    bool is_frame_scheduled() const
+    {
+        return (delay_timer.isActive() || swap_pending) && base.is_dpms_on()
+            && platform.base.session->isActiveSession();
+    }
     void add_repaint(QRegion const& region)
     {
         auto const capped_region = region.intersected(base.geometry());
@@ -178,6 +187,9 @@ public:
 
     void run()
     {
+        // Lets input that was batched since the last frame update the scene first.
+        Q_EMIT platform.qobject->frame_started();
+
         QRegion repaints;
         std::deque<typename space_t::window_t> windows;
 
@@ -344,6 +356,10 @@ private:
 
                            window_it++;
 
+                           if constexpr (requires(decltype(win) win) { win->surface; }) {
+                               check_buffer_ready(*win);
+                           }
+
                            if (prepare_repaint(win)) {
                                has_window_repaints = true;
                            } else {
@@ -439,6 +455,34 @@ private:
         return true;
     }
 
+    template<typename Win>
+    void check_buffer_ready(Win& win)
+    {
+        auto& sync = *platform.buffer_sync;
+
+        // The decision is per surface and not per output, so all outputs latch the same buffer.
+        if (win.surface
+            && (!win.render_data.damage_region.isEmpty() || sync.is_pending(win.surface))) {
+            win.render_data.defer_buffer_update
+                = !sync.check(win.surface, win.qobject.get(), [&win] {
+                      // Latch and paint the buffer once the client's GPU work has finished.
+                      win.render_data.defer_buffer_update = false;
+                      if (!win.remnant && win.surface && !win.geo.size().isEmpty()) {
+                          win::wayland::handle_surface_damage(win, QRect({}, win.geo.size()));
+                      }
+                  });
+        } else {
+            win.render_data.defer_buffer_update = false;
+        }
+
+        // Subsurfaces are not part of the stacking order.
+        for (auto child : win.transient->children) {
+            if (child->transient->annexed) {
+                check_buffer_ready(*child);
+            }
+        }
+    }
+
     void retard_next_run()
     {
         if (platform.scene->hasSwapEvent()) {
@@ -5,6 +5,7 @@
 */
 #pragma once
 
+#include "input_latency.h"
 #include "utils.h"
 
 #include <como/base/wayland/server.h>
@@ -73,6 +74,7 @@ public:
                                // TODO (romangg): Split this up to do on every subsurface (annexed
                                // transient) separately.
                                win->surface->frameRendered(now);
+                               latency.skip(win->surface);
                            }
                        }},
                        win);
@@ -107,6 +109,7 @@ public:
                                // TODO (romangg): Split this up to do on every subsurface (annexed
                                // transient) separately.
                                surface->frameRendered(now);
+                               latency.lock(output, surface);
 
                                auto const id
                                    = surface->lockPresentation(output->base.wrapland_output());
@@ -128,9 +131,12 @@ public:
     {
         if (!output->base.is_enabled()) {
             // Output disabled, discards will be sent from Wrapland.
+            latency.discard(output);
             return;
         }
 
+        latency.presented(output, data.when);
+
         uint32_t tv_sec_hi;
         uint32_t tv_sec_lo;
         uint32_t tv_n_sec;
@@ -152,6 +158,8 @@ public:
         output->assigned_surfaces.clear();
     }
 
+    input_latency latency;
+
 private:
     static std::chrono::milliseconds get_now_in_ms()
     {
@@ -15,6 +15,8 @@
 #include <como/render/post/night_color_manager.h>
 #include <como/render/qpainter/scene.h>
 #include <como/render/singleton_interface.h>
+#include <como/render/wayland/buffer_sync.h>
+#include <como/render/wayland/capture_manager.h>
 #include <como/render/wayland/shadow.h>
 #include <como/render/wayland/xwl_effects.h>
 #include <como/render/x11/compositor_start.h>
@@ -53,12 +55,15 @@ public:
             return std::make_unique<Wrapland::Server::PresentationManager>(
                 base.server->display.get());
         })}
+        , capture{std::make_unique<wayland::capture_manager>()}
+        , buffer_sync{std::make_unique<wayland::buffer_sync>()}
         , dbus{std::make_unique<dbus::compositing<type>>(*this)}
     {
         singleton_interface::get_egl_data = [this] { return egl_data; };
 
         compositor_setup(*this);
         x11::compositor_setup(*this);
+        capture_setup(*this);
 
         dbus->qobject->integration.get_types = [] { return QStringList{"egl"}; };
     }
@@ -306,6 +311,8 @@ public:
     std::unique_ptr<scene_t> scene;
     std::unique_ptr<effects_t> effects;
     std::unique_ptr<wayland::presentation> presentation;
+    std::unique_ptr<wayland::capture_manager> capture;
+    std::unique_ptr<wayland::buffer_sync> buffer_sync;
     std::unique_ptr<cursor<type>> software_cursor;
 
     std::unique_ptr<x11::compositor_selection_owner> selection_owner;
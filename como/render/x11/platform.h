@@ -8,6 +8,7 @@
 #include "buffer.h"
 #include "compositor.h"
 #include "effects.h"
+#include "unredirect.h"
 
 // TODO(romangg): This header should only be included when linking against the debug library. But
 //                then we also need to comment out the calls below.
@@ -27,7 +28,12 @@
 #include <como/render/x11/sync.h>
 
 #include <KConfigGroup>
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace como::render::x11
 {
@@ -103,6 +109,11 @@ public:
         QObject::connect(&m_releaseSelectionTimer, &QTimer::timeout, qobject.get(), [this] {
             releaseCompositorSelection();
         });
+        fullscreen_unredirect.timer.setSingleShot(true);
+        fullscreen_unredirect.timer.setInterval(unredirection::delay);
+        QObject::connect(&fullscreen_unredirect.timer, &QTimer::timeout, qobject.get(), [this] {
+            schedule_repaint();
+        });
         QObject::connect(qobject.get(),
                          &compositor_qobject::aboutToToggleCompositing,
                          qobject.get(),
@@ -171,6 +182,7 @@ public:
                              &base::platform_qobject::output_removed,
                              this->qobject.get(),
                              [this](auto output) {
+                                 output_due.erase(output);
                                  for (auto& win : this->space->windows) {
                                      std::visit(overload{[&](auto&& win) {
                                                     remove_all(win->render_data.repaint_outputs,
@@ -450,19 +462,41 @@ public:
         QRegion repaints;
         std::deque<typename space_t::window_t> windows;
 
+        check_unredirect(*this);
+
         if (!prepare_composition(repaints, windows)) {
             return;
         }
 
+        auto const now_ns = std::chrono::steady_clock::now().time_since_epoch();
+        auto const outputs = get_paint_outputs(repaints, windows, now_ns);
+
+        if (outputs.due.empty()) {
+            // The damaged outputs are not due yet. The timer was started for the next one.
+            return;
+        }
+
+        // Clear the repaints of the due outputs, so that post-pass can add repaints for the next
+        // repaint. Repaints of other outputs are kept for when these are due.
+        QRegion kept_repaints;
+        for (auto output : base.outputs) {
+            if (!contains(outputs.due, output)) {
+                kept_repaints |= this->repaints_region & output->geometry();
+            }
+        }
+        this->repaints_region = kept_repaints;
+
         Perf::Ftrace::begin(QStringLiteral("Paint"), ++s_msc);
         create_opengl_safepoint(opengl_safe_point::pre_frame);
 
         // Start the actual painting process.
         int64_t duration{0};
-        auto const now_ns = std::chrono::steady_clock::now().time_since_epoch();
         auto const now = std::chrono::duration_cast<std::chrono::milliseconds>(now_ns);
 
-        for (auto output : base.outputs) {
+        for (auto output : outputs.repair) {
+            duration += repair_output(*output, windows, now);
+        }
+        for (auto output : outputs.due) {
             // TODO(romangg): Only paint windows that intersect output.
             duration += scene->paint_output(output, repaints & output->geometry(), windows, now);
         }
@@ -517,6 +551,11 @@ public:
     {
         xcb_composite_unredirect_subwindows(
             base.x11_data.connection, base.x11_data.root_window, XCB_COMPOSITE_REDIRECT_MANUAL);
+
+        fullscreen_unredirect.window = XCB_WINDOW_NONE;
+        fullscreen_unredirect.region = {};
+        fullscreen_unredirect.candidate = XCB_WINDOW_NONE;
+        fullscreen_unredirect.timer.stop();
     }
 
     std::unique_ptr<compositor_qobject> qobject;
@@ -532,6 +571,11 @@ public:
     qint64 m_delay{0};
     bool m_bufferSwapPending{false};
 
+    // Per output the time at which it is due to be painted again.
+    std::unordered_map<base::output const*, std::chrono::nanoseconds> output_due;
+
+    unredirection fullscreen_unredirect;
+
     QList<xcb_atom_t> unused_support_properties;
     QTimer unused_support_property_timer;
 
@@ -669,8 +713,7 @@ private:
             discard_lanczos_texture(win);
             win::x11::damage_fetch_region_reply(*win);
             if (win->has_pending_repaints()) {
-                // Add all outputs, since we paint over all in the backend.
-                win->render_data.repaint_outputs = base.outputs;
+                win::acquire_repaint_outputs(*win, win::repaints(*win));
                 has_pending_repaints = true;
             }
         }
@@ -687,11 +730,153 @@ private:
             return false;
         }
 
-        // Clear all repaints, so that post-pass can add repaints for the next repaint
-        this->repaints_region = {};
         return true;
     }
 
+    /// Refresh cycle length of @p output.
+    static std::chrono::nanoseconds get_refresh_length(base::output const& output)
+    {
+        auto const rate = output.refresh_rate() > 0 ? output.refresh_rate() : 60000;
+
+        // The refresh rate is in mHz.
+        return std::chrono::nanoseconds(1000ll * 1000 * 1000 * 1000 / rate);
+    }
+
+    struct paint_outputs {
+        // Outputs with repaints whose refresh cycle has passed since they were painted last.
+        std::vector<base::output*> due;
+
+        // Outputs not due whose part of the reused back buffer is outdated.
+        std::vector<base::output*> repair;
+    };
+
+    /**
+     * Returns the outputs to paint in this frame.
+     *
+     * All outputs are presented at once through the overlay window, so the frames are driven by
+     * the fastest output and slower outputs are only painted in every n-th frame. If no damaged
+     * output is due the composite timer is started for the next one.
+     */
+    paint_outputs get_paint_outputs(QRegion const& repaints,
+                                    std::deque<typename space_t::window_t> const& windows,
+                                    std::chrono::nanoseconds now)
+    {
+        auto has_repaints = [&](auto output) {
+            if (repaints.intersects(output->geometry())) {
+                return true;
+            }
+            return std::any_of(windows.cbegin(), windows.cend(), [output](auto const& win) {
+                return std::visit(overload{[output](auto&& win) {
+                                      return contains(win->render_data.repaint_outputs, output);
+                                  }},
+                                  win);
+            });
+        };
+
+        // Half a cycle of the fastest output. Outputs are painted in the frame closest to when they
+        // are due, so their average rate matches their refresh rate.
+        std::chrono::nanoseconds tolerance{0};
+        for (auto output : base.outputs) {
+            auto const length = get_refresh_length(*output) / 2;
+            tolerance = tolerance.count() ? std::min(tolerance, length) : length;
+        }
+
+        paint_outputs outputs;
+        std::optional<std::chrono::nanoseconds> next_due;
+
+        auto is_unredirected = [this](auto output) {
+            return fullscreen_unredirect.region.contains(output->geometry());
+        };
+
+        for (auto output : base.outputs) {
+            if (is_unredirected(output) || !has_repaints(output)) {
+                continue;
+            }
+
+            auto const due = output_due[output] - tolerance;
+            if (due > now) {
+                next_due = next_due ? std::min(*next_due, due) : due;
+                continue;
+            }
+            outputs.due.push_back(output);
+        }
+
+        if (outputs.due.empty()) {
+            if (next_due) {
+                m_delay = (*next_due - now).count();
+                setCompositeTimer();
+            } else {
+                // Repaints outside of the composited outputs are dropped.
+                this->repaints_region = {};
+            }
+            return outputs;
+        }
+
+        for (auto output : outputs.due) {
+            auto& due = output_due[output];
+            auto const length = get_refresh_length(*output);
+            due = due + length > now ? due + length : now + length;
+        }
+
+        auto backend = get_opengl_backend();
+        if (backend && backend->supportsBufferAge()) {
+            // The back buffer is swapped as a whole. Outputs not due in this frame must still be
+            // repaired from its age.
+            for (auto output : base.outputs) {
+                if (!contains(outputs.due, output) && !is_unredirected(output)
+                    && !backend->get_output_render_region(*output).isEmpty()) {
+                    outputs.repair.push_back(output);
+                }
+            }
+        }
+
+        return outputs;
+    }
+
+    /**
+     * Paints only the region of @p output that the reused back buffer misses. Its pending repaints
+     * are consumed by the scene, so they are restored afterwards for when the output is due.
+     */
+    int64_t repair_output(base::output& output,
+                          std::deque<typename space_t::window_t> const& windows,
+                          std::chrono::milliseconds now)
+    {
+        struct window_repaints {
+            QRegion region;
+            QRegion layer_region;
+            bool on_output;
+        };
+
+        std::vector<window_repaints> pending;
+        pending.reserve(windows.size());
+
+        for (auto const& win : windows) {
+            std::visit(overload{[&](auto&& win) {
+                           auto const& data = win->render_data;
+                           pending.push_back({data.repaints_region,
+                                              data.layer_repaints_region,
+                                              contains(data.repaint_outputs, &output)});
+                       }},
+                       win);
+        }
+
+        auto const duration = scene->paint_output(&output, {}, windows, now);
+
+        for (size_t i = 0; i < windows.size(); i++) {
+            std::visit(overload{[&](auto&& win) {
+                           auto& data = win->render_data;
+                           data.repaints_region |= pending[i].region;
+                           data.layer_repaints_region |= pending[i].layer_region;
+                           if (pending[i].on_output && !contains(data.repaint_outputs, &output)) {
+                               data.repaint_outputs.push_back(&output);
+                           }
+                       }},
+                       windows[i]);
+        }
+
+        return duration;
+    }
+
     void create_opengl_safepoint(opengl_safe_point safepoint)
     {
         if (m_framesToTestForSafety <= 0) {
@@ -0,0 +1,212 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/render/effect/interface/types.h>
+#include <como/win/scene.h>
+#include <como/win/stacking_order.h>
+#include <como/win/x11/scene.h>
+#include <como/win/x11/window_find.h>
+
+#include <QRegion>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <xcb/composite.h>
+
+namespace como::render::x11
+{
+
+/**
+ * The window that is shown without compositing. Only one window at a time is unredirected.
+ *
+ * A window must qualify for some time before it gets unredirected. This way short interruptions,
+ * like a popup or an animation over a fullscreen window, do not let it switch back and forth.
+ */
+struct unredirection {
+    /// Frame of the unredirected window.
+    xcb_window_t window{XCB_WINDOW_NONE};
+
+    /// Area of the unredirected window. It is not painted by the compositor.
+    QRegion region;
+
+    /// Frame of the window that qualifies for unredirection and waits for the timer.
+    xcb_window_t candidate{XCB_WINDOW_NONE};
+    QTimer timer;
+
+    static constexpr std::chrono::milliseconds delay{500};
+};
+
+template<typename Win>
+bool is_unredirect_visible(Win& win)
+{
+    if (!win.render_data.ready_for_painting) {
+        return false;
+    }
+    return win.remnant || (win.isShown() && win::on_current_subspace(win));
+}
+
+template<typename Platform, typename Win>
+bool is_unredirect_qualified(Platform const& platform, Win& win)
+{
+    if (!win.control || win.remnant || !win.render || !win.control->fullscreen) {
+        return false;
+    }
+    if (!win::x11::is_unredirect_allowed(win)) {
+        return false;
+    }
+
+    // The window is shown as is. It must cover its outputs opaquely.
+    if (win.is_shape || win::has_alpha(win) || win.opacity() != 1.0) {
+        return false;
+    }
+
+    auto covers_output = std::any_of(
+        platform.base.outputs.cbegin(), platform.base.outputs.cend(), [&](auto output) {
+            return win.geo.frame.contains(output->geometry());
+        });
+    if (!covers_output) {
+        return false;
+    }
+
+    // Effects animating the window hold one of the grab roles.
+    for (auto role : {WindowAddedGrabRole,
+                      WindowClosedGrabRole,
+                      WindowMinimizedGrabRole,
+                      WindowUnminimizedGrabRole}) {
+        if (win.render->effect->data(role).isValid()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Returns the window that can be shown without compositing. This is the topmost window that is
+ * fullscreen on at least one output and has no other window painted above it.
+ */
+template<typename Platform>
+auto get_unredirect_candidate(Platform& platform) -> typename Platform::x11_ref_window_t*
+{
+    using x11_window_t = typename Platform::x11_ref_window_t;
+
+    if (!platform.effects || platform.effects->activeFullScreenEffect()
+        || platform.effects->blocksDirectScanout()
+        || !platform.effects->elevatedWindows().isEmpty()) {
+        return nullptr;
+    }
+
+    auto const stack = win::render_stack(platform.space->stacking.order);
+    QRegion above;
+
+    for (auto it = stack.crbegin(); it != stack.crend(); ++it) {
+        x11_window_t* candidate{nullptr};
+
+        std::visit(overload{[&](x11_window_t* win) {
+                                if (!is_unredirect_visible(*win)) {
+                                    return;
+                                }
+
+                                auto const geo = win::visible_rect(win);
+                                if (!above.intersects(geo)
+                                    && is_unredirect_qualified(platform, *win)) {
+                                    candidate = win;
+                                }
+                                above |= geo;
+                            },
+                            [&](auto&& win) {
+                                if (is_unredirect_visible(*win)) {
+                                    above |= win::visible_rect(win);
+                                }
+                            }},
+                   *it);
+
+        if (candidate) {
+            return candidate;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename Platform>
+void redirect_unredirected(Platform& platform)
+{
+    using x11_window_t = typename Platform::x11_ref_window_t;
+
+    auto& state = platform.fullscreen_unredirect;
+    if (state.window == XCB_WINDOW_NONE) {
+        return;
+    }
+
+    // The frame is gone when the window was closed meanwhile.
+    if (auto win = win::x11::find_controlled_window<x11_window_t>(
+            *platform.space, win::x11::predicate_match::frame_id, state.window)) {
+        xcb_composite_redirect_window(
+            platform.base.x11_data.connection, state.window, XCB_COMPOSITE_REDIRECT_MANUAL);
+        win::discard_buffer(*win);
+        win::add_full_repaint(*win);
+    }
+
+    if (platform.overlay_window) {
+        platform.overlay_window->setShape(QRect({}, platform.base.topology.size));
+    }
+
+    auto const region = state.region;
+    state.window = XCB_WINDOW_NONE;
+    state.region = {};
+
+    platform.addRepaint(region);
+}
+
+/**
+ * Checks which window is shown without compositing. Windows are redirected again immediately when
+ * they do not qualify anymore but only unredirected after they qualified for some time.
+ */
+template<typename Platform>
+void check_unredirect(Platform& platform)
+{
+    auto& state = platform.fullscreen_unredirect;
+
+    auto candidate = get_unredirect_candidate(platform);
+    auto const frame = candidate ? candidate->frameId() : XCB_WINDOW_NONE;
+
+    if (state.window != frame) {
+        redirect_unredirected(platform);
+    }
+
+    if (frame == XCB_WINDOW_NONE) {
+        state.candidate = XCB_WINDOW_NONE;
+        state.timer.stop();
+        return;
+    }
+    if (frame == state.window) {
+        return;
+    }
+    if (frame != state.candidate) {
+        state.candidate = frame;
+        state.timer.start();
+        return;
+    }
+    if (state.timer.isActive()) {
+        return;
+    }
+
+    xcb_composite_unredirect_window(
+        platform.base.x11_data.connection, frame, XCB_COMPOSITE_REDIRECT_MANUAL);
+
+    state.window = frame;
+    state.region = candidate->geo.frame;
+    state.candidate = XCB_WINDOW_NONE;
+
+    if (platform.overlay_window) {
+        platform.overlay_window->setShape(QRegion(QRect({}, platform.base.topology.size))
+                                          - state.region);
+    }
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QSize>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace como::scripting
+{
+
+inline int64_t get_thumbnail_area(QSize const& size)
+{
+    return static_cast<int64_t>(size.width()) * size.height();
+}
+
+/// Pixels of thumbnails rendered per frame. Defaults to the area of a 4K output and can be set
+/// through COMO_THUMBNAIL_PIXEL_BUDGET.
+inline int64_t get_thumbnail_pixel_budget()
+{
+    auto const env = qEnvironmentVariableIntValue("COMO_THUMBNAIL_PIXEL_BUDGET");
+    return env > 0 ? static_cast<int64_t>(env) : get_thumbnail_area({3840, 2160});
+}
+
+inline int get_thumbnail_mipmap_levels(QSize const& size)
+{
+    return std::floor(std::log2(std::max({size.width(), size.height(), 1}))) + 1;
+}
+
+template<typename Source>
+struct thumbnail_update_schedule {
+    /// Sources to update in this frame, in order.
+    std::vector<Source*> updated;
+    /// Outdated sources that wait for a later frame.
+    std::vector<Source*> deferred;
+};
+
+/**
+ * Picks the outdated sources to update in a frame until the budget of pixels is used up. Visible
+ * sources go first, then the ones that waited longest and then small ones. That way a large grid
+ * of thumbnails is updated round-robin instead of rendering all of them in a single frame.
+ *
+ * At least one source is updated per frame, even if it exceeds the budget alone. The skipped
+ * frames of each source are counted up when it is deferred and reset when it is updated.
+ */
+template<typename Source>
+thumbnail_update_schedule<Source> schedule_thumbnail_updates(std::vector<Source*> const& sources,
+                                                             int64_t budget)
+{
+    thumbnail_update_schedule<Source> schedule;
+
+    std::vector<Source*> pending;
+    std::copy_if(sources.cbegin(),
+                 sources.cend(),
+                 std::back_inserter(pending),
+                 [](auto source) { return source->needs_update(); });
+
+    std::stable_sort(pending.begin(), pending.end(), [](auto lhs, auto rhs) {
+        if (lhs->is_visible() != rhs->is_visible()) {
+            return lhs->is_visible();
+        }
+        if (lhs->skipped_frames != rhs->skipped_frames) {
+            return lhs->skipped_frames > rhs->skipped_frames;
+        }
+        return get_thumbnail_area(lhs->texture_size()) < get_thumbnail_area(rhs->texture_size());
+    });
+
+    auto remaining = budget;
+
+    for (auto source : pending) {
+        auto const cost = get_thumbnail_area(source->texture_size());
+
+        if (cost > remaining && remaining < budget) {
+            source->skipped_frames++;
+            schedule.deferred.push_back(source);
+            continue;
+        }
+
+        remaining -= cost;
+        source->skipped_frames = 0;
+        schedule.updated.push_back(source);
+    }
+
+    return schedule;
+}
+
+}
@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include "scripting_logging.h"
 #include "singleton_interface.h"
 #include "space.h"
+#include "thumbnail_update_schedule.h"
 
 #include <como/render/compositor_qobject.h>
 #include <como/render/singleton_interface.h>
@@ -23,6 +24,8 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <QRunnable>
 #include <QSGImageNode>
 #include <QSGTextureProvider>
+#include <algorithm>
+#include <cmath>
 
 namespace como::scripting
 {
@@ -36,6 +39,69 @@ bool use_gl_thumbnails()
               .contains(QQuickWindow::sceneGraphBackend());
     return effects && effects->isOpenGLCompositing() && !qt_quick_is_software;
 }
+
+/// Distributes thumbnail updates over frames, see schedule_thumbnail_updates.
+class thumbnail_update_scheduler
+{
+public:
+    static thumbnail_update_scheduler& instance()
+    {
+        static thumbnail_update_scheduler scheduler;
+        return scheduler;
+    }
+
+    void add(window_thumbnail_source* source)
+    {
+        sources.push_back(source);
+
+        if (connected_effects != effects) {
+            QObject::disconnect(connection);
+            connection = QObject::connect(effects,
+                                          &EffectsHandler::frameRendered,
+                                          effects,
+                                          [this](auto& data) { update(data); });
+            connected_effects = effects;
+        }
+    }
+
+    void remove(window_thumbnail_source* source)
+    {
+        std::erase(sources, source);
+
+        if (sources.empty()) {
+            QObject::disconnect(connection);
+            connected_effects = nullptr;
+        }
+    }
+
+private:
+    void update(effect::screen_paint_data& data)
+    {
+        static int64_t const budget = get_thumbnail_pixel_budget();
+        auto const schedule = schedule_thumbnail_updates(sources, budget);
+
+        for (auto source : schedule.updated) {
+            source->update(data);
+        }
+
+        QRegion deferred;
+        for (auto source : schedule.deferred) {
+            if (auto view = source->view(); view && source->is_visible()) {
+                deferred |= view->geometry();
+            }
+        }
+
+        if (!deferred.isEmpty()) {
+            // Visible thumbnails still outdated are updated in the next frame.
+            effects->addRepaint(deferred);
+        }
+    }
+
+    std::vector<window_thumbnail_source*> sources;
+    QPointer<EffectsHandler> connected_effects;
+    QMetaObject::Connection connection;
+};
+
 }
 
 window_thumbnail_source::window_thumbnail_source(QQuickWindow* view,
@@ -45,20 +111,19 @@ window_thumbnail_source::window_thumbnail_source(QQuickWindow* view,
     , m_handle(handle)
     , wId{wId}
 {
-    connect(handle, &scripting::window::frameGeometryChanged, this, [this]() {
-        m_dirty = true;
-        Q_EMIT changed();
-    });
-    connect(handle, &scripting::window::damaged, this, [this]() {
-        m_dirty = true;
-        Q_EMIT changed();
-    });
+    connect(handle,
+            &scripting::window::frameGeometryChanged,
+            this,
+            &window_thumbnail_source::mark_dirty);
+    connect(handle, &scripting::window::damaged, this, &window_thumbnail_source::mark_dirty);
 
-    connect(effects, &EffectsHandler::frameRendered, this, &window_thumbnail_source::update);
+    thumbnail_update_scheduler::instance().add(this);
 }
 
 window_thumbnail_source::~window_thumbnail_source()
 {
+    thumbnail_update_scheduler::instance().remove(this);
+
     if (!m_offscreenTexture) {
         return;
     }
@@ -104,20 +169,100 @@ window_thumbnail_source::Frame window_thumbnail_source::acquire()
     };
 }
 
+void window_thumbnail_source::set_item_request(window_thumbnail_item const* item,
+                                               item_request const& request)
+{
+    auto const old_size = texture_size();
+    auto const old_mipmap = std::any_of(m_item_requests.cbegin(),
+                                        m_item_requests.cend(),
+                                        [](auto const& entry) { return entry.second.mipmap; });
+
+    m_item_requests[item] = request;
+
+    if (texture_size() != old_size || (request.mipmap && !old_mipmap)) {
+        mark_dirty();
+    }
+}
+
+void window_thumbnail_source::remove_item_request(window_thumbnail_item const* item)
+{
+    m_item_requests.erase(item);
+}
+
+bool window_thumbnail_source::needs_update() const
+{
+    return !m_acquireFence && m_dirty && m_handle;
+}
+
+bool window_thumbnail_source::is_visible() const
+{
+    return std::any_of(m_item_requests.cbegin(), m_item_requests.cend(), [](auto const& entry) {
+        return entry.second.visible;
+    });
+}
+
+QSize window_thumbnail_source::texture_size() const
+{
+    if (!m_handle || !m_view) {
+        return {};
+    }
+
+    auto const full_size = (m_view->devicePixelRatio() * m_handle->visibleRect().size()).toSize();
+
+    QSize requested;
+    for (auto const& [item, request] : m_item_requests) {
+        requested = requested.expandedTo(request.size);
+    }
+    if (requested.isEmpty() || full_size.isEmpty()) {
+        return full_size;
+    }
+
+    // The window is scaled uniformly to cover the request. The scale is rounded up in steps of 64
+    // pixels on the longer edge, so that animated thumbnails do not reallocate their texture on
+    // every frame.
+    auto const scale = std::max(requested.width() / static_cast<double>(full_size.width()),
+                                requested.height() / static_cast<double>(full_size.height()));
+    auto const step = 64. / std::max(full_size.width(), full_size.height());
+    auto const rounded_scale = std::min(1., std::ceil(scale / step) * step);
+
+    return (QSizeF(full_size) * rounded_scale).toSize().expandedTo(QSize(1, 1));
+}
+
+QPointer<QQuickWindow> window_thumbnail_source::view() const
+{
+    return m_view;
+}
+
+void window_thumbnail_source::mark_dirty()
+{
+    m_dirty = true;
+    Q_EMIT changed();
+}
+
 void window_thumbnail_source::update(effect::screen_paint_data& data)
 {
-    if (m_acquireFence || !m_dirty || !m_handle) {
+    if (!needs_update()) {
         return;
     }
     Q_ASSERT(m_view);
 
     auto const geometry = m_handle->visibleRect();
-    auto const dpi = m_view->devicePixelRatio();
-    auto const textureSize = dpi * geometry.size();
+    auto const textureSize = texture_size();
+    if (textureSize.isEmpty()) {
+        return;
+    }
 
-    if (!m_offscreenTexture || m_offscreenTexture->size() != textureSize) {
-        m_offscreenTexture.reset(new GLTexture(GL_RGBA8, textureSize));
-        m_offscreenTexture->setFilter(GL_LINEAR);
+    auto const mipmap = std::any_of(m_item_requests.cbegin(),
+                                    m_item_requests.cend(),
+                                    [](auto const& entry) { return entry.second.mipmap; });
+    auto const filter = mipmap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+
+    if (!m_offscreenTexture || m_offscreenTexture->size() != textureSize
+        || m_offscreenTexture->filter() != static_cast<GLenum>(filter)) {
+        // The window is rendered at the size it is displayed, not at its own size.
+        m_offscreenTexture.reset(new GLTexture(
+            GL_RGBA8, textureSize, mipmap ? get_thumbnail_mipmap_levels(textureSize) : 1));
+        m_offscreenTexture->setFilter(filter);
         m_offscreenTexture->setWrapMode(GL_CLAMP_TO_EDGE);
         m_offscreenTarget.reset(new GLFramebuffer(m_offscreenTexture.get()));
     }
@@ -130,8 +275,9 @@ void window_thumbnail_source::update(effect::screen_paint_data& data)
                -1,
                1);
 
+    // The framebuffer's viewport spans the texture, which already has the device pixel ratio
+    // applied through its size. So the view alone maps the window onto it.
     QMatrix4x4 proj;
-    proj.scale(dpi);
 
     auto effectWindow = effects->findWindow(wId);
 
@@ -159,6 +305,12 @@ void window_thumbnail_source::update(effect::screen_paint_data& data)
     effects->drawWindow(win_data);
     render::pop_framebuffer(win_data.render);
 
+    if (mipmap) {
+        m_offscreenTexture->bind();
+        m_offscreenTexture->generateMipmaps();
+        m_offscreenTexture->unbind();
+    }
+
     // The fence is needed to avoid the case where qtquick renderer starts using
     // the texture while all rendering commands to it haven't completed yet.
     m_dirty = false;
@@ -196,10 +348,17 @@ void ThumbnailTextureProvider::setTexture(std::shared_ptr<GLTexture> const& nati
 {
     if (m_nativeTexture != nativeTexture) {
         auto const textureId = nativeTexture->texture();
+        auto const has_mipmaps = nativeTexture->filter() == GL_LINEAR_MIPMAP_LINEAR;
+        auto options = QQuickWindow::CreateTextureOptions(QQuickWindow::TextureHasAlphaChannel);
+        if (has_mipmaps) {
+            options |= QQuickWindow::TextureHasMipmaps;
+        }
+
         m_nativeTexture = nativeTexture;
         m_texture.reset(QNativeInterface::QSGOpenGLTexture::fromNative(
-            textureId, m_window, nativeTexture->size(), QQuickWindow::TextureHasAlphaChannel));
+            textureId, m_window, nativeTexture->size(), options));
         m_texture->setFiltering(QSGTexture::Linear);
+        m_texture->setMipmapFiltering(has_mipmaps ? QSGTexture::Linear : QSGTexture::None);
         m_texture->setHorizontalWrapMode(QSGTexture::ClampToEdge);
         m_texture->setVerticalWrapMode(QSGTexture::ClampToEdge);
     }
@@ -246,10 +405,19 @@ window_thumbnail_item::window_thumbnail_item(QQuickItem* parent)
             this,
             &window_thumbnail_item::update_source);
     connect(this, &QQuickItem::windowChanged, this, &window_thumbnail_item::update_source);
+
+    connect(this, &QQuickItem::widthChanged, this, &window_thumbnail_item::update_source_request);
+    connect(this, &QQuickItem::heightChanged, this, &window_thumbnail_item::update_source_request);
+    connect(this, &QQuickItem::visibleChanged, this, &window_thumbnail_item::update_source_request);
+    connect(this, &QQuickItem::opacityChanged, this, &window_thumbnail_item::update_source_request);
 }
 
 window_thumbnail_item::~window_thumbnail_item()
 {
+    if (m_source) {
+        m_source->remove_item_request(this);
+    }
+
     if (m_provider) {
         if (window()) {
             window()->scheduleRenderJob(new ThumbnailTextureProviderCleanupJob(m_provider),
@@ -288,22 +456,50 @@ QSGTextureProvider* window_thumbnail_item::textureProvider() const
 
 void window_thumbnail_item::reset_source()
 {
+    if (m_source) {
+        disconnect(m_source.get(), nullptr, this, nullptr);
+        m_source->remove_item_request(this);
+    }
     m_source.reset();
 }
 
 void window_thumbnail_item::update_source()
 {
+    std::shared_ptr<window_thumbnail_source> source;
     if (use_gl_thumbnails() && window() && m_client) {
-        m_source = window_thumbnail_source::getOrCreate(window(), m_client, m_wId);
+        source = window_thumbnail_source::getOrCreate(window(), m_client, m_wId);
+    }
+    if (source == m_source) {
+        return;
+    }
+
+    reset_source();
+    m_source = source;
+
+    if (m_source) {
         connect(m_source.get(),
                 &window_thumbnail_source::changed,
                 this,
                 &window_thumbnail_item::update);
-    } else {
-        m_source.reset();
+        update_source_request();
     }
 }
 
+void window_thumbnail_item::update_source_request()
+{
+    if (!m_source || !window()) {
+        return;
+    }
+
+    auto const size = paintedRect().size() * window()->devicePixelRatio();
+    m_source->set_item_request(this,
+                               {
+                                   .size = QSize(std::ceil(size.width()), std::ceil(size.height())),
+                                   .mipmap = m_mipmap,
+                                   .visible = isVisible() && opacity() > 0,
+                               });
+}
+
 QSGNode* window_thumbnail_item::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData*)
 {
     if (effects) {
@@ -340,6 +536,7 @@ QSGNode* window_thumbnail_item::updatePaintNode(QSGNode* oldNode, QQuickItem::Up
         node = window()->createImageNode();
         node->setFiltering(QSGTexture::Linear);
     }
+    node->setMipmapFiltering(m_provider->texture()->mipmapFiltering());
     node->setTexture(m_provider->texture());
     node->setTextureCoordinatesTransform(QSGImageNode::NoTransform);
     node->setRect(paintedRect());
@@ -387,6 +584,21 @@ scripting::window* window_thumbnail_item::client() const
     return m_client;
 }
 
+bool window_thumbnail_item::mipmap() const
+{
+    return m_mipmap;
+}
+
+void window_thumbnail_item::setMipmap(bool mipmap)
+{
+    if (m_mipmap == mipmap) {
+        return;
+    }
+    m_mipmap = mipmap;
+    update_source_request();
+    Q_EMIT mipmapChanged();
+}
+
 void window_thumbnail_item::setClient(scripting::window* client)
 {
     if (m_client == client) {
@@ -420,6 +632,9 @@ void window_thumbnail_item::updateImplicitSize()
         frameSize = m_client->frameGeometry().size();
     }
     setImplicitSize(frameSize.width(), frameSize.height());
+
+    // The painted size changes with the window's aspect ratio too.
+    update_source_request();
 }
 
 QImage window_thumbnail_item::fallbackImage() const
@@ -12,6 +12,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <QQuickItem>
 #include <QUuid>
+#include <map>
 
 #include <epoxy/gl.h>
 
@@ -25,6 +26,7 @@ namespace scripting
 {
 
 class ThumbnailTextureProvider;
+class window_thumbnail_item;
 
 class window_thumbnail_source : public QObject
 {
@@ -44,11 +46,32 @@ public:
 
     Frame acquire();
 
+    /// How an item displays the thumbnail. The texture is rendered at the largest requested size.
+    struct item_request {
+        QSize size;
+        bool mipmap{false};
+        bool visible{false};
+    };
+
+    void set_item_request(window_thumbnail_item const* item, item_request const& request);
+    void remove_item_request(window_thumbnail_item const* item);
+
+    /// Whether the texture is outdated and can be rendered again.
+    bool needs_update() const;
+    bool is_visible() const;
+    QSize texture_size() const;
+    QPointer<QQuickWindow> view() const;
+
+    void update(como::effect::screen_paint_data& data);
+
+    /// Frames the source waited for an update because the per-frame budget was exhausted.
+    int skipped_frames{0};
+
 Q_SIGNALS:
     void changed();
 
 private:
-    void update(como::effect::screen_paint_data& data);
+    void mark_dirty();
 
     QPointer<QQuickWindow> m_view;
     QPointer<scripting::window> m_handle;
@@ -58,6 +81,8 @@ private:
     GLsync m_acquireFence{nullptr};
     bool m_dirty = true;
     QUuid wId;
+
+    std::map<window_thumbnail_item const*, item_request> m_item_requests;
 };
 
 class COMO_EXPORT window_thumbnail_item : public QQuickItem
@@ -65,6 +90,11 @@ class COMO_EXPORT window_thumbnail_item : public QQuickItem
     Q_OBJECT
     Q_PROPERTY(QUuid wId READ wId WRITE setWId NOTIFY wIdChanged)
     Q_PROPERTY(como::scripting::window* client READ client WRITE setClient NOTIFY clientChanged)
+    /**
+     * Whether the thumbnail texture gets mipmaps, so it is sampled smoothly when the item is
+     * scaled down further, for example in an animation. Defaults to false.
+     */
+    Q_PROPERTY(bool mipmap READ mipmap WRITE setMipmap NOTIFY mipmapChanged)
 
 public:
     explicit window_thumbnail_item(QQuickItem* parent = nullptr);
@@ -76,6 +106,9 @@ public:
     scripting::window* client() const;
     void setClient(scripting::window* window);
 
+    bool mipmap() const;
+    void setMipmap(bool mipmap);
+
     QSGTextureProvider* textureProvider() const override;
     bool isTextureProvider() const override;
     QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData*) override;
@@ -86,6 +119,7 @@ protected:
 Q_SIGNALS:
     void wIdChanged();
     void clientChanged();
+    void mipmapChanged();
 
 private:
     QImage fallbackImage() const;
@@ -93,9 +127,11 @@ private:
     void updateImplicitSize();
     void update_source();
     void reset_source();
+    void update_source_request();
 
     QUuid m_wId;
     QPointer<scripting::window> m_client;
+    bool m_mipmap{false};
 
     mutable ThumbnailTextureProvider* m_provider = nullptr;
     std::shared_ptr<window_thumbnail_source> m_source;
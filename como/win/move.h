@@ -69,6 +69,7 @@ void unset_move_resize_window(Space& space)
 {
     space.move_resize_window = {};
     --space.block_focus;
+    Q_EMIT space.qobject->move_resize_window_changed();
 }
 
 template<typename Space, typename Win>
@@ -78,6 +79,7 @@ void set_move_resize_window(Space& space, Win& window)
     assert(!space.move_resize_window);
     space.move_resize_window = &window;
     ++space.block_focus;
+    Q_EMIT space.qobject->move_resize_window_changed();
 }
 
 template<typename Win>
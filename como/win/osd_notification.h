@@ -35,7 +35,7 @@ public:
     using abstract_type = typename Input::event_spy_t;
 
     explicit osd_notification_input_spy(Osd& osd)
-        : abstract_type(osd.input)
+        : abstract_type(osd.input, abstract_type::event_interest_t::motion)
         , osd{osd}
     {
     }
@@ -223,7 +223,7 @@ private:
         }
 
         m_spy = std::make_unique<input_spy>(*this);
-        input.m_spies.push_back(m_spy.get());
+        input.install_spy(m_spy.get());
 
         if (!m_animation) {
             m_animation = new QPropertyAnimation(win, "opacity", qobject.get());
@@ -136,6 +136,8 @@ void ruling::readFromSettings(rules::settings const* settings)
     if (type.data == win_type::unknown) {
         type.rule = force_rule::unused;
     }
+
+    unredirect = read_force_rule(settings->unredirect(), settings->unredirectrule());
 }
 
 void ruling::write(rules::settings* settings) const
@@ -233,6 +235,7 @@ void ruling::write(rules::settings* settings) const
                         &settings::setTyperule,
                         &settings::setType,
                         [](auto const& value) -> int { return static_cast<int>(value); });
+    write_force(unredirect, &settings::setUnredirectrule, &settings::setUnredirect);
 }
 
 // returns true if it doesn't affect anything
@@ -252,7 +255,7 @@ bool ruling::isEmpty() const
         && unused_f(autogroupid.rule) && unused_f(strictgeometry.rule) && unused_s(shortcut.rule)
         && unused_f(disableglobalshortcuts.rule) && unused_f(minsize.rule) && unused_f(maxsize.rule)
         && unused_f(opacityactive.rule) && unused_f(opacityinactive.rule)
-        && unused_f(placement.rule) && unused_f(type.rule);
+        && unused_f(placement.rule) && unused_f(type.rule) && unused_f(unredirect.rule);
 }
 
 force_rule ruling::convertForceRule(int v)
@@ -539,6 +542,11 @@ bool ruling::applyBlockCompositing(bool& block) const
     return apply_force(block, this->blockcompositing);
 }
 
+bool ruling::applyUnredirect(bool& unredirect) const
+{
+    return apply_force(unredirect, this->unredirect);
+}
+
 template<typename T>
 bool ruling::apply_force_enum(force_ruler<int> const& ruler, T& apply, T min, T max) const
 {
@@ -680,6 +688,7 @@ bool ruling::discardUsed(bool withdrawn)
     discard_used_force(placement);
     discard_used_force(strictgeometry);
     discard_used_force(type);
+    discard_used_force(unredirect);
 
     return changed;
 }
@@ -83,6 +83,7 @@ public:
     bool applyNoBorder(bool& noborder, bool init) const;
     bool applyDecoColor(QString& schemeFile) const;
     bool applyBlockCompositing(bool& block) const;
+    bool applyUnredirect(bool& unredirect) const;
     bool applyFSP(win::fsp_level& fsp) const;
     bool applyFPP(win::fsp_level& fpp) const;
     bool applyAcceptFocus(bool& focus) const;
@@ -183,6 +184,7 @@ public:
     force_ruler<int> placement;
     force_ruler<bool> strictgeometry;
     force_ruler<win_type> type;
+    force_ruler<bool> unredirect;
 
     friend QDebug& operator<<(QDebug& stream, ruling const*);
 };
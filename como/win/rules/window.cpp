@@ -164,6 +164,11 @@ bool window::checkBlockCompositing(bool block) const
     return check_force(block, &ruling::applyBlockCompositing);
 }
 
+bool window::checkUnredirect(bool unredirect) const
+{
+    return check_force(unredirect, &ruling::applyUnredirect);
+}
+
 fsp_level window::checkFSP(fsp_level fsp) const
 {
     return check_force(fsp, &ruling::applyFSP);
@@ -95,6 +95,7 @@ public:
     bool checkNoBorder(bool noborder, bool init = false) const;
     QString checkDecoColor(QString schemeFile) const;
     bool checkBlockCompositing(bool block) const;
+    bool checkUnredirect(bool unredirect) const;
     fsp_level checkFSP(fsp_level fsp) const;
     fsp_level checkFPP(fsp_level fpp) const;
     bool checkAcceptFocus(bool focus) const;
@@ -42,6 +42,7 @@ Q_SIGNALS:
     void remnant_created(quint32 remnant);
 
     void clientActivated();
+    void move_resize_window_changed();
     void clientMinimizedChanged(quint32);
     void unmanagedAdded(quint32);
     void unmanagedRemoved(quint32);
@@ -43,6 +43,10 @@ void update_buffer(Win& win, std::shared_ptr<Wrapland::Server::Buffer>& target)
     if (target.get() == buffer.get()) {
         return;
     }
+    if (target && win.render_data.defer_buffer_update) {
+        // Continue to show the previous buffer until the client's GPU work has finished.
+        return;
+    }
 
     target = buffer;
 }
@@ -25,6 +25,7 @@
 #include <como/win/x11/desktop_space.h>
 #include <como/win/x11/netinfo_helpers.h>
 #include <como/win/x11/space_areas.h>
+#include <como/win/x11/window_index.h>
 
 #include <memory>
 
@@ -270,6 +271,7 @@ public:
 
     std::vector<window_t> windows;
     std::unordered_map<uint32_t, window_t> windows_map;
+    win::x11::window_index<x11_window> x11_window_index;
     std::vector<win::x11::group<type>*> groups;
 
     stacking_state<window_t> stacking;
@@ -29,6 +29,9 @@ struct window_render_data {
     int bit_depth{24};
     bool ready_for_painting{false};
     bool is_damaged{false};
+
+    // The latest committed buffer is still being rendered to by the client. Keep the previous one.
+    bool defer_buffer_update{false};
 };
 
 }
@@ -180,23 +180,26 @@ inline bool wants_sync_counter(base::operation_mode mode, base::x11::data const&
 }
 
 template<typename Win>
-void get_sync_counter(Win* win)
+base::x11::xcb::property fetch_sync_counter(Win* win)
 {
-    if (!base::x11::xcb::extensions::self()->is_sync_available()) {
-        return;
-    }
-    if (!wants_sync_counter(win->space.base.operation_mode, win->space.base.x11_data)) {
-        return;
+    if (!base::x11::xcb::extensions::self()->is_sync_available()
+        || !wants_sync_counter(win->space.base.operation_mode, win->space.base.x11_data)) {
+        return base::x11::xcb::property(win->space.base.x11_data.connection);
     }
 
-    base::x11::xcb::property syncProp(win->space.base.x11_data.connection,
-                                      false,
-                                      win->xcb_windows.client,
-                                      win->space.atoms->net_wm_sync_request_counter,
-                                      XCB_ATOM_CARDINAL,
-                                      0,
-                                      1);
-    auto const counter = syncProp.value<xcb_sync_counter_t>(XCB_NONE);
+    return base::x11::xcb::property(win->space.base.x11_data.connection,
+                                    false,
+                                    win->xcb_windows.client,
+                                    win->space.atoms->net_wm_sync_request_counter,
+                                    XCB_ATOM_CARDINAL,
+                                    0,
+                                    1);
+}
+
+template<typename Win>
+void read_sync_counter(Win* win, base::x11::xcb::property& prop)
+{
+    auto const counter = prop.value<xcb_sync_counter_t>(XCB_NONE);
 
     if (counter == XCB_NONE) {
         // Window without support for _NET_WM_SYNC_REQUEST.
@@ -238,6 +241,14 @@ void get_sync_counter(Win* win)
     xcb_sync_change_alarm_aux(con, alarm_id, XCB_SYNC_CA_DELTA | XCB_SYNC_CA_VALUE, &value);
 
     win->sync_request.alarm = alarm_id;
+    win->space.x11_window_index.add_sync_alarm(alarm_id, win);
+}
+
+template<typename Win>
+void get_sync_counter(Win* win)
+{
+    auto prop = fetch_sync_counter(win);
+    read_sync_counter(win, prop);
 }
 
 /**
@@ -56,6 +56,11 @@ class COMO_EXPORT client_machine : public QObject
     Q_OBJECT
 public:
     void resolve(base::x11::data const& x11_data, xcb_window_t window, xcb_window_t clientLeader);
+    /// Resolves with the WM_CLIENT_MACHINE property of the window fetched in advance.
+    void resolve(base::x11::data const& x11_data,
+                 xcb_window_t window,
+                 xcb_window_t clientLeader,
+                 QByteArray const& window_machine);
     QByteArray const& hostname() const;
     bool is_local() const;
     static QByteArray localhost();
@@ -120,6 +120,8 @@ public:
             control_t::destroy_decoration();
             move(m_window, grav);
         }
+        m_window->space.x11_window_index.remove(predicate_match::input_id,
+                                                m_window->xcb_windows.input);
         m_window->xcb_windows.input.reset();
     }
 
@@ -117,17 +117,48 @@ void embed_client(Win* win, xcb_visualid_t visualid, xcb_colormap_t colormap, ui
     win->control->update_mouse_grab();
 }
 
+/**
+ * Requests for the properties of a window that are read when it starts being managed. All of them
+ * are issued at once before the first reply is awaited. The replies then arrive together with the
+ * ones of the NETWM properties and setting up the window does not wait for each of them in turn.
+ */
 template<typename Win>
-void prepare_decoration(Win* win)
-{
-    auto colorSchemeCookie = fetch_color_scheme(win);
-    auto applicationMenuServiceNameCookie = fetch_application_menu_service_name(win);
-    auto applicationMenuObjectPathCookie = fetch_application_menu_object_path(win);
+struct control_create_cookies {
+    explicit control_create_cookies(Win& win)
+        : wm_client_leader{fetch_wm_client_leader(win)}
+        , skip_close_animation{fetch_skip_close_animation(win)}
+        , show_on_screen_edge{fetch_show_on_screen_edge(&win)}
+        , transient{fetch_transient(&win)}
+        , sync_counter{fetch_sync_counter(&win)}
+        , wm_name{fetch_name_property(win, XCB_ATOM_WM_NAME)}
+        , wm_icon_name{fetch_name_property(win, XCB_ATOM_WM_ICON_NAME)}
+        , shape{fetch_shape(win)}
+        , color_scheme{fetch_color_scheme(&win)}
+        , application_menu_service_name{fetch_application_menu_service_name(&win)}
+        , application_menu_object_path{fetch_application_menu_object_path(&win)}
+    {
+    }
+
+    base::x11::xcb::property wm_client_leader;
+    base::x11::xcb::property skip_close_animation;
+    base::x11::xcb::property show_on_screen_edge;
+    base::x11::xcb::transient_for transient;
+    base::x11::xcb::property sync_counter;
+    base::x11::xcb::property wm_name;
+    base::x11::xcb::property wm_icon_name;
+    base::x11::xcb::shape_extents shape;
+    base::x11::xcb::string_property color_scheme;
+    base::x11::xcb::string_property application_menu_service_name;
+    base::x11::xcb::string_property application_menu_object_path;
+};
 
-    read_color_scheme(win, colorSchemeCookie);
+template<typename Win>
+void prepare_decoration(Win* win, control_create_cookies<Win>& cookies)
+{
+    read_color_scheme(win, cookies.color_scheme);
 
-    read_application_menu_service_name(win, applicationMenuServiceNameCookie);
-    read_application_menu_object_path(win, applicationMenuObjectPathCookie);
+    read_application_menu_service_name(win, cookies.application_menu_service_name);
+    read_application_menu_object_path(win, cookies.application_menu_object_path);
 
     // Also gravitates
     win->updateDecoration(false);
@@ -241,7 +272,9 @@ void control_create_set_subspaces(Win& win,
 }
 
 template<typename Win>
-bool init_controlled_window_from_session(Win& win, bool isMapped)
+bool init_controlled_window_from_session(Win& win,
+                                         bool isMapped,
+                                         control_create_cookies<Win>& cookies)
 {
     auto session = take_session_info(win.space, &win);
     if (!session) {
@@ -276,7 +309,7 @@ bool init_controlled_window_from_session(Win& win, bool isMapped)
     win.geo.client_frame_extents = gtk_frame_extents(&win);
     win.geo.update.original.client_frame_extents = win.geo.client_frame_extents;
 
-    prepare_decoration(&win);
+    prepare_decoration(&win, cookies);
 
     // Set size before placement.
     win.geo.frame = session->geometry;
@@ -407,7 +440,10 @@ bool init_controlled_window_from_session(Win& win, bool isMapped)
 }
 
 template<typename Win>
-void init_controlled_window(Win& win, bool isMapped, QRect const& client_geo)
+void init_controlled_window(Win& win,
+                            bool isMapped,
+                            QRect const& client_geo,
+                            control_create_cookies<Win>& cookies)
 {
     auto init_minimize = !isMapped && (win.net_info->initialMappingState() == net::Iconic);
     if (win.net_info->state() & net::Hidden) {
@@ -483,7 +519,7 @@ void init_controlled_window(Win& win, bool isMapped, QRect const& client_geo)
     win.geo.client_frame_extents = gtk_frame_extents(&win);
     win.geo.update.original.client_frame_extents = win.geo.client_frame_extents;
 
-    prepare_decoration(&win);
+    prepare_decoration(&win, cookies);
 
     // Set size before placement.
     if (isMapped) {
@@ -733,16 +769,14 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
         | net::WM2FullscreenMonitors | net::WM2GroupLeader | net::WM2Urgency | net::WM2Input
         | net::WM2Protocols | net::WM2InitialMappingState | net::WM2IconPixmap
         | net::WM2OpaqueRegion | net::WM2DesktopFileName | net::WM2GTKFrameExtents
-        | net::WM2GTKApplicationId;
+        | net::WM2GTKApplicationId | net::WM2ClientMachine;
 
-    auto wmClientLeaderCookie = fetch_wm_client_leader(*win);
-    auto skipCloseAnimationCookie = fetch_skip_close_animation(*win);
-    auto showOnScreenEdgeCookie = fetch_show_on_screen_edge(win);
-    auto transientCookie = fetch_transient(win);
+    control_create_cookies<Win> cookies(*win);
 
     win->geometry_hints.init(win->xcb_windows.client);
     win->motif_hints.init(win->xcb_windows.client);
 
+    // Waits for the first time on a reply. All requests above are answered at this point as well.
     win->net_info = new win_info<Win>(win,
                                       win->xcb_windows.client,
                                       win->space.base.x11_data.root_window,
@@ -757,14 +791,17 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     win->colormap = attr->colormap;
 
     fetch_wm_class(*win);
-    read_wm_client_leader(*win, wmClientLeaderCookie);
-    fetch_wm_client_machine(*win);
-    get_sync_counter(win);
+    read_wm_client_leader(*win, cookies.wm_client_leader);
+    win->client_machine->resolve(win->space.base.x11_data,
+                                 win->xcb_windows.client,
+                                 get_wm_client_leader(*win),
+                                 win->net_info->clientMachine());
+    read_sync_counter(win, cookies.sync_counter);
 
     // First only read the caption text, so that win::setup_rules(..) can use it for matching,
     // and only then really set the caption using setCaption(), which checks for duplicates etc.
     // and also relies on rules already existing
-    win->meta.caption.normal = read_name(win);
+    win->meta.caption.normal = read_name(win, cookies.wm_name);
 
     rules::setup_rules(win);
     set_caption(win, win->meta.caption.normal, true);
@@ -778,9 +815,9 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
         xcb_shape_select_input(space.base.x11_data.connection, win->xcb_windows.client, true);
     }
 
-    detect_shape(*win);
+    read_shape(*win, cookies.shape);
     detect_no_border(win);
-    fetch_iconic_name(win);
+    fetch_iconic_name(win, cookies.wm_icon_name);
 
     check_group(win, nullptr);
     update_urgency(win);
@@ -788,7 +825,7 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     update_allowed_actions(win);
 
     win->transient->set_modal((win->net_info->state() & net::Modal) != 0);
-    read_transient_property(win, transientCookie);
+    read_transient_property(win, cookies.transient);
 
     QByteArray desktopFileName{win->net_info->desktopFileName()};
     if (desktopFileName.isEmpty()) {
@@ -805,7 +842,7 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     win->geometry_hints.read();
     get_motif_hints(win, true);
     fetch_wm_opaque_region(*win);
-    set_skip_close_animation(*win, skipCloseAnimationCookie.to_bool());
+    set_skip_close_animation(*win, cookies.skip_close_animation.to_bool());
 
     // TODO: Try to obey all state information from net_info->state()
 
@@ -819,8 +856,8 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
 
     update_layer(win);
 
-    if (!init_controlled_window_from_session(*win, isMapped)) {
-        init_controlled_window(*win, isMapped, windowGeometry.rect());
+    if (!init_controlled_window_from_session(*win, isMapped, cookies)) {
+        init_controlled_window(*win, isMapped, windowGeometry.rect(), cookies);
     }
 
     assert(win->mapping != mapping_state::withdrawn);
@@ -850,7 +887,7 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     win->updateWindowRules(rules::type::all);
 
     win->setBlockingCompositing(win->net_info->isBlockingCompositing());
-    read_show_on_screen_edge(win, showOnScreenEdgeCookie);
+    read_show_on_screen_edge(win, cookies.show_on_screen_edge);
 
     // Forward all opacity values to the frame in case there'll be other CM running.
     auto comp_qobject = win->space.base.mod.render->qobject.get();
@@ -879,6 +879,9 @@ bool window_event(Win* win, xcb_generic_event_t* e)
         }
         if (dirtyProperties2.testFlag(net::WM2BlockCompositing)) {
             win->setBlockingCompositing(win->net_info->isBlockingCompositing());
+
+            // Lets the compositor check again if the window is shown unredirected.
+            Q_EMIT win->qobject->needsRepaint();
         }
         if (dirtyProperties2.testFlag(net::WM2GroupLeader)) {
             check_group(win, nullptr);
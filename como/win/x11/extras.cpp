@@ -39,18 +39,9 @@ template<typename T>
 using UniqueCPointer = std::unique_ptr<T, CDeleter>;
 
 template<typename T>
-T from_native_pixmap(xcb_pixmap_t pixmap, xcb_connection_t* c)
+T from_native_image(xcb_get_geometry_reply_t const& geo,
+                    UniqueCPointer<xcb_get_image_reply_t> xImage)
 {
-    const xcb_get_geometry_cookie_t geoCookie = xcb_get_geometry_unchecked(c, pixmap);
-    UniqueCPointer<xcb_get_geometry_reply_t> geo(xcb_get_geometry_reply(c, geoCookie, nullptr));
-    if (!geo) {
-        // getting geometry for the pixmap failed
-        return T();
-    }
-
-    const xcb_get_image_cookie_t imageCookie = xcb_get_image_unchecked(
-        c, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, 0, 0, geo->width, geo->height, ~0);
-    UniqueCPointer<xcb_get_image_reply_t> xImage(xcb_get_image_reply(c, imageCookie, nullptr));
     if (!xImage) {
         // request for image data failed
         return T();
@@ -86,9 +77,9 @@ T from_native_pixmap(xcb_pixmap_t pixmap, xcb_connection_t* c)
         return T(); // we don't know
     }
     QImage image(xcb_get_image_data(xImage.get()),
-                 geo->width,
-                 geo->height,
-                 xcb_get_image_data_length(xImage.get()) / geo->height,
+                 geo.width,
+                 geo.height,
+                 xcb_get_image_data_length(xImage.get()) / geo.height,
                  format,
                  free,
                  xImage.get());
@@ -117,10 +108,44 @@ QPixmap createPixmapFromHandle(xcb_connection_t* c, WId pixmap, WId pixmap_mask)
         return QPixmap();
     }
 
-    auto pix = from_native_pixmap<QPixmap>(pixmap, c);
+    // The pixmap and its mask are read back together. This way it takes one round-trip for the
+    // geometries and one for the image data.
+    auto const has_mask = pixmap_mask != XCB_PIXMAP_NONE;
+    auto const geo_cookie = xcb_get_geometry_unchecked(c, pixmap);
+    auto const mask_geo_cookie
+        = has_mask ? xcb_get_geometry_unchecked(c, pixmap_mask) : xcb_get_geometry_cookie_t{0};
+
+    UniqueCPointer<xcb_get_geometry_reply_t> geo(xcb_get_geometry_reply(c, geo_cookie, nullptr));
+    UniqueCPointer<xcb_get_geometry_reply_t> mask_geo(
+        has_mask ? xcb_get_geometry_reply(c, mask_geo_cookie, nullptr) : nullptr);
+
+    if (!geo) {
+        // getting geometry for the pixmap failed
+        return QPixmap();
+    }
+
+    auto get_image = [c](xcb_drawable_t drawable, xcb_get_geometry_reply_t const& geo) {
+        return xcb_get_image_unchecked(
+            c, XCB_IMAGE_FORMAT_Z_PIXMAP, drawable, 0, 0, geo.width, geo.height, ~0);
+    };
+
+    auto const image_cookie = get_image(pixmap, *geo);
+    auto const mask_image_cookie
+        = mask_geo ? get_image(pixmap_mask, *mask_geo) : xcb_get_image_cookie_t{0};
+
+    auto pix = from_native_image<QPixmap>(
+        *geo,
+        UniqueCPointer<xcb_get_image_reply_t>(xcb_get_image_reply(c, image_cookie, nullptr)));
+
+    if (has_mask) {
+        if (!mask_geo) {
+            return QPixmap();
+        }
 
-    if (pixmap_mask != XCB_PIXMAP_NONE) {
-        auto mask = from_native_pixmap<QBitmap>(pixmap_mask, c);
+        auto mask = from_native_image<QBitmap>(
+            *mask_geo,
+            UniqueCPointer<xcb_get_image_reply_t>(
+                xcb_get_image_reply(c, mask_image_cookie, nullptr)));
         if (mask.size() != pix.size()) {
             return QPixmap();
         }
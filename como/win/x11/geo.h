@@ -11,6 +11,7 @@
 #include "scene.h"
 
 #include <como/base/x11/xcb/extensions.h>
+#include <como/base/x11/xcb/proto.h>
 #include <como/win/setup.h>
 
 #include <xcb/sync.h>
@@ -1490,13 +1491,30 @@ void set_frame_geometry(Win& win, QRect const& rect)
 }
 
 template<typename Win>
-void detect_shape(Win& win)
+base::x11::xcb::shape_extents fetch_shape(Win& win)
+{
+    auto con = win.space.base.x11_data.connection;
+    if (!base::x11::xcb::extensions::self()->is_shape_available()) {
+        return base::x11::xcb::shape_extents(con);
+    }
+    return base::x11::xcb::shape_extents(con, win.xcb_windows.client);
+}
+
+template<typename Win>
+void read_shape(Win& win, base::x11::xcb::shape_extents& extents)
 {
     auto const was_shape = win.is_shape;
-    win.is_shape = base::x11::xcb::extensions::self()->has_shape(win.xcb_windows.client);
+    win.is_shape = !extents.is_null() && extents->bounding_shaped > 0;
     if (was_shape != win.is_shape) {
         Q_EMIT win.qobject->shapedChanged();
     }
 }
 
+template<typename Win>
+void detect_shape(Win& win)
+{
+    auto extents = fetch_shape(win);
+    read_shape(win, extents);
+}
+
 }
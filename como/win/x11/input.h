@@ -56,6 +56,7 @@ void update_input_window(Win* win, QRect const& frame_geo)
     }
 
     if (region.isEmpty()) {
+        win->space.x11_window_index.remove(predicate_match::input_id, win->xcb_windows.input);
         win->xcb_windows.input.reset();
         return;
     }
@@ -81,6 +82,7 @@ void update_input_window(Win* win, QRect const& frame_geo)
                                       XCB_WINDOW_CLASS_INPUT_ONLY,
                                       mask,
                                       values);
+        win->space.x11_window_index.add(predicate_match::input_id, win->xcb_windows.input, win);
         if (win->mapping == mapping_state::mapped) {
             win->xcb_windows.input.map();
         }
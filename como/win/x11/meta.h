@@ -8,34 +8,65 @@
 #include "client_machine.h"
 #include "extras.h"
 
+#include <como/base/x11/xcb/property.h>
 #include <como/win/meta.h>
 
-#include <xcb/xcb_icccm.h>
-
 namespace como::win::x11
 {
 
 template<typename Win>
-QString read_name_property(Win& win, xcb_atom_t atom)
+base::x11::xcb::property fetch_name_property(Win& win, xcb_atom_t atom)
 {
-    auto const cookie = xcb_icccm_get_text_property_unchecked(
-        win.space.base.x11_data.connection, win.xcb_windows.client, atom);
-    xcb_icccm_get_text_property_reply_t reply;
-
-    if (xcb_icccm_get_wm_name_reply(win.space.base.x11_data.connection, cookie, &reply, nullptr)) {
-        QString retVal;
-        if (reply.encoding == win.space.atoms->utf8_string) {
-            retVal = QString::fromUtf8(QByteArray(reply.name, reply.name_len));
-        } else if (reply.encoding == XCB_ATOM_STRING) {
-            retVal = QString::fromLocal8Bit(QByteArray(reply.name, reply.name_len));
-        }
-        xcb_icccm_get_text_property_reply_wipe(&reply);
-        return retVal.simplified();
+    return base::x11::xcb::property(win.space.base.x11_data.connection,
+                                    false,
+                                    win.xcb_windows.client,
+                                    atom,
+                                    XCB_GET_PROPERTY_TYPE_ANY,
+                                    0,
+                                    10000);
+}
+
+template<typename Win>
+QString read_name_property(Win& win, base::x11::xcb::property& prop)
+{
+    auto reply = prop.data();
+    if (!reply || reply->format != 8) {
+        return QString();
     }
 
+    QByteArray const name(static_cast<char const*>(xcb_get_property_value(reply)),
+                          xcb_get_property_value_length(reply));
+
+    if (reply->type == win.space.atoms->utf8_string) {
+        return QString::fromUtf8(name).simplified();
+    }
+    if (reply->type == XCB_ATOM_STRING) {
+        return QString::fromLocal8Bit(name).simplified();
+    }
     return QString();
 }
 
+template<typename Win>
+QString read_name_property(Win& win, xcb_atom_t atom)
+{
+    auto prop = fetch_name_property(win, atom);
+    return read_name_property(win, prop);
+}
+
+/**
+ * Reads the caption from the NETWM name and otherwise from @p wm_name. The WM_NAME property can be
+ * fetched in advance with fetch_name_property.
+ */
+template<typename Win>
+QString read_name(Win* win, base::x11::xcb::property& wm_name)
+{
+    if (win->net_info->name() && win->net_info->name()[0] != '\0') {
+        return QString::fromUtf8(win->net_info->name()).simplified();
+    }
+
+    return read_name_property(*win, wm_name);
+}
+
 template<typename Win>
 QString read_name(Win* win)
 {
@@ -141,15 +172,8 @@ void fetch_name(Win* win)
 }
 
 template<typename Win>
-void fetch_iconic_name(Win* win)
+void set_iconic_name(Win* win, QString const& s)
 {
-    QString s;
-    if (win->net_info->iconName() && win->net_info->iconName()[0] != '\0') {
-        s = QString::fromUtf8(win->net_info->iconName());
-    } else {
-        s = read_name_property(*win, XCB_ATOM_WM_ICON_NAME);
-    }
-
     if (s == win->iconic_caption) {
         return;
     }
@@ -170,6 +194,27 @@ void fetch_iconic_name(Win* win)
     }
 }
 
+/// Like fetch_iconic_name but with the WM_ICON_NAME property fetched in advance.
+template<typename Win>
+void fetch_iconic_name(Win* win, base::x11::xcb::property& wm_icon_name)
+{
+    if (win->net_info->iconName() && win->net_info->iconName()[0] != '\0') {
+        set_iconic_name(win, QString::fromUtf8(win->net_info->iconName()));
+        return;
+    }
+    set_iconic_name(win, read_name_property(*win, wm_icon_name));
+}
+
+template<typename Win>
+void fetch_iconic_name(Win* win)
+{
+    if (win->net_info->iconName() && win->net_info->iconName()[0] != '\0') {
+        set_iconic_name(win, QString::fromUtf8(win->net_info->iconName()));
+        return;
+    }
+    set_iconic_name(win, read_name_property(*win, XCB_ATOM_WM_ICON_NAME));
+}
+
 template<typename Win>
 void get_icons(Win* win)
 {
@@ -185,18 +230,26 @@ void get_icons(Win* win)
 
     QIcon icon;
     auto readIcon = [win, &icon](int size, bool scale = true) {
-        auto const pix
-            = extras::icon(*win->net_info, size, size, scale, extras::NETWM | extras::WMHints);
+        auto const pix = extras::icon(*win->net_info, size, size, scale, extras::NETWM);
         if (!pix.isNull()) {
             icon.addPixmap(pix);
         }
     };
 
-    readIcon(16);
-    readIcon(32);
-    readIcon(48, false);
-    readIcon(64, false);
-    readIcon(128, false);
+    if (win->net_info->icon(-1, -1).data) {
+        readIcon(16);
+        readIcon(32);
+        readIcon(48, false);
+        readIcon(64, false);
+        readIcon(128, false);
+    } else {
+        // The icon pixmap from WM_HINTS must be read back from the X server. It is only read once
+        // and scaled by QIcon to the requested sizes.
+        auto const pix = extras::icon(*win->net_info, -1, -1, false, extras::WMHints);
+        if (!pix.isNull()) {
+            icon.addPixmap(pix);
+        }
+    }
 
     if (icon.isNull()) {
         // Then try window group
@@ -171,6 +171,13 @@ enum MappingState {
     Iconic = 3,    // IconicState
 };
 
+/// Values of the _NET_WM_BYPASS_COMPOSITOR hint.
+enum BypassCompositor {
+    BypassNoPreference = 0,
+    BypassRequested = 1,
+    BypassDenied = 2, // the window requires compositing
+};
+
 enum Action {
     ActionMove = 1u << 0,
     ActionResize = 1u << 1,
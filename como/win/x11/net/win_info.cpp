@@ -76,6 +76,7 @@ struct win_info_private {
     bool has_net_support;
 
     bool blockCompositing;
+    net::BypassCompositor bypassCompositor;
     bool urgency;
     bool input;
     net::MappingState initialMappingState;
@@ -250,6 +251,7 @@ win_info::win_info(xcb_connection_t* connection,
     p->appmenu_object_path = nullptr;
     p->appmenu_service_name = nullptr;
     p->blockCompositing = false;
+    p->bypassCompositor = net::BypassNoPreference;
     p->urgency = false;
     p->input = true;
     p->initialMappingState = net::Withdrawn;
@@ -2170,18 +2172,10 @@ void win_info::update(net::Properties dirtyProperties, net::Properties2 dirtyPro
         }
 
         // _NET_WM_BYPASS_COMPOSITOR
+        p->bypassCompositor = net::BypassNoPreference;
         data = get_value_reply<uint32_t>(p->conn, cookies[c++], XCB_ATOM_CARDINAL, 0, &success);
-        if (success) {
-            switch (data) {
-            case 1:
-                p->blockCompositing = true;
-                break;
-            case 2:
-                p->blockCompositing = false;
-                break;
-            default:
-                break; // yes, the standard /is/ that stupid.
-            }
+        if (success && (data == net::BypassRequested || data == net::BypassDenied)) {
+            p->bypassCompositor = static_cast<net::BypassCompositor>(data);
         }
     }
 
@@ -2638,6 +2632,11 @@ bool win_info::isBlockingCompositing() const
     return p->blockCompositing;
 }
 
+net::BypassCompositor win_info::bypassCompositor() const
+{
+    return p->bypassCompositor;
+}
+
 bool win_info::handledIcons() const
 {
     return p->handled_icons;
@@ -126,6 +126,7 @@ public:
 
     void setBlockingCompositing(bool active);
     bool isBlockingCompositing() const;
+    net::BypassCompositor bypassCompositor() const;
 
     void kdeGeometry(net::rect& frame, net::rect& window);
 
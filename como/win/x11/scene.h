@@ -198,6 +198,29 @@ void set_blocking_compositing(Win& win, bool block)
     }
 }
 
+/**
+ * Whether @p win may be shown without compositing while it is fullscreen. The compositor option is
+ * overridden by the _NET_WM_BYPASS_COMPOSITOR hint of the window and that again by window rules.
+ */
+template<typename Win>
+bool is_unredirect_allowed(Win const& win)
+{
+    auto allowed = win.space.base.mod.render->options->qobject->isUnredirectFullscreen();
+
+    switch (win.net_info->bypassCompositor()) {
+    case net::BypassRequested:
+        allowed = true;
+        break;
+    case net::BypassDenied:
+        allowed = false;
+        break;
+    default:
+        break;
+    }
+
+    return win.control->rules.checkUnredirect(allowed);
+}
+
 template<typename Win>
 void add_scene_window_addon(Win& win)
 {
@@ -14,6 +14,8 @@
 #include "space_areas.h"
 #include "space_setup.h"
 #include "window.h"
+#include "stacking_propagation.h"
+#include "window_index.h"
 #include <como/win/x11/subspace_manager.h>
 
 #include <como/base/x11/xcb/helpers.h>
@@ -318,6 +320,8 @@ public:
 
     std::vector<window_t> windows;
     std::unordered_map<uint32_t, window_t> windows_map;
+    window_index<x11_window> x11_window_index;
+    stacking_propagation x11_stacking;
     std::vector<win::x11::group<type>*> groups;
 
     stacking_state<window_t> stacking;
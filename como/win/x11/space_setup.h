@@ -288,6 +288,7 @@ void clear_space(Space& space)
                                 // However, remove from some lists to e.g. prevent
                                 // performTransiencyCheck() from crashing.
                                 remove_all(space.windows, var_win(win));
+                                space.x11_window_index.remove(win);
                             },
                             [](auto&&) {}},
                    *it);
@@ -296,6 +297,7 @@ void clear_space(Space& space)
     for (auto const& unmanaged : get_unmanageds(space)) {
         std::visit(overload{[&](typename Space::x11_window* unmanaged) {
                                 release_window(unmanaged, is_x11);
+                                space.x11_window_index.remove(unmanaged);
                             },
                             [](auto&&) {}},
                    unmanaged);
@@ -304,6 +306,7 @@ void clear_space(Space& space)
     }
 
     space.root_info.reset();
+    space.x11_stacking = {};
     space.shape_helper_window.reset();
 
     space.stacking.order.unlock();
@@ -16,6 +16,7 @@
 #include <como/base/x11/xcb/helpers.h>
 #include <como/win/activation.h>
 
+#include <algorithm>
 #include <deque>
 #include <variant>
 
@@ -78,6 +79,76 @@ void render_stack_unmanaged_windows(Space& space)
     }
 }
 
+template<typename Space>
+void propagate_client_lists(Space& space)
+{
+    using x11_window_t = typename Space::x11_window;
+
+    auto& order = space.stacking.order;
+
+    // Pagers and taskbars read the properties again on every change. Unchanged lists are therefore
+    // not written.
+    auto set_if_changed = [](auto const& windows, auto const* current, int count, auto setter) {
+        if (static_cast<int>(windows.size()) == count
+            && std::equal(windows.begin(), windows.end(), current)) {
+            return;
+        }
+        setter(windows.data(), windows.size());
+    };
+
+    if (std::exchange(space.x11_stacking.client_list_changed, false)) {
+        // TODO this is still not completely in the map order
+        // TODO use ranges::view and ranges::transform in c++20
+        std::vector<xcb_window_t> clients;
+        std::vector<xcb_window_t> non_desktops;
+        std::copy(order.manual_overlays.begin(),
+                  order.manual_overlays.end(),
+                  std::back_inserter(clients));
+
+        for (auto const& win : space.windows) {
+            std::visit(overload{[&](x11_window_t* win) {
+                                    if (!win->control) {
+                                        return;
+                                    }
+
+                                    if (is_desktop(win)) {
+                                        clients.push_back(win->xcb_windows.client);
+                                    } else {
+                                        non_desktops.push_back(win->xcb_windows.client);
+                                    }
+                                },
+                                [](auto&&) {}},
+                       win);
+        }
+
+        // Desktop windows are always on the bottom, so copy the non-desktop windows to the end/top.
+        std::copy(non_desktops.begin(), non_desktops.end(), std::back_inserter(clients));
+        set_if_changed(clients,
+                       space.root_info->clientList(),
+                       space.root_info->clientListCount(),
+                       [&](auto data, auto size) { space.root_info->setClientList(data, size); });
+    }
+
+    std::vector<xcb_window_t> stacked_clients;
+
+    for (auto win : order.stack) {
+        std::visit(
+            overload{[&](x11_window_t* win) { stacked_clients.push_back(win->xcb_windows.client); },
+                     [](auto&&) {}},
+            win);
+    }
+
+    std::copy(order.manual_overlays.begin(),
+              order.manual_overlays.end(),
+              std::back_inserter(stacked_clients));
+    set_if_changed(stacked_clients,
+                   space.root_info->clientListStacking(),
+                   space.root_info->clientListStackingCount(),
+                   [&](auto data, auto size) {
+                       space.root_info->setClientListStacking(data, size);
+                   });
+}
+
 template<typename Space>
 void propagate_clients(Space& space, bool propagate_new_clients)
 {
@@ -135,54 +206,31 @@ void propagate_clients(Space& space, bool propagate_new_clients)
     // these windows that should be unmapped to interfere with other windows.
     std::copy(hidden_windows.begin(), hidden_windows.end(), std::back_inserter(stack));
 
-    // TODO isn't it too inefficient to restack always all clients?
     // TODO don't restack not visible windows?
     Q_ASSERT(stack.at(0) == space.root_info->supportWindow());
-    base::x11::xcb::restack_windows(space.base.x11_data.connection, stack);
 
-    if (propagate_new_clients) {
-        // TODO this is still not completely in the map order
-        // TODO use ranges::view and ranges::transform in c++20
-        std::vector<xcb_window_t> clients;
-        std::vector<xcb_window_t> non_desktops;
-        std::copy(order.manual_overlays.begin(),
-                  order.manual_overlays.end(),
-                  std::back_inserter(clients));
+    // Only the windows that changed their relative position since the last propagation are
+    // restacked. Raising a single window this way sends a single request.
+    base::x11::xcb::restack_windows(
+        space.base.x11_data.connection, stack, space.x11_stacking.stack);
+    space.x11_stacking.stack = std::move(stack);
 
-        for (auto const& win : space.windows) {
-            std::visit(overload{[&](x11_window_t* win) {
-                                    if (!win->control) {
-                                        return;
-                                    }
-
-                                    if (is_desktop(win)) {
-                                        clients.push_back(win->xcb_windows.client);
-                                    } else {
-                                        non_desktops.push_back(win->xcb_windows.client);
-                                    }
-                                },
-                                [](auto&&) {}},
-                       win);
-        }
-
-        // Desktop windows are always on the bottom, so copy the non-desktop windows to the end/top.
-        std::copy(non_desktops.begin(), non_desktops.end(), std::back_inserter(clients));
-        space.root_info->setClientList(clients.data(), clients.size());
-    }
-
-    std::vector<xcb_window_t> stacked_clients;
-
-    for (auto win : order.stack) {
-        std::visit(
-            overload{[&](x11_window_t* win) { stacked_clients.push_back(win->xcb_windows.client); },
-                     [](auto&&) {}},
-            win);
+    space.x11_stacking.client_list_changed |= propagate_new_clients;
+    if (std::exchange(space.x11_stacking.client_lists_pending, true)) {
+        return;
     }
 
-    std::copy(order.manual_overlays.begin(),
-              order.manual_overlays.end(),
-              std::back_inserter(stacked_clients));
-    space.root_info->setClientListStacking(stacked_clients.data(), stacked_clients.size());
+    // The stacking order changes multiple times while processing a batch of X events. The client
+    // list properties are written only once afterwards.
+    QMetaObject::invokeMethod(
+        space.qobject.get(),
+        [&space] {
+            space.x11_stacking.client_lists_pending = false;
+            if (space.root_info) {
+                propagate_client_lists(space);
+            }
+        },
+        Qt::QueuedConnection);
 }
 
 template<typename Space, typename Win>
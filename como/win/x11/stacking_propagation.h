@@ -0,0 +1,24 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <vector>
+#include <xcb/xcb.h>
+
+namespace como::win::x11
+{
+
+/// State of propagating the stacking order to the X server and the root window properties.
+struct stacking_propagation {
+    /// Stack of X windows from top to bottom as last sent to the X server.
+    std::vector<xcb_window_t> stack;
+
+    /// Client list properties are updated once in the next event loop iteration.
+    bool client_lists_pending{false};
+    bool client_list_changed{false};
+};
+
+}
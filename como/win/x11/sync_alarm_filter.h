@@ -32,21 +32,9 @@ public:
     {
         auto alarmEvent = reinterpret_cast<xcb_sync_alarm_notify_event_t*>(event);
 
-        for (auto win : space.windows) {
-            if (std::visit(overload{[&](typename Space::x11_window* win) {
-                                        if (!win->control) {
-                                            return false;
-                                        }
-                                        if (alarmEvent->alarm != win->sync_request.alarm) {
-                                            return false;
-                                        }
-                                        handle_sync(win, alarmEvent->counter_value);
-                                        return true;
-                                    },
-                                    [](auto&&) { return false; }},
-                           win)) {
-                break;
-            }
+        if (auto win = space.x11_window_index.find_sync_alarm(alarmEvent->alarm);
+            win && win->control) {
+            handle_sync(win, alarmEvent->counter_value);
         }
 
         return false;
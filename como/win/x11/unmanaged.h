@@ -22,21 +22,11 @@ namespace como::win::x11
 template<typename Win, typename Space>
 Win* find_unmanaged(Space&& space, xcb_window_t xcb_win)
 {
-    for (auto& var_win : space.windows) {
-        if (auto win = std::visit(overload{[xcb_win](Win* win) -> Win* {
-                                               if (win->remnant || win->control
-                                                   || win->xcb_windows.client != xcb_win) {
-                                                   return nullptr;
-                                               }
-                                               return win;
-                                           },
-                                           [](auto&& /*win*/) -> Win* { return nullptr; }},
-                                  var_win)) {
-            return win;
-        }
+    auto win = space.x11_window_index.find(predicate_match::window, xcb_win);
+    if (!win || win->remnant || win->control) {
+        return nullptr;
     }
-
-    return nullptr;
+    return win;
 }
 
 template<typename Space>
@@ -130,6 +120,7 @@ auto create_unmanaged_window(xcb_window_t xcb_win, Space& space) -> typename Spa
                      [win] { win->space.base.mod.render->schedule_repaint(win); });
 
     space.windows.push_back(win);
+    space.x11_window_index.add(win);
     space.stacking.order.render_restack_required = true;
     Q_EMIT space.qobject->unmanagedAdded(win->meta.signal_id);
 
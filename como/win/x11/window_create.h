@@ -22,6 +22,7 @@ void add_controlled_window_to_space(Space& space, Win* win)
     auto grp = find_group(space, win->xcb_windows.client);
 
     space.windows.push_back(win);
+    space.x11_window_index.add(win);
     Q_EMIT space.qobject->clientAdded(win->meta.signal_id);
 
     if (grp) {
@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "types.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <xcb/sync.h>
+#include <xcb/xcb.h>
+
+namespace como::win::x11
+{
+
+/**
+ * Maps the X11 resources of windows in a space to the windows, such that windows can be looked up
+ * on every X event without going through all windows.
+ *
+ * Entries of a window must be removed at the latest when the window is destroyed, since the index
+ * dereferences them on lookup. Entries of resources the window released in the meantime are only
+ * returned as long as the window still holds the resource. This way an entry that was not removed
+ * after the resource was released does not lead to a wrong window.
+ */
+template<typename Win>
+class window_index
+{
+public:
+    void add(predicate_match match, xcb_window_t id, Win* win)
+    {
+        if (id != XCB_WINDOW_NONE) {
+            windows.at(static_cast<size_t>(match))[id] = win;
+        }
+    }
+
+    void remove(predicate_match match, xcb_window_t id)
+    {
+        windows.at(static_cast<size_t>(match)).erase(id);
+    }
+
+    Win* find(predicate_match match, xcb_window_t id) const
+    {
+        auto const& map = windows.at(static_cast<size_t>(match));
+        auto it = map.find(id);
+        if (it == map.end() || get_id(*it->second, match) != id) {
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    void add_sync_alarm(xcb_sync_alarm_t alarm, Win* win)
+    {
+        sync_alarms[alarm] = win;
+    }
+
+    Win* find_sync_alarm(xcb_sync_alarm_t alarm) const
+    {
+        auto it = sync_alarms.find(alarm);
+        if (it == sync_alarms.end() || it->second->sync_request.alarm != alarm) {
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    /// Adds all current resources of @p win.
+    void add(Win* win)
+    {
+        add(predicate_match::window, win->xcb_windows.client, win);
+        add(predicate_match::wrapper_id, win->xcb_windows.wrapper, win);
+        add(predicate_match::frame_id, win->xcb_windows.outer, win);
+        add(predicate_match::input_id, win->xcb_windows.input, win);
+
+        if (win->sync_request.alarm != XCB_NONE) {
+            add_sync_alarm(win->sync_request.alarm, win);
+        }
+    }
+
+    /// Removes all entries of @p win, also of resources it does not hold anymore.
+    void remove(Win* win)
+    {
+        auto is_win = [win](auto const& entry) { return entry.second == win; };
+
+        for (auto& map : windows) {
+            std::erase_if(map, is_win);
+        }
+        std::erase_if(sync_alarms, is_win);
+    }
+
+    /// Whether any entry refers to @p win.
+    bool contains(Win const* win) const
+    {
+        auto is_win = [win](auto const& entry) { return entry.second == win; };
+
+        for (auto const& map : windows) {
+            if (std::any_of(map.begin(), map.end(), is_win)) {
+                return true;
+            }
+        }
+        return std::any_of(sync_alarms.begin(), sync_alarms.end(), is_win);
+    }
+
+private:
+    static xcb_window_t get_id(Win const& win, predicate_match match)
+    {
+        switch (match) {
+        case predicate_match::window:
+            return win.xcb_windows.client;
+        case predicate_match::wrapper_id:
+            return win.xcb_windows.wrapper;
+        case predicate_match::frame_id:
+            return win.xcb_windows.outer;
+        case predicate_match::input_id:
+            return win.xcb_windows.input;
+        }
+        return XCB_WINDOW_NONE;
+    }
+
+    // One map per predicate_match value.
+    std::array<std::unordered_map<xcb_window_t, Win*>, 4> windows;
+    std::unordered_map<xcb_sync_alarm_t, Win*> sync_alarms;
+};
+
+}
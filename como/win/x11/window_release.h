@@ -76,6 +76,7 @@ void remove_controlled_window_from_space(Space& space, Win* win)
 
     // TODO: if marked client is removed, notify the marked list
     remove_window_from_lists(space, win);
+    space.x11_window_index.remove(win);
     remove_all(space.stacking.attention_chain, var_win(win));
 
     auto group = find_group(space, win->xcb_windows.client);
@@ -132,6 +133,7 @@ void finish_unmanaged_removal(Win* win, Win* remnant)
     assert(contains(space.windows, var_win(win)));
 
     remove_window_from_lists(space, win);
+    space.x11_window_index.remove(win);
     space.base.mod.render->addRepaint(visible_rect(win));
 
     Q_EMIT space.qobject->unmanagedRemoved(win->meta.signal_id);
@@ -430,6 +432,10 @@ void cleanup_window(Win& win)
     delete win.client_machine;
     delete win.net_info;
     win.space.windows_map.erase(win.meta.signal_id);
+
+    // The index dereferences its entries on lookup. None may outlive the window.
+    win.space.x11_window_index.remove(&win);
+    assert(!win.space.x11_window_index.contains(&win));
 }
 
 /// Kills the window via XKill
@@ -7,13 +7,34 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <como/base/logging.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
 #include <unistd.h>
 
 namespace como::xwl
 {
 
-// in Bytes: equals 64KB
-constexpr uint32_t s_incrChunkSize = 63 * 1024;
+// Upper bound in bytes for a single property. Larger properties need fewer round trips with the
+// requestor, but X requests are limited in size.
+constexpr uint32_t s_maxChunkSize = 1024 * 1024;
+
+// Number of chunks read ahead from a Wayland source while the requestor processes a property.
+constexpr size_t s_readAheadChunks = 4;
+
+// Amount in bytes fetched from an X source ahead of writing it to the Wayland client.
+constexpr size_t s_maxQueuedSize = s_readAheadChunks * s_maxChunkSize;
+
+// Size of the pipe buffer between compositor and Wayland client. Larger buffers need fewer
+// wake-ups. It is capped by the system and failing to set it is not an error.
+constexpr int s_pipeSize = s_maxChunkSize;
+
+static uint32_t property_chunk_size(xcb_connection_t* connection)
+{
+    // Maximum request length in 4-byte units. The ChangeProperty request header needs 24 bytes.
+    auto const max_request = static_cast<uint64_t>(xcb_get_maximum_request_length(connection)) * 4;
+    return static_cast<uint32_t>(std::min<uint64_t>(s_maxChunkSize, max_request - 24));
+}
 
 transfer::transfer(xcb_atom_t selection,
                    qint32 fd,
@@ -26,6 +47,13 @@ transfer::transfer(xcb_atom_t selection,
     , fd{fd}
     , timestamp{timestamp}
 {
+    // Transfers must never block the compositor on the Wayland side.
+    if (auto const flags = fcntl(fd, F_GETFL); flags != -1) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+#ifdef F_SETPIPE_SZ
+    fcntl(fd, F_SETPIPE_SZ, s_pipeSize);
+#endif
 }
 
 void transfer::create_socket_notifier(QSocketNotifier::Type type)
@@ -71,6 +99,8 @@ wl_to_x11_transfer::wl_to_x11_transfer(xcb_atom_t selection,
                                        QObject* parent)
     : transfer(selection, fd, 0, x11, parent)
     , request(request)
+    , ring(s_readAheadChunks)
+    , chunk_size{property_chunk_size(x11.connection)}
 {
 }
 
@@ -89,35 +119,75 @@ void wl_to_x11_transfer::start_transfer_from_source()
     });
 }
 
-int wl_to_x11_transfer::flush_source_data()
+wl_to_x11_transfer::chunk* wl_to_x11_transfer::writable_chunk()
+{
+    if (ring_count > 0) {
+        auto& back = ring.at((ring_head + ring_count - 1) % ring.size());
+        if (back.size < static_cast<int>(chunk_size)) {
+            return &back;
+        }
+    }
+    if (ring_count == ring.size()) {
+        return nullptr;
+    }
+
+    auto& next = ring.at((ring_head + ring_count) % ring.size());
+    if (next.data.size() != static_cast<qsizetype>(chunk_size)) {
+        next.data.resize(chunk_size);
+    }
+    next.size = 0;
+    ring_count++;
+    return &next;
+}
+
+bool wl_to_x11_transfer::front_chunk_ready() const
 {
+    if (ring_count == 0) {
+        return false;
+    }
+    // The last chunk of the source may be partially filled.
+    return source_done || ring.at(ring_head).size == static_cast<int>(chunk_size);
+}
+
+void wl_to_x11_transfer::pop_front_chunk()
+{
+    ring.at(ring_head).size = 0;
+    ring_head = (ring_head + 1) % ring.size();
+    ring_count--;
+}
+
+void wl_to_x11_transfer::flush_source_data()
+{
+    auto const& front = ring.at(ring_head);
+
     xcb_change_property(x11.connection,
                         XCB_PROP_MODE_REPLACE,
                         request->requestor,
                         request->property,
                         request->target,
                         8,
-                        chunks.front().first.size(),
-                        chunks.front().first.data());
+                        front.size,
+                        front.data.constData());
     xcb_flush(x11.connection);
 
     property_is_set = true;
     reset_timeout();
 
-    auto const rm = chunks.front();
-    chunks.pop_front();
-    return rm.first.size();
+    pop_front_chunk();
+
+    if (auto notifier = socket_notifier()) {
+        // There is space again for reading ahead.
+        notifier->setEnabled(true);
+    }
 }
 
 void wl_to_x11_transfer::start_incr()
 {
-    Q_ASSERT(chunks.size() == 1);
-
     uint32_t mask[] = {XCB_EVENT_MASK_PROPERTY_CHANGE};
     xcb_change_window_attributes(x11.connection, request->requestor, XCB_CW_EVENT_MASK, mask);
 
     // spec says to make the available space larger
-    uint32_t const chunkSpace = 1024 + s_incrChunkSize;
+    uint32_t const chunkSpace = 1024 + chunk_size;
     xcb_change_property(x11.connection,
                         XCB_PROP_MODE_REPLACE,
                         request->requestor,
@@ -131,68 +201,87 @@ void wl_to_x11_transfer::start_incr()
     set_incr(true);
     // first data will be flushed after the property has been deleted
     // again by the requestor
-    flush_property_on_delete = true;
     property_is_set = true;
     Q_EMIT selection_notify(request, true);
 }
 
 void wl_to_x11_transfer::read_wl_source()
 {
-    if (chunks.size() == 0 || chunks.back().second == s_incrChunkSize) {
-        // append new chunk
-        auto next = std::pair<QByteArray, int>();
-        next.first.resize(s_incrChunkSize);
-        next.second = 0;
-        chunks.push_back(next);
-    }
+    // Read as much as is available or fits into the ring without returning to the event loop.
+    while (true) {
+        auto target = writable_chunk();
+        if (!target) {
+            // Ring is full, continue once the requestor took a chunk.
+            socket_notifier()->setEnabled(false);
+            break;
+        }
 
-    auto const oldLen = chunks.back().second;
-    auto const avail = s_incrChunkSize - chunks.back().second;
-    Q_ASSERT(avail > 0);
+        auto const avail = static_cast<int>(chunk_size) - target->size;
+        auto const readLen = read(get_fd(), target->data.data() + target->size, avail);
 
-    ssize_t readLen = read(get_fd(), chunks.back().first.data() + oldLen, avail);
-    if (readLen == -1) {
-        qCWarning(KWIN_CORE) << "Error reading in Wl data.";
+        if (readLen == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            qCWarning(KWIN_CORE) << "Error reading in Wl data.";
 
-        // TODO: cleanup X side?
-        end_transfer();
-        return;
+            // TODO: cleanup X side?
+            end_transfer();
+            return;
+        }
+
+        if (readLen == 0) {
+            // at the fd end
+            source_done = true;
+            clear_socket_notifier();
+            if (target->size == 0) {
+                // drop the chunk again so only chunks with data are flushed
+                ring_count--;
+            }
+            break;
+        }
+
+        target->size += readLen;
+        if (readLen < avail) {
+            // The pipe is drained for now.
+            break;
+        }
     }
-    chunks.back().second = oldLen + readLen;
 
-    if (readLen == 0) {
-        // at the fd end - complete transfer now
-        chunks.back().first.resize(chunks.back().second);
+    reset_timeout();
 
-        if (get_incr()) {
-            // incremental transfer is to be completed now
-            flush_property_on_delete = true;
-            if (!property_is_set) {
-                // flush if target's property is not set at the moment
-                flush_source_data();
-            }
-            clear_socket_notifier();
-        } else {
+    if (!get_incr()) {
+        if (source_done && ring_count <= 1) {
             // non incremental transfer is to be completed now,
             // data can be transferred to X client via a single property set
+            if (ring_count == 0) {
+                writable_chunk();
+            }
             flush_source_data();
             Q_EMIT selection_notify(request, true);
             end_transfer();
-        }
-    } else if (chunks.back().second == s_incrChunkSize) {
-        // first chunk full, but not yet at fd end -> go incremental
-        if (get_incr()) {
-            flush_property_on_delete = true;
-            if (!property_is_set) {
-                // flush if target's property is not set at the moment
-                flush_source_data();
-            }
-        } else {
-            // starting incremental transfer
+        } else if (ring.at(ring_head).size == static_cast<int>(chunk_size)) {
+            // first chunk full and more data follows -> go incremental
             start_incr();
         }
+        return;
+    }
+
+    if (property_is_set) {
+        // Chunks are flushed once the requestor deleted the property.
+        return;
+    }
+
+    if (front_chunk_ready()) {
+        // the requestor waits for the next chunk
+        flush_source_data();
+    } else if (source_done && ring_count == 0) {
+        // The source ended after the requestor took the last chunk.
+        finish_incr();
     }
-    reset_timeout();
 }
 
 bool wl_to_x11_transfer::handle_property_notify(xcb_property_notify_event_t* event)
@@ -214,29 +303,36 @@ void wl_to_x11_transfer::handle_property_delete()
     }
     property_is_set = false;
 
-    if (flush_property_on_delete) {
-        if (!socket_notifier() && chunks.empty()) {
-            // transfer complete
+    if (front_chunk_ready()) {
+        // The next chunk was read ahead already.
+        flush_source_data();
+        return;
+    }
 
-            uint32_t mask[] = {0};
-            xcb_change_window_attributes(
-                x11.connection, request->requestor, XCB_CW_EVENT_MASK, mask);
-
-            xcb_change_property(x11.connection,
-                                XCB_PROP_MODE_REPLACE,
-                                request->requestor,
-                                request->property,
-                                request->target,
-                                8,
-                                0,
-                                nullptr);
-            xcb_flush(x11.connection);
-            flush_property_on_delete = false;
-            end_transfer();
-        } else {
-            flush_source_data();
-        }
+    if (!source_done || ring_count > 0) {
+        // the next chunk is flushed once it has been read
+        return;
     }
+
+    finish_incr();
+}
+
+void wl_to_x11_transfer::finish_incr()
+{
+    // A zero-length property tells the requestor that the transfer is complete.
+    uint32_t mask[] = {0};
+    xcb_change_window_attributes(x11.connection, request->requestor, XCB_CW_EVENT_MASK, mask);
+
+    xcb_change_property(x11.connection,
+                        XCB_PROP_MODE_REPLACE,
+                        request->requestor,
+                        request->property,
+                        request->target,
+                        8,
+                        0,
+                        nullptr);
+    xcb_flush(x11.connection);
+    end_transfer();
 }
 
 x11_to_wl_transfer::x11_to_wl_transfer(xcb_atom_t selection,
@@ -275,6 +371,10 @@ x11_to_wl_transfer::~x11_to_wl_transfer()
     xcb_destroy_window(x11.connection, window);
     xcb_flush(x11.connection);
 
+    for (auto reply : replies) {
+        free(reply);
+    }
+
     delete receiver;
     receiver = nullptr;
 }
@@ -363,9 +463,17 @@ void x11_to_wl_transfer::get_incr_chunk()
         // receive mechanism has not yet been setup
         return;
     }
+    if (replies_size >= s_maxQueuedSize) {
+        // fetched once enough of the queued data has been written
+        property_pending = true;
+        return;
+    }
+    property_pending = false;
 
+    // The property is deleted with the fetch so the source can send the next chunk while this one
+    // is written to the Wayland client.
     auto cookie = xcb_get_property(x11.connection,
-                                   0,
+                                   1,
                                    window,
                                    x11.atoms->wl_selection,
                                    XCB_GET_PROPERTY_TYPE_ANY,
@@ -379,15 +487,15 @@ void x11_to_wl_transfer::get_incr_chunk()
         return;
     }
 
-    if (xcb_get_property_value_length(reply) > 0) {
-        // reply's ownership is transferred
-        receiver->transfer_from_property(reply);
-        data_source_write();
+    if (auto const length = xcb_get_property_value_length(reply); length > 0) {
+        replies.push_back(reply);
+        replies_size += length;
     } else {
-        // transfer complete
+        // transfer complete once all queued data has been written
         free(reply);
-        end_transfer();
+        incr_done = true;
     }
+    data_source_write();
 }
 
 data_receiver::~data_receiver()
@@ -400,6 +508,10 @@ data_receiver::~data_receiver()
 
 void data_receiver::transfer_from_property(xcb_get_property_reply_t* reply)
 {
+    if (property_reply) {
+        // Data of the previous property might have been discarded on conversion.
+        free(property_reply);
+    }
     property_start = 0;
     property_reply = reply;
 
@@ -413,6 +525,11 @@ void data_receiver::set_data(char const* value, int length)
     data = QByteArray::fromRawData(value, length);
 }
 
+bool data_receiver::has_data() const
+{
+    return property_start < data.size();
+}
+
 QByteArray data_receiver::get_data() const
 {
     return QByteArray::fromRawData(data.data() + property_start, data.size() - property_start);
@@ -512,36 +629,61 @@ void moz_url_receiver::set_data(char const* value, int length)
 
 void x11_to_wl_transfer::data_source_write()
 {
-    auto property = receiver->get_data();
+    // Write as much as the Wayland client accepts without returning to the event loop.
+    while (true) {
+        if (!receiver->has_data()) {
+            if (replies.empty()) {
+                break;
+            }
+            auto reply = replies.front();
+            replies.pop_front();
+            replies_size -= xcb_get_property_value_length(reply);
 
-    auto len = write(get_fd(), property.constData(), property.size());
-    if (len == -1) {
-        qCWarning(KWIN_CORE) << "X11 to Wayland write error on fd:" << get_fd();
-        end_transfer();
-        return;
+            // reply's ownership is transferred
+            receiver->transfer_from_property(reply);
+            continue;
+        }
+
+        auto const property = receiver->get_data();
+        auto const len = write(get_fd(), property.constData(), property.size());
+
+        if (len == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            qCWarning(KWIN_CORE) << "X11 to Wayland write error on fd:" << get_fd();
+            end_transfer();
+            return;
+        }
+
+        receiver->part_read(len);
     }
 
-    receiver->part_read(len);
-    if (len == property.size()) {
-        // property completely transferred
-        if (get_incr()) {
-            clear_socket_notifier();
-            xcb_delete_property(x11.connection, window, x11.atoms->wl_selection);
-            xcb_flush(x11.connection);
-        } else {
+    reset_timeout();
+
+    if (!receiver->has_data() && replies.empty()) {
+        // all received data written
+        clear_socket_notifier();
+
+        if (!get_incr() || incr_done) {
             // transfer complete
             end_transfer();
+            return;
         }
-    } else {
-        if (!socket_notifier()) {
-            create_socket_notifier(QSocketNotifier::Write);
-            connect(socket_notifier(), &QSocketNotifier::activated, this, [this](int socket) {
-                Q_UNUSED(socket);
-                data_source_write();
-            });
-        }
+    } else if (!socket_notifier()) {
+        create_socket_notifier(QSocketNotifier::Write);
+        connect(socket_notifier(), &QSocketNotifier::activated, this, [this](int socket) {
+            Q_UNUSED(socket);
+            data_source_write();
+        });
+    }
+
+    if (property_pending && replies_size < s_maxQueuedSize) {
+        get_incr_chunk();
     }
-    reset_timeout();
 }
 
 }
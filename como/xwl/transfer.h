@@ -11,6 +11,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <QObject>
 #include <QSocketNotifier>
 #include <deque>
+#include <vector>
 
 #include <xcb/xcb.h>
 
@@ -116,20 +117,34 @@ Q_SIGNALS:
     void selection_notify(xcb_selection_request_event_t* event, bool success);
 
 private:
+    struct chunk {
+        QByteArray data;
+        int size{0};
+    };
+
     void start_incr();
     void read_wl_source();
-    int flush_source_data();
+    void flush_source_data();
     void handle_property_delete();
+    void finish_incr();
+
+    chunk* writable_chunk();
+    bool front_chunk_ready() const;
+    void pop_front_chunk();
 
     xcb_selection_request_event_t* request = nullptr;
 
-    /* contains all received data portioned in chunks
-     * TODO(romangg): explain second std::pair component
+    /* Ring of chunks read ahead from the source while the requestor processes the property. The
+     * chunks are allocated on first use and reused afterwards. Only the last chunk in the ring
+     * can be partially filled.
      */
-    std::deque<std::pair<QByteArray, int>> chunks;
+    std::vector<chunk> ring;
+    size_t ring_head{0};
+    size_t ring_count{0};
+    uint32_t chunk_size;
 
     bool property_is_set = false;
-    bool flush_property_on_delete = false;
+    bool source_done = false;
 
     Q_DISABLE_COPY(wl_to_x11_transfer)
 };
@@ -143,6 +158,7 @@ public:
     virtual ~data_receiver();
 
     void transfer_from_property(xcb_get_property_reply_t* reply);
+    bool has_data() const;
 
     virtual void set_data(char const* value, int length);
     QByteArray get_data() const;
@@ -209,6 +225,16 @@ private:
     xcb_window_t window;
     data_receiver* receiver = nullptr;
 
+    /* Properties already fetched and deleted on the transfer window, so the source can send the
+     * next chunk while these are still written to the Wayland client.
+     */
+    std::deque<xcb_get_property_reply_t*> replies;
+    size_t replies_size{0};
+
+    // A new property is waiting on the transfer window until enough data was written.
+    bool property_pending = false;
+    bool incr_done = false;
+
     Q_DISABLE_COPY(x11_to_wl_transfer)
 };
 
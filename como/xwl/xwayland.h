@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include "types.h"
 
 #include <como/base/wayland/server.h>
+#include <como/base/x11/event_compression.h>
 #include <como/base/x11/selection_owner.h>
 #include <como/base/x11/xcb/helpers.h>
 #include <como/input/cursor.h>
@@ -245,15 +246,20 @@ private:
                                                     QSocketNotifier::Read));
 
         auto processXcbEvents = [this] {
+            // Drain the queue first, so events superseded by later ones are not handled.
+            std::vector<base::x11::event_ptr> events;
             while (auto event = xcb_poll_for_event(core.x11.connection)) {
-                if (data_bridge->filter_event(event)) {
-                    free(event);
+                events.emplace_back(event);
+            }
+            base::x11::compress_events(events);
+
+            for (auto const& event : events) {
+                if (data_bridge->filter_event(event.get())) {
                     continue;
                 }
                 qintptr result = 0;
                 QThread::currentThread()->eventDispatcher()->filterNativeEvent(
-                    QByteArrayLiteral("xcb_generic_event_t"), event, &result);
-                free(event);
+                    QByteArrayLiteral("xcb_generic_event_t"), event.get(), &result);
             }
             xcb_flush(core.x11.connection);
         };
@@ -29,6 +29,10 @@ public:
     void drawWindow(effect::window_paint_data& data) override;
     void apply(effect::window_paint_data& data, WindowQuadList& quads) override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
     int requestedEffectChainPosition() const override
     {
@@ -32,6 +32,10 @@ public:
     ~ColorBlindnessCorrectionEffect() override;
 
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
     bool provides(Feature) override;
     void reconfigure(ReconfigureFlags flags) override;
     int requestedEffectChainPosition() const override;
@@ -27,6 +27,10 @@ public:
     ~ColorPickerEffect() override;
     void paintScreen(effect::screen_paint_data& data) override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
     int requestedEffectChainPosition() const override
     {
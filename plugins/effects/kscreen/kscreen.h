@@ -29,6 +29,10 @@ public:
 
     void reconfigure(ReconfigureFlags flags) override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
     int requestedEffectChainPosition() const override
     {
@@ -35,6 +35,10 @@ public:
     void prePaintScreen(effect::screen_prepaint_data& data) override;
     void paintScreen(effect::screen_paint_data& data) override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
     static bool supported();
 
@@ -86,6 +86,10 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     void postPaintScreen() override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
     // for properties
     QColor color1() const;
@@ -26,6 +26,10 @@ public:
     void reconfigure(ReconfigureFlags) override;
     void paintScreen(effect::screen_paint_data& data) override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
     int requestedEffectChainPosition() const override;
 
     // for properties
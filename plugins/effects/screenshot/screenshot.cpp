@@ -11,9 +11,15 @@
 #include <como/render/effect/interface/effect_window.h>
 #include <como/render/effect/interface/effects_handler.h>
 #include <como/render/gl/interface/framebuffer.h>
+#include <como/render/gl/interface/platform.h>
 #include <como/render/gl/interface/texture.h>
+#include <como/render/gl/interface/utils.h>
 
+#include <QCoreApplication>
 #include <QPainter>
+#include <QPointer>
+#include <QThreadPool>
+#include <cstring>
 
 Q_LOGGING_CATEGORY(KWIN_SCREENSHOT, "kwin_effect_screenshot", QtWarningMsg)
 
@@ -32,6 +38,7 @@ struct ScreenShotAreaData {
     QRect area;
     QImage result;
     QList<EffectScreen*> screens;
+    int pendingReadbacks = 0;
 };
 
 struct ScreenShotScreenData {
@@ -40,6 +47,24 @@ struct ScreenShotScreenData {
     EffectScreen* screen = nullptr;
 };
 
+struct ScreenShotReadback {
+    GLuint buffer = 0;
+    GLsync fence = nullptr;
+    QImage image;
+    std::function<void(QImage)> callback;
+};
+
+// How often pending readbacks are polled when no frames are painted.
+static constexpr int s_readbackPollInterval = 4;
+
+static bool asyncReadbackSupported()
+{
+    if (GLPlatform::instance()->isGLES()) {
+        return hasGLVersion(3, 0);
+    }
+    return hasGLVersion(3, 2) || hasGLExtension(QByteArrayLiteral("GL_ARB_sync"));
+}
+
 static void
 convertFromGLImage(QImage& img, int w, int h, QMatrix4x4 const& renderTargetTransformation)
 {
@@ -88,6 +113,12 @@ ScreenShotEffect::ScreenShotEffect()
     connect(effects, &EffectsHandler::screenAdded, this, &ScreenShotEffect::handleScreenAdded);
     connect(effects, &EffectsHandler::screenRemoved, this, &ScreenShotEffect::handleScreenRemoved);
     connect(effects, &EffectsHandler::windowClosed, this, &ScreenShotEffect::handleWindowClosed);
+
+    m_readbackTimer.setInterval(s_readbackPollInterval);
+    connect(&m_readbackTimer, &QTimer::timeout, this, [this] {
+        effects->makeOpenGLContextCurrent();
+        checkReadbacks();
+    });
 }
 
 ScreenShotEffect::~ScreenShotEffect()
@@ -95,6 +126,7 @@ ScreenShotEffect::~ScreenShotEffect()
     cancelWindowScreenShots();
     cancelAreaScreenShots();
     cancelScreenScreenShots();
+    clearReadbacks();
 }
 
 QFuture<QImage> ScreenShotEffect::scheduleScreenShot(EffectScreen* screen, ScreenShotFlags flags)
@@ -120,38 +152,38 @@ QFuture<QImage> ScreenShotEffect::scheduleScreenShot(EffectScreen* screen, Scree
 
 QFuture<QImage> ScreenShotEffect::scheduleScreenShot(const QRect& area, ScreenShotFlags flags)
 {
-    for (const ScreenShotAreaData& data : m_areaScreenShots) {
-        if (data.area == area && data.flags == flags) {
-            return data.promise.future();
+    for (auto const& data : m_areaScreenShots) {
+        if (data->area == area && data->flags == flags) {
+            return data->promise.future();
         }
     }
 
-    ScreenShotAreaData data;
-    data.area = area;
-    data.flags = flags;
+    auto data = std::make_shared<ScreenShotAreaData>();
+    data->area = area;
+    data->flags = flags;
 
     auto const screens = effects->screens();
     for (auto screen : screens) {
         if (screen->geometry().intersects(area)) {
-            data.screens.append(screen);
+            data->screens.append(screen);
         }
     }
 
     auto devicePixelRatio = 1.;
     if (flags & ScreenShotNativeResolution) {
-        for (auto const screen : std::as_const(data.screens)) {
+        for (auto const screen : std::as_const(data->screens)) {
             if (screen->devicePixelRatio() > devicePixelRatio) {
                 devicePixelRatio = screen->devicePixelRatio();
             }
         }
     }
 
-    data.result = QImage(area.size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
-    data.result.fill(Qt::transparent);
-    data.result.setDevicePixelRatio(devicePixelRatio);
+    data->result = QImage(area.size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    data->result.fill(Qt::transparent);
+    data->result.setDevicePixelRatio(devicePixelRatio);
 
-    data.promise.start();
-    QFuture<QImage> future = data.promise.future();
+    data->promise.start();
+    QFuture<QImage> future = data->promise.future();
 
     m_areaScreenShots.push_back(std::move(data));
     effects->addRepaint(area);
@@ -200,13 +232,16 @@ void ScreenShotEffect::paintScreen(effect::screen_paint_data& data)
     m_paintedScreen = data.screen;
     effects->paintScreen(data);
 
+    // Readbacks of previous frames have likely finished by now.
+    checkReadbacks();
+
     for (auto& win_data : m_windowScreenShots) {
         takeScreenShot(data.render, &win_data);
     }
     m_windowScreenShots.clear();
 
     for (int i = m_areaScreenShots.size() - 1; i >= 0; --i) {
-        if (takeScreenShot(data.render, &m_areaScreenShots[i])) {
+        if (takeScreenShot(data.render, m_areaScreenShots[i])) {
             m_areaScreenShots.erase(m_areaScreenShots.begin() + i);
         }
     }
@@ -280,6 +315,39 @@ void ScreenShotEffect::takeScreenShot(effect::render_data& data, ScreenShotWindo
         // copy content from framebuffer into image
         img = QImage(offscreenTexture->size(), QImage::Format_ARGB32);
         img.setDevicePixelRatio(devicePixelRatio);
+
+        if (asyncReadbackSupported()) {
+            auto promise = std::make_shared<QPromise<QImage>>(std::move(screenshot->promise));
+            auto const flags = screenshot->flags;
+            auto const offset = geometry.topLeft();
+
+            startReadback(img, [this, promise, flags, offset, projection](QImage raw) {
+                // Swizzle and flip on a worker thread. Only the cursor is added back on the main
+                // thread since it is queried from the effects handler.
+                QThreadPool::globalInstance()->start([effect = QPointer<ScreenShotEffect>(this),
+                                                      promise,
+                                                      flags,
+                                                      offset,
+                                                      projection,
+                                                      raw]() mutable {
+                    convertFromGLImage(raw, raw.width(), raw.height(), projection);
+                    auto snapshot = raw.mirrored();
+
+                    QMetaObject::invokeMethod(
+                        qApp,
+                        [effect, promise, flags, offset, snapshot] {
+                            if (effect) {
+                                effect->finishScreenShot(promise, flags, snapshot, offset);
+                            }
+                        },
+                        Qt::QueuedConnection);
+                });
+            });
+
+            render::pop_framebuffer(data);
+            return;
+        }
+
         glReadnPixels(0,
                       0,
                       img.width(),
@@ -301,17 +369,38 @@ void ScreenShotEffect::takeScreenShot(effect::render_data& data, ScreenShotWindo
     screenshot->promise.finish();
 }
 
+static void composeAreaScreenShot(ScreenShotAreaData& screenshot,
+                                  QRect const& sourceRect,
+                                  QImage const& snapshot)
+{
+    QRect const nativeArea(screenshot.area.topLeft(),
+                           screenshot.area.size() * screenshot.result.devicePixelRatio());
+
+    QPainter painter(&screenshot.result);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.setWindow(nativeArea);
+    painter.drawImage(sourceRect, snapshot);
+    painter.end();
+}
+
 bool ScreenShotEffect::takeScreenShot(effect::render_data& render_data,
-                                      ScreenShotAreaData* screenshot)
+                                      std::shared_ptr<ScreenShotAreaData> const& screenshot)
 {
     if (!m_paintedScreen) {
         // On X11, all screens are painted simultaneously and there is no native HiDPI support.
-        auto snapshot = blitScreenshot(render_data, screenshot->area);
-        if (screenshot->flags & ScreenShotIncludeCursor) {
-            grabPointerImage(snapshot, screenshot->area.x(), screenshot->area.y());
+        auto promise = std::make_shared<QPromise<QImage>>(std::move(screenshot->promise));
+        auto const flags = screenshot->flags;
+        auto const offset = screenshot->area.topLeft();
+
+        if (!readbackScreenshot(render_data,
+                                screenshot->area,
+                                1.0,
+                                [this, promise, flags, offset](QImage snapshot) {
+                                    finishScreenShot(promise, flags, snapshot, offset);
+                                })) {
+            finishScreenShot(
+                promise, flags, blitScreenshot(render_data, screenshot->area), offset);
         }
-        screenshot->promise.addResult(snapshot);
-        screenshot->promise.finish();
         return true;
     }
 
@@ -327,26 +416,41 @@ bool ScreenShotEffect::takeScreenShot(effect::render_data& render_data,
         sourceDevicePixelRatio = m_paintedScreen->devicePixelRatio();
     }
 
-    auto const snapshot = blitScreenshot(render_data, sourceRect, sourceDevicePixelRatio);
-    QRect const nativeArea(screenshot->area.topLeft(),
-                           screenshot->area.size() * screenshot->result.devicePixelRatio());
-
-    QPainter painter(&screenshot->result);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform);
-    painter.setWindow(nativeArea);
-    painter.drawImage(sourceRect, snapshot);
-    painter.end();
-
-    if (screenshot->screens.isEmpty()) {
-        if (screenshot->flags & ScreenShotIncludeCursor) {
-            grabPointerImage(screenshot->result, screenshot->area.x(), screenshot->area.y());
+    auto finishArea = [this](ScreenShotAreaData& data) {
+        if (data.flags & ScreenShotIncludeCursor) {
+            grabPointerImage(data.result, data.area.x(), data.area.y());
         }
-        screenshot->promise.addResult(screenshot->result);
-        screenshot->promise.finish();
-        return true;
+        data.promise.addResult(data.result);
+        data.promise.finish();
+    };
+
+    // The area data is kept alive by pending readbacks after it got removed from the list.
+    if (readbackScreenshot(render_data,
+                           sourceRect,
+                           sourceDevicePixelRatio,
+                           [screenshot, sourceRect, finishArea](QImage snapshot) {
+                               composeAreaScreenShot(*screenshot, sourceRect, snapshot);
+                               screenshot->pendingReadbacks--;
+                               if (screenshot->screens.isEmpty()
+                                   && !screenshot->pendingReadbacks) {
+                                   finishArea(*screenshot);
+                               }
+                           })) {
+        screenshot->pendingReadbacks++;
+    } else {
+        composeAreaScreenShot(*screenshot,
+                              sourceRect,
+                              blitScreenshot(render_data, sourceRect, sourceDevicePixelRatio));
     }
 
-    return false;
+    if (!screenshot->screens.isEmpty()) {
+        return false;
+    }
+
+    if (!screenshot->pendingReadbacks) {
+        finishArea(*screenshot);
+    }
+    return true;
 }
 
 bool ScreenShotEffect::takeScreenShot(effect::render_data& render_data,
@@ -361,19 +465,38 @@ bool ScreenShotEffect::takeScreenShot(effect::render_data& render_data,
         devicePixelRatio = screenshot->screen->devicePixelRatio();
     }
 
-    auto snapshot = blitScreenshot(render_data, screenshot->screen->geometry(), devicePixelRatio);
-    if (screenshot->flags & ScreenShotIncludeCursor) {
-        const int xOffset = screenshot->screen->geometry().x();
-        const int yOffset = screenshot->screen->geometry().y();
-        grabPointerImage(snapshot, xOffset, yOffset);
+    auto promise = std::make_shared<QPromise<QImage>>(std::move(screenshot->promise));
+    auto const flags = screenshot->flags;
+    auto const geometry = screenshot->screen->geometry();
+
+    if (!readbackScreenshot(render_data,
+                            geometry,
+                            devicePixelRatio,
+                            [this, promise, flags, geometry](QImage snapshot) {
+                                finishScreenShot(promise, flags, snapshot, geometry.topLeft());
+                            })) {
+        finishScreenShot(promise,
+                         flags,
+                         blitScreenshot(render_data, geometry, devicePixelRatio),
+                         geometry.topLeft());
     }
 
-    screenshot->promise.addResult(snapshot);
-    screenshot->promise.finish();
-
     return true;
 }
 
+void ScreenShotEffect::finishScreenShot(std::shared_ptr<QPromise<QImage>> const& promise,
+                                        ScreenShotFlags flags,
+                                        QImage snapshot,
+                                        QPoint const& offset)
+{
+    if (flags & ScreenShotIncludeCursor) {
+        grabPointerImage(snapshot, offset.x(), offset.y());
+    }
+
+    promise->addResult(snapshot);
+    promise->finish();
+}
+
 QImage ScreenShotEffect::blitScreenshot(effect::render_data& render_data,
                                         const QRect& geometry,
                                         qreal devicePixelRatio) const
@@ -381,6 +504,128 @@ QImage ScreenShotEffect::blitScreenshot(effect::render_data& render_data,
     return effects->blit_from_framebuffer(render_data, geometry, devicePixelRatio);
 }
 
+bool ScreenShotEffect::readbackScreenshot(effect::render_data& render_data,
+                                          const QRect& geometry,
+                                          qreal devicePixelRatio,
+                                          std::function<void(QImage)> callback)
+{
+    if (!effects->isOpenGLCompositing() || !asyncReadbackSupported()
+        || !GLFramebuffer::blitSupported()) {
+        return false;
+    }
+
+    // Same result as blitScreenshot, but the pixels are transferred asynchronously.
+    auto const nativeSize = effect::map_to_viewport(render_data, geometry).size() * devicePixelRatio;
+
+    GLTexture texture(GL_RGBA8, nativeSize.width(), nativeSize.height());
+    GLFramebuffer target(&texture);
+    if (!target.blit_from_current_render_target(
+            render_data, geometry, QRect({}, geometry.size()))) {
+        return false;
+    }
+
+    QImage image(nativeSize,
+                 GLPlatform::instance()->isGLES() ? QImage::Format_RGBA8888
+                                                  : QImage::Format_ARGB32);
+    image.setDevicePixelRatio(devicePixelRatio);
+
+    render::push_framebuffer(render_data, &target);
+    startReadback(std::move(image), std::move(callback));
+    render::pop_framebuffer(render_data);
+
+    return true;
+}
+
+void ScreenShotEffect::startReadback(QImage image, std::function<void(QImage)> callback)
+{
+    auto readback = std::make_unique<ScreenShotReadback>();
+    readback->image = std::move(image);
+    readback->callback = std::move(callback);
+
+    // Let the GPU write into a pixel buffer object. That does not block unlike reading into
+    // client memory.
+    glGenBuffers(1, &readback->buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, readback->image.sizeInBytes(), nullptr, GL_STREAM_READ);
+    glReadPixels(0,
+                 0,
+                 readback->image.width(),
+                 readback->image.height(),
+                 GL_RGBA,
+                 GL_UNSIGNED_BYTE,
+                 nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    m_readbacks.push_back(std::move(readback));
+    m_readbackTimer.start();
+}
+
+void ScreenShotEffect::checkReadbacks()
+{
+    std::vector<std::unique_ptr<ScreenShotReadback>> done;
+
+    for (auto it = m_readbacks.begin(); it != m_readbacks.end();) {
+        auto& readback = *it;
+        auto const status = glClientWaitSync(readback->fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            ++it;
+            continue;
+        }
+
+        if (status == GL_WAIT_FAILED) {
+            qCWarning(KWIN_SCREENSHOT) << "Failed to wait for screenshot readback";
+            readback->callback = {};
+        } else {
+            auto const size = readback->image.sizeInBytes();
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+            if (auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT)) {
+                std::memcpy(readback->image.bits(), data, size);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            } else {
+                qCWarning(KWIN_SCREENSHOT) << "Failed to map screenshot readback buffer";
+                readback->callback = {};
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        glDeleteSync(readback->fence);
+        glDeleteBuffers(1, &readback->buffer);
+
+        done.push_back(std::move(readback));
+        it = m_readbacks.erase(it);
+    }
+
+    if (m_readbacks.empty()) {
+        m_readbackTimer.stop();
+    }
+
+    // Callbacks of failed readbacks are reset. Their promises get cancelled on destruction.
+    for (auto& readback : done) {
+        if (readback->callback) {
+            readback->callback(std::move(readback->image));
+        }
+    }
+}
+
+void ScreenShotEffect::clearReadbacks()
+{
+    if (m_readbacks.empty()) {
+        return;
+    }
+
+    effects->makeOpenGLContextCurrent();
+    for (auto& readback : m_readbacks) {
+        glDeleteSync(readback->fence);
+        glDeleteBuffers(1, &readback->buffer);
+    }
+
+    m_readbacks.clear();
+    m_readbackTimer.stop();
+}
+
 void ScreenShotEffect::grabPointerImage(QImage& snapshot, int xOffset, int yOffset) const
 {
     if (effects->isCursorHidden()) {
@@ -401,7 +646,7 @@ void ScreenShotEffect::grabPointerImage(QImage& snapshot, int xOffset, int yOffs
 bool ScreenShotEffect::isActive() const
 {
     return (!m_windowScreenShots.empty() || !m_areaScreenShots.empty()
-            || !m_screenScreenShots.empty())
+            || !m_screenScreenShots.empty() || !m_readbacks.empty())
         && !effects->isScreenLocked();
 }
 
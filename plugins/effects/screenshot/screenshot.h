@@ -13,7 +13,11 @@
 #include <QFuture>
 #include <QImage>
 #include <QLoggingCategory>
+#include <QPromise>
 #include <QObject>
+#include <QTimer>
+#include <functional>
+#include <memory>
 
 Q_DECLARE_LOGGING_CATEGORY(KWIN_SCREENSHOT)
 
@@ -35,6 +39,7 @@ class ScreenShotDBusInterface2;
 struct ScreenShotWindowData;
 struct ScreenShotAreaData;
 struct ScreenShotScreenData;
+struct ScreenShotReadback;
 
 /**
  * The ScreenShotEffect provides a convenient way to capture the contents of a given window,
@@ -74,6 +79,10 @@ public:
 
     void paintScreen(effect::screen_paint_data& data) override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
     int requestedEffectChainPosition() const override;
 
     static bool supported();
@@ -85,7 +94,8 @@ private Q_SLOTS:
 
 private:
     void takeScreenShot(effect::render_data& data, ScreenShotWindowData* screenshot);
-    bool takeScreenShot(effect::render_data& render_data, ScreenShotAreaData* screenshot);
+    bool takeScreenShot(effect::render_data& render_data,
+                        std::shared_ptr<ScreenShotAreaData> const& screenshot);
     bool takeScreenShot(effect::render_data& render_data, ScreenShotScreenData* screenshot);
 
     void cancelWindowScreenShots();
@@ -96,11 +106,27 @@ private:
     QImage blitScreenshot(effect::render_data& viewport,
                           const QRect& geometry,
                           qreal devicePixelRatio = 1.0) const;
+    bool readbackScreenshot(effect::render_data& render_data,
+                            const QRect& geometry,
+                            qreal devicePixelRatio,
+                            std::function<void(QImage)> callback);
+    void finishScreenShot(std::shared_ptr<QPromise<QImage>> const& promise,
+                          ScreenShotFlags flags,
+                          QImage snapshot,
+                          QPoint const& offset);
+
+    void startReadback(QImage image, std::function<void(QImage)> callback);
+    void checkReadbacks();
+    void clearReadbacks();
 
     std::vector<ScreenShotWindowData> m_windowScreenShots;
-    std::vector<ScreenShotAreaData> m_areaScreenShots;
+    std::vector<std::shared_ptr<ScreenShotAreaData>> m_areaScreenShots;
     std::vector<ScreenShotScreenData> m_screenScreenShots;
 
+    // Pixel transfers from the GPU in flight. They are polled until their fence is signaled.
+    std::vector<std::unique_ptr<ScreenShotReadback>> m_readbacks;
+    QTimer m_readbackTimer;
+
     QScopedPointer<ScreenShotDBusInterface2> m_dbusInterface2;
     EffectScreen const* m_paintedScreen{nullptr};
 };
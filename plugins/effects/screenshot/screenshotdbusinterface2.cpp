@@ -16,14 +16,17 @@
 #include <como/render/effect/interface/effects_handler.h>
 
 #include <KLocalizedString>
+#include <QDBusArgument>
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
+#include <QPainter>
 #include <QThreadPool>
 
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 namespace como
@@ -104,6 +107,155 @@ protected:
     QImage m_image;
 };
 
+static constexpr quint32 fourccCode(char a, char b, char c, char d)
+{
+    return quint32(a) | (quint32(b) << 8) | (quint32(c) << 16) | (quint32(d) << 24);
+}
+
+static constexpr quint32 s_formatArgb8888 = fourccCode('A', 'R', '2', '4');
+static constexpr quint32 s_formatXrgb8888 = fourccCode('X', 'R', '2', '4');
+static constexpr quint32 s_formatAbgr8888 = fourccCode('A', 'B', '2', '4');
+static constexpr quint32 s_formatXbgr8888 = fourccCode('X', 'B', '2', '4');
+static constexpr quint64 s_modifierLinear = 0;
+
+static QImage::Format imageFormatFromFourcc(quint32 format)
+{
+    // DRM formats are little-endian, while the 32 bit QImage formats are native-endian.
+    if (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
+        if (format == s_formatArgb8888) {
+            return QImage::Format_ARGB32_Premultiplied;
+        }
+        if (format == s_formatXrgb8888) {
+            return QImage::Format_RGB32;
+        }
+    }
+
+    if (format == s_formatAbgr8888) {
+        return QImage::Format_RGBA8888_Premultiplied;
+    }
+    if (format == s_formatXbgr8888) {
+        return QImage::Format_RGBX8888;
+    }
+
+    return QImage::Format_Invalid;
+}
+
+/**
+ * Picks the first format from the client's list we can write. Returns 0 if there is none.
+ */
+static quint32 negotiateBufferFormat(const QVariantMap& options)
+{
+    auto const modifiers = options.value(QStringLiteral("modifiers"));
+    if (modifiers.isValid()
+        && !qdbus_cast<QList<qulonglong>>(modifiers).contains(s_modifierLinear)) {
+        return 0;
+    }
+
+    QList<uint> formats{s_formatArgb8888};
+    if (auto const formatsOption = options.value(QStringLiteral("formats"));
+        formatsOption.isValid()) {
+        formats = qdbus_cast<QList<uint>>(formatsOption);
+    }
+
+    for (auto format : std::as_const(formats)) {
+        if (imageFormatFromFourcc(format) != QImage::Format_Invalid) {
+            return format;
+        }
+    }
+
+    return 0;
+}
+
+class ScreenShotBufferWriter2 : public QRunnable
+{
+public:
+    ScreenShotBufferWriter2(QDBusMessage replyMessage,
+                            quint32 format,
+                            const QImage& image,
+                            const QVariantMap& attributes)
+        : m_replyMessage(replyMessage)
+        , m_format(format)
+        , m_image(image)
+        , m_attributes(attributes)
+    {
+    }
+
+    void run() override
+    {
+        auto const imageFormat = imageFormatFromFourcc(m_format);
+        auto const stride = m_image.width() * 4;
+        auto const size = static_cast<size_t>(stride) * m_image.height();
+
+        file_descriptor fd(memfd_create("como-screenshot", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+        if (!fd.is_valid()) {
+            qCWarning(KWIN_SCREENSHOT) << "failed to create screenshot buffer:" << strerror(errno);
+            sendError();
+            return;
+        }
+        if (ftruncate(fd.fd, size) == -1) {
+            qCWarning(KWIN_SCREENSHOT) << "failed to resize screenshot buffer:" << strerror(errno);
+            sendError();
+            return;
+        }
+
+        auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.fd, 0);
+        if (data == MAP_FAILED) {
+            qCWarning(KWIN_SCREENSHOT) << "failed to map screenshot buffer:" << strerror(errno);
+            sendError();
+            return;
+        }
+
+        // Write the pixels once, converting them on the fly if the client wants another format.
+        QImage target(static_cast<uchar*>(data),
+                      m_image.width(),
+                      m_image.height(),
+                      stride,
+                      imageFormat);
+        if (m_image.format() == imageFormat) {
+            for (int y = 0; y < m_image.height(); ++y) {
+                memcpy(target.scanLine(y), m_image.constScanLine(y), stride);
+            }
+        } else {
+            QPainter painter(&target);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.drawImage(target.rect(), m_image, m_image.rect());
+        }
+        munmap(data, size);
+
+        // The client can rely on the content not changing underneath it.
+        if (fcntl(fd.fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL)
+            == -1) {
+            qCWarning(KWIN_SCREENSHOT) << "failed to seal screenshot buffer:" << strerror(errno);
+        }
+
+        // Note that the type of the data stored in the vardict matters. Be careful.
+        QVariantMap results = m_attributes;
+        results.insert(QStringLiteral("type"), QStringLiteral("shm"));
+        results.insert(QStringLiteral("format"), quint32(m_format));
+        results.insert(QStringLiteral("modifier"), quint64(s_modifierLinear));
+        results.insert(QStringLiteral("width"), quint32(m_image.width()));
+        results.insert(QStringLiteral("height"), quint32(m_image.height()));
+        results.insert(QStringLiteral("stride"), quint32(stride));
+        results.insert(QStringLiteral("scale"), double(m_image.devicePixelRatio()));
+
+        QDBusConnection::sessionBus().send(m_replyMessage.createReply(
+            QVariantList{results, QVariant::fromValue(QDBusUnixFileDescriptor(fd.fd))}));
+    }
+
+private:
+    void sendError()
+    {
+        QDBusConnection::sessionBus().send(m_replyMessage.createErrorReply(
+            QStringLiteral("org.kde.KWin.ScreenShot2.Error.Buffer"),
+            QStringLiteral("Failed to create the screenshot buffer")));
+    }
+
+    QDBusMessage m_replyMessage;
+    quint32 m_format;
+    QImage m_image;
+    QVariantMap m_attributes;
+};
+
 static ScreenShotFlags screenShotFlagsFromOptions(const QVariantMap& options)
 {
     ScreenShotFlags flags = ScreenShotFlags();
@@ -153,6 +305,10 @@ static const QString s_errorInvalidScreenMessage = QStringLiteral("Invalid scree
 static const QString s_errorFileDescriptor
     = QStringLiteral("org.kde.KWin.ScreenShot2.Error.FileDescriptor");
 static const QString s_errorFileDescriptorMessage = QStringLiteral("No valid file descriptor");
+static const QString s_errorUnsupportedFormat
+    = QStringLiteral("org.kde.KWin.ScreenShot2.Error.UnsupportedFormat");
+static const QString s_errorUnsupportedFormatMessage
+    = QStringLiteral("None of the requested buffer formats is supported");
 
 class ScreenShotSource2 : public QObject
 {
@@ -164,6 +320,7 @@ public:
     bool isCancelled() const;
     bool isCompleted() const;
     void marshal(ScreenShotSinkPipe2* sink);
+    void marshal(ScreenShotSinkBuffer2* sink);
 
     virtual QVariantMap attributes() const;
 
@@ -226,6 +383,21 @@ private:
     file_descriptor m_fileDescriptor;
 };
 
+class ScreenShotSinkBuffer2 : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScreenShotSinkBuffer2(QDBusMessage replyMessage, quint32 format);
+
+    void cancel();
+    void flush(const QImage& image, const QVariantMap& attributes);
+
+private:
+    QDBusMessage m_replyMessage;
+    quint32 m_format;
+};
+
 ScreenShotSource2::ScreenShotSource2(const QFuture<QImage>& future)
     : m_future(future)
 {
@@ -255,6 +427,11 @@ void ScreenShotSource2::marshal(ScreenShotSinkPipe2* sink)
     sink->flush(m_future.result(), attributes());
 }
 
+void ScreenShotSource2::marshal(ScreenShotSinkBuffer2* sink)
+{
+    sink->flush(m_future.result(), attributes());
+}
+
 ScreenShotSourceScreen2::ScreenShotSourceScreen2(ScreenShotEffect* effect,
                                                  EffectScreen* screen,
                                                  ScreenShotFlags flags)
@@ -327,6 +504,26 @@ void ScreenShotSinkPipe2::flush(const QImage& image, const QVariantMap& attribut
     QThreadPool::globalInstance()->start(writer);
 }
 
+ScreenShotSinkBuffer2::ScreenShotSinkBuffer2(QDBusMessage replyMessage, quint32 format)
+    : m_replyMessage(replyMessage)
+    , m_format(format)
+{
+}
+
+void ScreenShotSinkBuffer2::cancel()
+{
+    QDBusConnection::sessionBus().send(
+        m_replyMessage.createErrorReply(s_errorCancelled, s_errorCancelledMessage));
+}
+
+void ScreenShotSinkBuffer2::flush(const QImage& image, const QVariantMap& attributes)
+{
+    // Writing the buffer is done on a worker thread, which also sends the reply.
+    auto writer = new ScreenShotBufferWriter2(m_replyMessage, m_format, image, attributes);
+    writer->setAutoDelete(true);
+    QThreadPool::globalInstance()->start(writer);
+}
+
 ScreenShotDBusInterface2::ScreenShotDBusInterface2(ScreenShotEffect* effect)
     : QObject(effect)
     , m_effect(effect)
@@ -345,7 +542,7 @@ ScreenShotDBusInterface2::~ScreenShotDBusInterface2()
 
 int ScreenShotDBusInterface2::version() const
 {
-    return 4;
+    return 5;
 }
 
 bool ScreenShotDBusInterface2::checkPermissions() const
@@ -597,6 +794,34 @@ QVariantMap ScreenShotDBusInterface2::CaptureWorkspace(const QVariantMap& option
     return QVariantMap();
 }
 
+QVariantMap ScreenShotDBusInterface2::CaptureScreenToBuffer(const QString& name,
+                                                            const QVariantMap& options,
+                                                            QDBusUnixFileDescriptor& /*buffer*/)
+{
+    if (!checkPermissions()) {
+        return QVariantMap();
+    }
+
+    EffectScreen* screen = effects->findScreen(name);
+    if (!screen) {
+        sendErrorReply(s_errorInvalidScreen, s_errorInvalidScreenMessage);
+        return QVariantMap();
+    }
+
+    auto const format = negotiateBufferFormat(options);
+    if (!format) {
+        sendErrorReply(s_errorUnsupportedFormat, s_errorUnsupportedFormatMessage);
+        return QVariantMap();
+    }
+
+    // The buffer is returned with the delayed reply.
+    bind(new ScreenShotSinkBuffer2(message(), format),
+         new ScreenShotSourceScreen2(m_effect, screen, screenShotFlagsFromOptions(options)));
+
+    setDelayedReply(true);
+    return QVariantMap();
+}
+
 void ScreenShotDBusInterface2::bind(ScreenShotSinkPipe2* sink, ScreenShotSource2* source)
 {
     connect(source, &ScreenShotSource2::cancelled, sink, [sink, source]() {
@@ -614,6 +839,23 @@ void ScreenShotDBusInterface2::bind(ScreenShotSinkPipe2* sink, ScreenShotSource2
     });
 }
 
+void ScreenShotDBusInterface2::bind(ScreenShotSinkBuffer2* sink, ScreenShotSource2* source)
+{
+    connect(source, &ScreenShotSource2::cancelled, sink, [sink, source]() {
+        sink->cancel();
+
+        sink->deleteLater();
+        source->deleteLater();
+    });
+
+    connect(source, &ScreenShotSource2::completed, sink, [sink, source]() {
+        source->marshal(sink);
+
+        sink->deleteLater();
+        source->deleteLater();
+    });
+}
+
 void ScreenShotDBusInterface2::takeScreenShot(EffectScreen* screen,
                                               ScreenShotFlags flags,
                                               ScreenShotSinkPipe2* sink)
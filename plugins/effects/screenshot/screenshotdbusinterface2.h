@@ -18,6 +18,7 @@ namespace como
 {
 
 class ScreenShotEffect;
+class ScreenShotSinkBuffer2;
 class ScreenShotSinkPipe2;
 class ScreenShotSource2;
 
@@ -55,6 +56,9 @@ public Q_SLOTS:
     QVariantMap
     CaptureInteractive(uint kind, const QVariantMap& options, QDBusUnixFileDescriptor pipe);
     QVariantMap CaptureWorkspace(const QVariantMap& options, QDBusUnixFileDescriptor pipe);
+    QVariantMap CaptureScreenToBuffer(const QString& name,
+                                      const QVariantMap& options,
+                                      QDBusUnixFileDescriptor& buffer);
 
 private:
     void takeScreenShot(EffectScreen* screen, ScreenShotFlags flags, ScreenShotSinkPipe2* sink);
@@ -62,6 +66,7 @@ private:
     void takeScreenShot(EffectWindow* window, ScreenShotFlags flags, ScreenShotSinkPipe2* sink);
 
     void bind(ScreenShotSinkPipe2* sink, ScreenShotSource2* source);
+    void bind(ScreenShotSinkBuffer2* sink, ScreenShotSource2* source);
     bool checkPermissions() const;
 
     ScreenShotEffect* m_effect;
@@ -39,6 +39,10 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     void paintWindow(effect::window_paint_data& data) override;
     void postPaintScreen() override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
     static bool supported();
 
@@ -22,6 +22,10 @@ public:
     void paintWindow(effect::window_paint_data& data) override;
 
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
 private Q_SLOTS:
     void toggle();
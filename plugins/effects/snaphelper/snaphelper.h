@@ -28,6 +28,10 @@ public:
     void postPaintScreen() override;
 
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
 private Q_SLOTS:
     void slotWindowAdded(EffectWindow* w);
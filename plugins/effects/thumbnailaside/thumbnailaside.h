@@ -52,6 +52,10 @@ public:
         return screen;
     }
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
 private Q_SLOTS:
     void toggleCurrentThumbnail();
@@ -26,6 +26,10 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     void postPaintScreen() override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
     bool touchDown(qint32 id, const QPointF& pos, quint32 time) override;
     bool touchMotion(qint32 id, const QPointF& pos, quint32 time) override;
     bool touchUp(qint32 id, quint32 time) override;
@@ -32,6 +32,10 @@ public:
     void postPaintScreen() override;
     void reconfigure(ReconfigureFlags) override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
 
     // for properties
     Qt::KeyboardModifiers modifiers() const
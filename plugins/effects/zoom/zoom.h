@@ -45,6 +45,10 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     void postPaintScreen() override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
     int requestedEffectChainPosition() const override;
     // for properties
     qreal configuredZoomFactor() const;
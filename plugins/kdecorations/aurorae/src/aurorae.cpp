@@ -316,17 +316,17 @@ bool Decoration::init()
         m_item->setParentItem(visualParent.value<QQuickItem*>());
         visualParent.value<QQuickItem*>()->setProperty("drawBackground", false);
     } else {
-        m_view = std::make_unique<como::OffscreenQuickView>(
-            como::OffscreenQuickView::ExportMode::Image);
-        m_item->setParentItem(m_view->contentItem());
-        auto updateSize = [this]() { m_item->setSize(m_view->contentItem()->size()); };
-        updateSize();
-        connect(m_view->contentItem(), &QQuickItem::widthChanged, m_item, updateSize);
-        connect(m_view->contentItem(), &QQuickItem::heightChanged, m_item, updateSize);
-        connect(m_view.get(),
-                &como::OffscreenQuickView::repaintNeeded,
+        createView();
+
+        // The compositor was restarted, for example with another backend or after a GL reset.
+        connect(s.get(),
+                &KDecoration2::DecorationSettings::alphaChannelSupportedChanged,
                 this,
-                &Decoration::updateBuffer);
+                [this] {
+                    if (como::effects) {
+                        createView();
+                    }
+                });
     }
 
     m_supportsMask = m_item->property("supportsMask").toBool();
@@ -383,8 +383,13 @@ bool Decoration::init()
                     -m_padding->left(), -m_padding->top(), m_padding->right(), m_padding->bottom());
             }
             m_view->setGeometry(rect);
+            m_view->requestImage();
             updateBlur();
         };
+        // The shadow is taken from an image of the view and only changes with these.
+        auto requestImage = [this] { m_view->requestImage(); };
+        connect(client(), &KDecoration2::DecoratedClient::activeChanged, this, requestImage);
+        connect(this, &Decoration::configChanged, this, requestImage);
         connect(this, &Decoration::bordersChanged, this, resizeWindow);
         connect(client(), &KDecoration2::DecoratedClient::widthChanged, this, resizeWindow);
         connect(client(), &KDecoration2::DecoratedClient::heightChanged, this, resizeWindow);
@@ -404,6 +409,30 @@ bool Decoration::init()
     return true;
 }
 
+void Decoration::createView()
+{
+    // With OpenGL compositing the scene copies the decoration from the view's texture.
+    m_exportTexture = como::effects && como::effects->isOpenGLCompositing();
+
+    auto view = std::make_unique<como::OffscreenQuickView>(
+        m_exportTexture ? como::OffscreenQuickView::ExportMode::Texture
+                        : como::OffscreenQuickView::ExportMode::Image);
+    m_item->setParentItem(view->contentItem());
+
+    if (m_view) {
+        view->setGeometry(m_view->geometry());
+        view->requestImage();
+    }
+    m_view = std::move(view);
+
+    auto updateSize = [this]() { m_item->setSize(m_view->contentItem()->size()); };
+    updateSize();
+    connect(m_view->contentItem(), &QQuickItem::widthChanged, m_item, updateSize);
+    connect(m_view->contentItem(), &QQuickItem::heightChanged, m_item, updateSize);
+    connect(
+        m_view.get(), &como::OffscreenQuickView::repaintNeeded, this, &Decoration::updateBuffer);
+}
+
 QVariant Decoration::readConfig(const QString& key, const QVariant& defaultValue)
 {
     KSharedConfigPtr config = KSharedConfig::openConfig(QStringLiteral("auroraerc"));
@@ -440,6 +469,15 @@ void Decoration::paint(QPainter* painter, const QRect& repaintRegion)
     }
 
     const QImage image = m_view->bufferAsImage();
+    if (image.isNull()) {
+        if (m_exportTexture) {
+            // Painted without the texture, for example while compositing is suspended.
+            m_view->requestImage();
+            QMetaObject::invokeMethod(
+                m_view.get(), &como::OffscreenQuickView::update, Qt::QueuedConnection);
+        }
+        return;
+    }
     const qreal dpr = image.devicePixelRatioF();
 
     QRect nativeContentRect = QRect(m_contentRect.topLeft() * dpr, m_contentRect.size() * dpr);
@@ -448,6 +486,20 @@ void Decoration::paint(QPainter* painter, const QRect& repaintRegion)
     painter->drawImage(rect(), image, nativeContentRect);
 }
 
+como::GLTexture* Decoration::decorationTexture()
+{
+    if (!m_view || !m_exportTexture) {
+        return nullptr;
+    }
+    return m_view->bufferAsTexture();
+}
+
+QRect Decoration::decorationTextureRect() const
+{
+    const qreal dpr = m_view->window()->devicePixelRatio();
+    return QRect(m_contentRect.topLeft() * dpr, m_contentRect.size() * dpr);
+}
+
 void Decoration::updateShadow()
 {
     if (!m_view) {
@@ -468,6 +520,10 @@ void Decoration::updateShadow()
             }
         }
         const QImage m_buffer = m_view->bufferAsImage();
+        if (m_buffer.isNull()) {
+            // keep the current shadow until the view provides an image again
+            return;
+        }
         const qreal dpr = m_buffer.devicePixelRatioF();
 
         QImage img(m_buffer.size() / m_buffer.devicePixelRatioF(),
@@ -655,8 +711,7 @@ void Decoration::updateBlur()
 
 void Decoration::updateBuffer()
 {
-    const QImage buffer = m_view->bufferAsImage();
-    if (buffer.isNull()) {
+    if (!m_exportTexture && m_view->bufferAsImage().isNull()) {
         return;
     }
     m_contentRect = QRect(QPoint(0, 0), m_view->contentItem()->size().toSize());
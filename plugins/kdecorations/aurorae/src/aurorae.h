@@ -15,6 +15,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef AURORAE_H
 #define AURORAE_H
 
+#include <como/render/gl/interface/decoration_texture.h>
+
 #include <KDecoration2/DecoratedClient>
 #include <KDecoration2/Decoration>
 #include <KDecoration2/DecorationThemeProvider>
@@ -38,9 +40,10 @@ class OffscreenQuickView;
 namespace Aurorae
 {
 
-class Decoration : public KDecoration2::Decoration
+class Decoration : public KDecoration2::Decoration, public como::DecorationTextureSource
 {
     Q_OBJECT
+    Q_INTERFACES(como::DecorationTextureSource)
     Q_PROPERTY(KDecoration2::DecoratedClient* client READ client CONSTANT)
     Q_PROPERTY(QQuickItem* item READ item)
 public:
@@ -49,6 +52,9 @@ public:
 
     void paint(QPainter* painter, const QRect& repaintRegion) override;
 
+    como::GLTexture* decorationTexture() override;
+    QRect decorationTextureRect() const override;
+
     Q_INVOKABLE QVariant readConfig(const QString& key, const QVariant& defaultValue = QVariant());
 
     QQuickItem* item() const;
@@ -72,12 +78,15 @@ protected:
     void mouseReleaseEvent(QMouseEvent* event) override;
 
 private:
+    void createView();
     void setupBorders(QQuickItem* item);
     void updateBorders();
     void updateBuffer();
     void updateExtendedBorders();
 
     bool m_supportsMask{false};
+    // if the view is exported as texture and images are only requested for the shadow
+    bool m_exportTexture{false};
 
     QRect m_contentRect; // the geometry of the part of the buffer that is not a shadow when buffer
                          // was created.
@@ -53,6 +53,27 @@ TEST_CASE("fade", "[effect]")
     auto fade_effect = effectLoadedSpy.first().first().value<Effect*>();
     QVERIFY(fade_effect);
 
+    SECTION("blocks direct scanout while animating")
+    {
+        // Fullscreen windows must not be shown without compositing while the effect animates.
+        QVERIFY(!fade_effect->isActive());
+        QVERIFY(!e->blocksDirectScanout());
+
+        std::unique_ptr<Surface> surface(create_surface());
+        std::unique_ptr<XdgShellToplevel> shellSurface(create_xdg_shell_toplevel(surface));
+        auto c = render_and_wait_for_shown(surface, QSize(100, 50), Qt::blue);
+        QVERIFY(c);
+
+        QTRY_VERIFY(fade_effect->isActive());
+        QVERIFY(e->blocksDirectScanout());
+
+        QTRY_VERIFY(!fade_effect->isActive());
+        QVERIFY(!e->blocksDirectScanout());
+
+        // Fullscreen windows are also only unredirected when enabled by the user.
+        QVERIFY(!setup.base->mod.render->options->qobject->isUnredirectFullscreen());
+    }
+
     SECTION("window close after hidden")
     {
         // this test simulates the showing/hiding/closing of a Wayland window
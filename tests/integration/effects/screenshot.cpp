@@ -0,0 +1,187 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <KConfigGroup>
+#include <KSycoca>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingReply>
+#include <QDBusUnixFileDescriptor>
+#include <catch2/generators/catch_generators.hpp>
+#include <drm_fourcc.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+QString const s_service{QStringLiteral("org.kde.KWin.ScreenShot2")};
+QString const s_path{QStringLiteral("/org/kde/KWin/ScreenShot2")};
+QString const s_interface{QStringLiteral("org.kde.KWin.ScreenShot2")};
+
+using buffer_reply = QDBusPendingReply<QVariantMap, QDBusUnixFileDescriptor>;
+
+/// Restricted D-Bus interfaces are only available to applications that request them in their
+/// desktop file.
+void install_desktop_file()
+{
+    auto const dir = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
+    QVERIFY(QDir().mkpath(dir));
+
+    QFile file(dir + QStringLiteral("/org.kde.como.tests.desktop"));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QByteArrayLiteral("[Desktop Entry]\n"
+                                 "Type=Application\n"
+                                 "Name=Tests\n"
+                                 "X-KDE-DBUS-Restricted-Interfaces=org.kde.KWin.ScreenShot2\n"
+                                 "Exec=")
+               + QCoreApplication::applicationFilePath().toUtf8() + '\n');
+    file.close();
+
+    KSycoca::self()->ensureCacheValid();
+}
+
+}
+
+TEST_CASE("screenshot", "[effect]")
+{
+    qRegisterMetaType<como::Effect*>();
+
+    test::setup setup("screenshot");
+
+    // disable all effects - we don't want to have it interact with the rendering
+    auto config = setup.base->config.main;
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    auto const builtinNames = render::effect_loader(*setup.base->mod.render).listOfKnownEffects();
+
+    for (const QString& name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+
+    config->sync();
+
+    setup.start();
+    QVERIFY(setup.base->mod.render);
+    install_desktop_file();
+
+    auto& e = setup.base->mod.render->effects;
+    QVERIFY(e->loadEffect(QStringLiteral("screenshot")));
+    QVERIFY(e->isEffectLoaded(QStringLiteral("screenshot")));
+
+    auto const output = setup.base->outputs.at(0);
+
+    // Calls through the connection of the compositor would be local and can not be delayed.
+    auto connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus,
+                                                    QStringLiteral("screenshot-test-client"));
+    QVERIFY(connection.isConnected());
+
+    auto capture = [&](QVariantMap const& options) {
+        auto msg = QDBusMessage::createMethodCall(
+            s_service, s_path, s_interface, QStringLiteral("CaptureScreenToBuffer"));
+        msg.setArguments({output->name(), options});
+        return buffer_reply(connection.asyncCall(msg));
+    };
+
+    SECTION("format negotiation")
+    {
+        struct data {
+            QList<uint> formats;
+            QList<qulonglong> modifiers;
+            uint format;
+        };
+
+        // The first supported format of the client's list is picked. Without a list it is
+        // ARGB8888.
+        auto test_data = GENERATE(
+            data{{}, {}, DRM_FORMAT_ARGB8888},
+            data{{DRM_FORMAT_XRGB8888}, {}, DRM_FORMAT_XRGB8888},
+            data{{DRM_FORMAT_NV12, DRM_FORMAT_XBGR8888, DRM_FORMAT_ARGB8888},
+                 {},
+                 DRM_FORMAT_XBGR8888},
+            data{{DRM_FORMAT_ABGR8888},
+                 {I915_FORMAT_MOD_X_TILED, DRM_FORMAT_MOD_LINEAR},
+                 DRM_FORMAT_ABGR8888});
+
+        QVariantMap options;
+        if (!test_data.formats.isEmpty()) {
+            options.insert(QStringLiteral("formats"), QVariant::fromValue(test_data.formats));
+        }
+        if (!test_data.modifiers.isEmpty()) {
+            options.insert(QStringLiteral("modifiers"), QVariant::fromValue(test_data.modifiers));
+        }
+
+        auto reply = capture(options);
+        QTRY_VERIFY(reply.isFinished());
+        QVERIFY(!reply.isError());
+
+        auto const results = reply.argumentAt<0>();
+        QCOMPARE(results.value(QStringLiteral("type")).toString(), QStringLiteral("shm"));
+        QCOMPARE(results.value(QStringLiteral("format")).toUInt(), test_data.format);
+        QCOMPARE(results.value(QStringLiteral("modifier")).toULongLong(), DRM_FORMAT_MOD_LINEAR);
+        QCOMPARE(results.value(QStringLiteral("screen")).toString(), output->name());
+
+        auto const size = output->geometry().size();
+        QCOMPARE(results.value(QStringLiteral("width")).toInt(), size.width());
+        QCOMPARE(results.value(QStringLiteral("height")).toInt(), size.height());
+        QCOMPARE(results.value(QStringLiteral("stride")).toInt(), size.width() * 4);
+    }
+
+    SECTION("unsupported format")
+    {
+        struct data {
+            QList<uint> formats;
+            QList<qulonglong> modifiers;
+        };
+
+        auto test_data
+            = GENERATE(data{{DRM_FORMAT_NV12}, {DRM_FORMAT_MOD_LINEAR}},
+                       data{{DRM_FORMAT_ARGB8888}, {I915_FORMAT_MOD_X_TILED}});
+
+        auto reply = capture({{QStringLiteral("formats"), QVariant::fromValue(test_data.formats)},
+                              {QStringLiteral("modifiers"),
+                               QVariant::fromValue(test_data.modifiers)}});
+        QTRY_VERIFY(reply.isFinished());
+        QVERIFY(reply.isError());
+        QCOMPARE(reply.error().name(),
+                 QStringLiteral("org.kde.KWin.ScreenShot2.Error.UnsupportedFormat"));
+    }
+
+    SECTION("sealed buffer")
+    {
+        auto reply = capture({});
+        QTRY_VERIFY(reply.isFinished());
+        QVERIFY(!reply.isError());
+
+        auto const results = reply.argumentAt<0>();
+        auto const fd = reply.argumentAt<1>().fileDescriptor();
+        QVERIFY(fd != -1);
+
+        // The buffer can not be changed anymore by the compositor or the client.
+        auto const seals = fcntl(fd, F_GET_SEALS);
+        QCOMPARE(seals, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+
+        auto const size = static_cast<size_t>(results.value(QStringLiteral("stride")).toUInt())
+            * results.value(QStringLiteral("height")).toUInt();
+
+        struct stat info;
+        QCOMPARE(fstat(fd, &info), 0);
+        QCOMPARE(static_cast<size_t>(info.st_size), size);
+
+        QCOMPARE(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0), MAP_FAILED);
+        QCOMPARE(ftruncate(fd, 0), -1);
+
+        auto data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        QVERIFY(data != MAP_FAILED);
+        munmap(data, size);
+    }
+}
+
+}
@@ -8,12 +8,13 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <QPainter>
 #include <QRasterWindow>
 #include <QTimer>
+#include <cstdlib>
 
 class Window : public QRasterWindow
 {
     Q_OBJECT
 public:
-    explicit Window(QClipboard::Mode mode);
+    Window(QClipboard::Mode mode, QString const& text);
     ~Window() override;
 
 protected:
@@ -22,11 +23,13 @@ protected:
 
 private:
     QClipboard::Mode m_mode;
+    QString m_text;
 };
 
-Window::Window(QClipboard::Mode mode)
+Window::Window(QClipboard::Mode mode, QString const& text)
     : QRasterWindow()
     , m_mode(mode)
+    , m_text(text)
 {
 }
 
@@ -43,7 +46,7 @@ void Window::focusInEvent(QFocusEvent* event)
 {
     QRasterWindow::focusInEvent(event);
     // TODO: make it work without singleshot
-    QTimer::singleShot(100, [this] { qApp->clipboard()->setText(QStringLiteral("test"), m_mode); });
+    QTimer::singleShot(100, [this] { qApp->clipboard()->setText(m_text, m_mode); });
 }
 
 int main(int argc, char* argv[])
@@ -53,8 +56,13 @@ int main(int argc, char* argv[])
         mode = QClipboard::Selection;
     }
 
+    // An optional first argument is the size of the copied text in bytes.
+    QString text = QStringLiteral("test");
+    if (argc > 2) {
+        text = QString(atoi(argv[1]), QLatin1Char('c'));
+    }
     QGuiApplication app(argc, argv);
-    std::unique_ptr<Window> w(new Window(mode));
+    std::unique_ptr<Window> w(new Window(mode, text));
     w->setGeometry(QRect(0, 0, 100, 200));
     w->show();
 
@@ -8,6 +8,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <QPainter>
 #include <QRasterWindow>
 #include <QTimer>
+#include <cstdlib>
 
 class Window : public QRasterWindow
 {
@@ -41,9 +42,14 @@ int main(int argc, char* argv[])
         mode = QClipboard::Selection;
     }
 
+    // An optional first argument is the size of the expected text in bytes.
+    QString text = QStringLiteral("test");
+    if (argc > 2) {
+        text = QString(atoi(argv[1]), QLatin1Char('c'));
+    }
     QGuiApplication app(argc, argv);
-    QObject::connect(app.clipboard(), &QClipboard::changed, &app, [mode] {
-        if (qApp->clipboard()->text(mode) == QLatin1String("test")) {
+    QObject::connect(app.clipboard(), &QClipboard::changed, &app, [mode, text] {
+        if (qApp->clipboard()->text(mode) == text) {
             QTimer::singleShot(100, qApp, &QCoreApplication::quit);
         }
     });
@@ -0,0 +1,113 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <Wrapland/Client/keyboard.h>
+#include <Wrapland/Client/pointer.h>
+#include <Wrapland/Client/seat.h>
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <chrono>
+#include <linux/input.h>
+
+namespace como::detail::test
+{
+
+TEST_CASE("input latency", "[input],[render]")
+{
+    using latency_device = render::wayland::input_latency_device;
+
+    test::setup setup("input-latency");
+    setup.start();
+    setup_wayland_connection(global_selection::seat);
+    QVERIFY(wait_for_wayland_pointer());
+
+    auto& latency = setup.base->mod.render->presentation->latency;
+
+    // Device events are timed by the monotonic clock in milliseconds.
+    auto get_time = [] {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    };
+
+    auto surface = create_surface();
+    QVERIFY(surface);
+    auto toplevel = create_xdg_shell_toplevel(surface);
+    QVERIFY(toplevel);
+
+    auto window = render_and_wait_for_shown(surface, QSize(100, 50), Qt::blue);
+    QVERIFY(window);
+
+    auto get_count = [&](auto const& histograms, auto const& key) -> uint64_t {
+        auto it = histograms.find(key);
+        return it == histograms.end() ? 0 : it->second.count;
+    };
+
+    SECTION("pointer")
+    {
+        auto seat = get_client().interfaces.seat.get();
+        std::unique_ptr<Wrapland::Client::Pointer> pointer(seat->createPointer(seat));
+        QVERIFY(pointer);
+
+        QSignalSpy entered_spy(pointer.get(), &Wrapland::Client::Pointer::entered);
+        QVERIFY(entered_spy.isValid());
+
+        pointer_motion_absolute(window->geo.frame.center(), get_time());
+        QVERIFY(entered_spy.wait());
+
+        // Nothing is measured without a response of the client.
+        QCOMPARE(get_count(latency.devices, latency_device::pointer), 0);
+
+        render(surface, QSize(100, 50), Qt::red);
+        QTRY_COMPARE(get_count(latency.devices, latency_device::pointer), 1);
+        QVERIFY(latency.devices.at(latency_device::pointer).max < latency.max_latency);
+        QCOMPARE(latency.clients.size(), 1u);
+    }
+
+    SECTION("no monotonic time")
+    {
+        auto seat = get_client().interfaces.seat.get();
+        std::unique_ptr<Wrapland::Client::Pointer> pointer(seat->createPointer(seat));
+        QVERIFY(pointer);
+
+        QSignalSpy entered_spy(pointer.get(), &Wrapland::Client::Pointer::entered);
+        QVERIFY(entered_spy.isValid());
+
+        pointer_motion_absolute(window->geo.frame.center(), 1);
+        QVERIFY(entered_spy.wait());
+
+        QSignalSpy damaged_spy(window->qobject.get(), &win::window_qobject::damaged);
+        QVERIFY(damaged_spy.isValid());
+
+        render(surface, QSize(100, 50), Qt::red);
+        QVERIFY(damaged_spy.wait());
+
+        // The input time is too far off the presentation to be a time of the monotonic clock.
+        QTRY_VERIFY(!latency.is_pending());
+        QCOMPARE(get_count(latency.devices, latency_device::pointer), 0);
+    }
+
+    SECTION("keyboard")
+    {
+        auto seat = get_client().interfaces.seat.get();
+        std::unique_ptr<Wrapland::Client::Keyboard> keyboard(seat->createKeyboard(seat));
+        QVERIFY(keyboard);
+
+        QSignalSpy entered_spy(keyboard.get(), &Wrapland::Client::Keyboard::entered);
+        QVERIFY(entered_spy.isValid());
+        QVERIFY(entered_spy.wait());
+
+        auto time = get_time();
+        keyboard_key_pressed(KEY_A, time);
+        keyboard_key_released(KEY_A, time);
+
+        render(surface, QSize(100, 50), Qt::red);
+        QTRY_COMPARE(get_count(latency.devices, latency_device::keyboard), 1);
+    }
+}
+
+}
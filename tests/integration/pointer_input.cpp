@@ -210,6 +210,103 @@ TEST_CASE("pointer input", "[input]")
         QCOMPARE(movedSpy.last().first().toPointF(), QPointF(26, 26));
     }
 
+    SECTION("batched motions")
+    {
+        // With batching enabled motions are processed when the next frame starts. Non-motion
+        // events process them first.
+        using namespace Wrapland::Client;
+
+        auto& redirect = *setup.base->mod.space->input;
+        redirect.batch_motions = true;
+
+        auto pointer = seat->createPointer(seat);
+        QVERIFY(pointer);
+        QVERIFY(pointer->isValid());
+        QSignalSpy enteredSpy(pointer, &Pointer::entered);
+        QVERIFY(enteredSpy.isValid());
+
+        // Records the order in which the client receives the events.
+        std::vector<std::string> client_events;
+        QObject context;
+        QObject::connect(
+            pointer, &Pointer::motion, &context, [&] { client_events.push_back("motion"); });
+        QObject::connect(pointer, &Pointer::buttonStateChanged, &context, [&] {
+            client_events.push_back("button");
+        });
+
+        int client_frames{0};
+        QObject::connect(pointer, &Pointer::frame, &context, [&] { client_frames++; });
+
+        auto surface = create_surface();
+        QVERIFY(surface);
+        auto shellSurface = create_xdg_shell_toplevel(surface);
+        QVERIFY(shellSurface);
+        auto window = render_and_wait_for_shown(surface, QSize(100, 50), Qt::blue);
+        QVERIFY(window);
+        QVERIFY(window->geo.frame.contains(QPoint(25, 25)));
+
+        auto is_frame_scheduled = [&] {
+            auto const& outputs = setup.base->outputs;
+            return std::any_of(outputs.cbegin(), outputs.cend(), [](auto output) {
+                return output->render->is_frame_scheduled();
+            });
+        };
+
+        // Without a scheduled frame motions are processed right away.
+        QTRY_VERIFY(!is_frame_scheduled());
+        pointer_motion_absolute(QPointF(25, 25), 1);
+        QCOMPARE(cursor()->pos(), QPoint(25, 25));
+        QVERIFY(enteredSpy.wait());
+        client_events.clear();
+        client_frames = 0;
+
+        SECTION("batching")
+        {
+            setup.base->mod.render->addRepaint(QRegion(0, 0, 1280, 1024));
+            QVERIFY(is_frame_scheduled());
+
+            pointer_motion_absolute(QPointF(30, 30), 2);
+            pointer_motion_absolute(QPointF(35, 35), 3);
+            pointer_motion_absolute(QPointF(40, 40), 4);
+            QCOMPARE(cursor()->pos(), QPoint(25, 25));
+
+            // Of the batched absolute motions only the last one is processed.
+            QTRY_COMPARE(cursor()->pos(), QPoint(40, 40));
+            QTRY_COMPARE(client_events.size(), 1);
+            QCOMPARE(client_events.front(), "motion");
+
+            // The frames of the device are held back. The batch ends with a single frame.
+            QTRY_COMPARE(client_frames, 1);
+        }
+
+        SECTION("button after motion")
+        {
+            setup.base->mod.render->addRepaint(QRegion(0, 0, 1280, 1024));
+            QVERIFY(is_frame_scheduled());
+
+            pointer_motion_absolute(QPointF(30, 30), 2);
+            pointer_button_pressed(BTN_LEFT, 3);
+            QCOMPARE(cursor()->pos(), QPoint(30, 30));
+
+            QTRY_COMPARE(client_events.size(), 2);
+            QCOMPARE(client_events.at(0), "motion");
+            QCOMPARE(client_events.at(1), "button");
+
+            pointer_button_released(BTN_LEFT, 4);
+        }
+
+        SECTION("key after motion")
+        {
+            setup.base->mod.render->addRepaint(QRegion(0, 0, 1280, 1024));
+            QVERIFY(is_frame_scheduled());
+
+            pointer_motion_absolute(QPointF(30, 30), 2);
+            keyboard_key_pressed(KEY_A, 3);
+            QCOMPARE(cursor()->pos(), QPoint(30, 30));
+            keyboard_key_released(KEY_A, 4);
+        }
+    }
+
     SECTION("warping during filter")
     {
         // this test verifies that pointer motion is handled correctly if
@@ -7,6 +7,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include "lib/setup.h"
 
 #include <KConfigGroup>
+#include <QElapsedTimer>
 #include <QPainter>
 #include <Wrapland/Client/pointer.h>
 #include <Wrapland/Client/seat.h>
@@ -74,7 +75,7 @@ TEST_CASE("scene qpainter", "[render]")
         //                running. Investigate why the buffer depends on it.
         xcb_connection_create();
 
-        QCOMPARE(referenceImage, *scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
+        QCOMPARE(referenceImage, scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
     }
 
     SECTION("cursor moving")
@@ -128,7 +129,7 @@ TEST_CASE("scene qpainter", "[render]")
 
         QVERIFY(!cursorImage.isNull());
         p.drawImage(QPoint(45, 45) - sw_cursor->hotspot(), cursorImage);
-        QCOMPARE(referenceImage, *scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
+        QCOMPARE(referenceImage, scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
     }
 
     SECTION("window")
@@ -177,7 +178,7 @@ TEST_CASE("scene qpainter", "[render]")
 
         // TODO(romangg): Screen buffer is for unknown reason different with cursor
         REQUIRE_FALSE(referenceImage
-                      == *scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
+                      == scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
 
         // let's move the cursor again
         cursor->set_pos(10, 10);
@@ -188,7 +189,7 @@ TEST_CASE("scene qpainter", "[render]")
 
         // TODO(romangg): Screen buffer is for unknown reason different with cursor
         REQUIRE_FALSE(referenceImage
-                      == *scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
+                      == scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
     }
 
     SECTION("window scaled")
@@ -244,7 +245,7 @@ TEST_CASE("scene qpainter", "[render]")
         painter.fillRect(100, 150, 100, 100, Qt::red);
         painter.fillRect(5, 5, 10, 10, Qt::red); // cursor
 
-        QCOMPARE(referenceImage, *scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
+        QCOMPARE(referenceImage, scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
     }
 
     SECTION("compositor restart")
@@ -288,7 +289,65 @@ TEST_CASE("scene qpainter", "[render]")
         auto const cursorImage = sw_cursor->image();
         QVERIFY(!cursorImage.isNull());
         painter.drawImage(QPoint(400, 400) - sw_cursor->hotspot(), cursorImage);
-        QCOMPARE(referenceImage, *scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
+        QCOMPARE(referenceImage, scene->backend()->bufferForScreen(setup.base->outputs.at(0)));
+    }
+
+    SECTION("shm damage benchmark")
+    {
+        // Measures committing a large shm buffer with the damage of a single text line, like a
+        // terminal does on typing, and with full damage.
+        using namespace Wrapland::Client;
+
+        auto const frames = 100;
+        auto const size = QSize(1000, 800);
+        auto const line = QRect(0, 400, 1000, 20);
+
+        cursor()->set_pos(1200, 1000);
+
+        std::unique_ptr<Surface> s(create_surface());
+        std::unique_ptr<XdgShellToplevel> ss(create_xdg_shell_toplevel(s));
+        QVERIFY(s);
+        QVERIFY(ss);
+
+        auto window = render_and_wait_for_shown(s, size, Qt::blue);
+        QVERIFY(window);
+
+        QSignalSpy frameRenderedSpy(s.get(), &Wrapland::Client::Surface::frameRendered);
+        QVERIFY(frameRenderedSpy.isValid());
+
+        auto scene = dynamic_cast<qpainter_scene_t*>(setup.base->mod.render->scene.get());
+        QVERIFY(scene);
+
+        QImage img(size, QImage::Format_ARGB32_Premultiplied);
+        img.fill(Qt::blue);
+
+        auto run = [&](QRect const& damage) {
+            QElapsedTimer timer;
+            timer.start();
+
+            for (int i = 0; i < frames; i++) {
+                QPainter painter(&img);
+                painter.fillRect(line, i % 2 ? Qt::red : Qt::green);
+                painter.end();
+
+                s->attachBuffer(get_client().interfaces.shm->createBuffer(img));
+                s->damage(damage);
+                s->commit();
+                REQUIRE(frameRenderedSpy.wait());
+            }
+
+            return timer.elapsed();
+        };
+
+        auto const line_time = run(line);
+        auto const full_time = run(QRect({}, size));
+        WARN(frames << " frames with line damage took " << line_time << " ms, with full damage "
+                    << full_time << " ms");
+
+        // The last line content must have been copied into the scene's buffer.
+        auto const screen = scene->backend()->bufferForScreen(setup.base->outputs.at(0));
+        QCOMPARE(screen.copy(line.translated(window->geo.pos())),
+                 img.copy(line).convertToFormat(screen.format()));
     }
 
     SECTION("x11 window")
@@ -395,7 +454,7 @@ TEST_CASE("scene qpainter", "[render]")
         auto const startPos = win::frame_to_client_pos(client, client->geo.pos());
         auto image = scene->backend()->bufferForScreen(setup.base->outputs.at(0));
         QCOMPARE(
-            image->copy(QRect(startPos, win::frame_to_client_size(client, client->geo.size()))),
+            image.copy(QRect(startPos, win::frame_to_client_size(client, client->geo.size()))),
             compareImage);
 
         // and destroy the window again
@@ -0,0 +1,62 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include "como/script/window.h"
+#include "como/script/window_thumbnail_item.h"
+#include "como/win/wayland/window.h"
+
+#include <Wrapland/Client/surface.h>
+
+namespace como::detail::test
+{
+
+TEST_CASE("window thumbnail item", "[script]")
+{
+    using namespace Wrapland::Client;
+
+    test::setup setup("window-thumbnail-item");
+    setup.start();
+    setup_wayland_connection();
+
+    std::unique_ptr<Surface> surface(create_surface());
+    std::unique_ptr<XdgShellToplevel> shell_surface(create_xdg_shell_toplevel(surface));
+    auto window = render_and_wait_for_shown(surface, QSize(100, 50), Qt::blue);
+    QVERIFY(window);
+
+    scripting::window_thumbnail_item item;
+    item.setWId(window->meta.internal_id);
+    QVERIFY(item.client());
+    QCOMPARE(item.client()->internalId(), window->meta.internal_id);
+
+    SECTION("mipmap")
+    {
+        QSignalSpy mipmap_spy(&item, &scripting::window_thumbnail_item::mipmapChanged);
+        QVERIFY(mipmap_spy.isValid());
+
+        // Disabled by default.
+        QVERIFY(!item.mipmap());
+
+        item.setMipmap(true);
+        QVERIFY(item.mipmap());
+        QCOMPARE(mipmap_spy.count(), 1);
+
+        // Setting the same value does not notify.
+        item.setMipmap(true);
+        QCOMPARE(mipmap_spy.count(), 1);
+
+        item.setMipmap(false);
+        QVERIFY(!item.mipmap());
+        QCOMPARE(mipmap_spy.count(), 2);
+
+        // The property can be set from QML.
+        QVERIFY(item.setProperty("mipmap", true));
+        QVERIFY(item.mipmap());
+        QCOMPARE(mipmap_spy.count(), 3);
+    }
+}
+
+}
@@ -6,8 +6,10 @@ SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "lib/setup.h"
 
+#include <QElapsedTimer>
 #include <Wrapland/Client/surface.h>
 #include <catch2/generators/catch_generators.hpp>
+#include <xcb/shape.h>
 #include <xcb/xcb_icccm.h>
 
 using namespace Wrapland::Client;
@@ -824,6 +826,154 @@ TEST_CASE("x11 window", "[win]")
         xcb_flush(connection.get());
         QVERIFY(wait_for_destroyed(client1));
     }
+
+    SECTION("prefetched properties")
+    {
+        // Properties requested in advance when managing a window are read correctly.
+        auto net_names = GENERATE(false, true);
+
+        auto c = xcb_connection_create();
+        QVERIFY(!xcb_connection_has_error(c.get()));
+
+        xcb_window_t w = xcb_generate_id(c.get());
+        xcb_create_window(c.get(),
+                          XCB_COPY_FROM_PARENT,
+                          w,
+                          setup.base->x11_data.root_window,
+                          0,
+                          0,
+                          100,
+                          200,
+                          0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          XCB_COPY_FROM_PARENT,
+                          0,
+                          nullptr);
+
+        std::string const name = "wm name";
+        std::string const icon_name = "wm icon name";
+        xcb_icccm_set_wm_name(c.get(), w, XCB_ATOM_STRING, 8, name.size(), name.c_str());
+        xcb_icccm_set_wm_icon_name(
+            c.get(), w, XCB_ATOM_STRING, 8, icon_name.size(), icon_name.c_str());
+
+        // NETWM names take precedence.
+        if (net_names) {
+            win::x11::net::win_info info(c.get(),
+                                         w,
+                                         setup.base->x11_data.root_window,
+                                         win::x11::net::Properties(),
+                                         win::x11::net::Properties2());
+            info.setName("net name");
+            info.setIconName("net icon name");
+        }
+
+        QByteArray const machine{"remote.example.org"};
+        xcb_icccm_set_wm_client_machine(
+            c.get(), w, XCB_ATOM_STRING, 8, machine.size(), machine.constData());
+
+        xcb_rectangle_t const shape_rect{0, 0, 50, 50};
+        xcb_shape_rectangles(c.get(),
+                             XCB_SHAPE_SO_SET,
+                             XCB_SHAPE_SK_BOUNDING,
+                             XCB_CLIP_ORDERING_UNSORTED,
+                             w,
+                             0,
+                             0,
+                             1,
+                             &shape_rect);
+
+        xcb_map_window(c.get(), w);
+        xcb_flush(c.get());
+
+        QSignalSpy windowCreatedSpy(setup.base->mod.space->qobject.get(),
+                                    &space::qobject_t::clientAdded);
+        QVERIFY(windowCreatedSpy.isValid());
+        QVERIFY(windowCreatedSpy.wait());
+
+        auto client = get_x11_window_from_id(windowCreatedSpy.first().first().value<quint32>());
+        QVERIFY(client);
+        QCOMPARE(client->xcb_windows.client, w);
+
+        QCOMPARE(win::caption(client),
+                 net_names ? QStringLiteral("net name") : QStringLiteral("wm name"));
+        QCOMPARE(client->iconic_caption,
+                 net_names ? QStringLiteral("net icon name") : QStringLiteral("wm icon name"));
+        QVERIFY(client->is_shape);
+        QCOMPARE(client->get_client_machine()->hostname(), machine);
+        QVERIFY(!client->get_client_machine()->is_local());
+
+        xcb_destroy_window(c.get(), w);
+        xcb_flush(c.get());
+        QVERIFY(wait_for_destroyed(client));
+        c.reset();
+    }
+}
+
+TEST_CASE("x11 window benchmark", "[.],[benchmark],[win]")
+{
+    test::setup setup("x11-window-benchmark", base::operation_mode::xwayland);
+    setup.start();
+    setup_wayland_connection();
+
+    auto get_x11_window_from_id
+        = [&](uint32_t id) { return get_x11_window(setup.base->mod.space->windows_map.at(id)); };
+
+    // Measures how long managing many windows at once takes, like on session restore.
+    auto const count = 200;
+
+    auto c = xcb_connection_create();
+    QVERIFY(!xcb_connection_has_error(c.get()));
+
+    QSignalSpy windowCreatedSpy(setup.base->mod.space->qobject.get(),
+                                &space::qobject_t::clientAdded);
+    QVERIFY(windowCreatedSpy.isValid());
+
+    std::vector<xcb_window_t> windows;
+    for (int i = 0; i < count; i++) {
+        auto w = xcb_generate_id(c.get());
+        xcb_create_window(c.get(),
+                          XCB_COPY_FROM_PARENT,
+                          w,
+                          setup.base->x11_data.root_window,
+                          0,
+                          0,
+                          100,
+                          200,
+                          0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          XCB_COPY_FROM_PARENT,
+                          0,
+                          nullptr);
+
+        // Without NETWM names the ICCCM properties are read as well.
+        auto const name = "benchmark " + std::to_string(i);
+        xcb_icccm_set_wm_name(c.get(), w, XCB_ATOM_STRING, 8, name.size(), name.c_str());
+        xcb_icccm_set_wm_icon_name(c.get(), w, XCB_ATOM_STRING, 8, name.size(), name.c_str());
+        xcb_icccm_set_wm_class(c.get(), w, 20, "benchmark\0Benchmark");
+        windows.push_back(w);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (auto w : windows) {
+        xcb_map_window(c.get(), w);
+    }
+    xcb_flush(c.get());
+
+    QTRY_COMPARE_WITH_TIMEOUT(windowCreatedSpy.count(), count, 30000);
+    WARN("Managing " << count << " windows took " << timer.elapsed() << " ms");
+
+    auto client = get_x11_window_from_id(windowCreatedSpy.last().first().value<quint32>());
+    QVERIFY(client);
+    QCOMPARE(win::caption(client), QStringLiteral("benchmark %1").arg(count - 1));
+
+    for (auto w : windows) {
+        xcb_destroy_window(c.get(), w);
+    }
+    xcb_flush(c.get());
+    QVERIFY(wait_for_destroyed(client));
+    c.reset();
 }
 
 }
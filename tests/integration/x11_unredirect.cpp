@@ -0,0 +1,165 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include "como/render/x11/unredirect.h"
+
+#include <xcb/xcb_icccm.h>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+struct mock_overlay_window {
+    void setShape(QRegion const& region)
+    {
+        shape = region;
+    }
+
+    QRegion shape;
+};
+
+/// Provides what the X11 compositor uses for unredirecting fullscreen windows.
+struct unredirect_platform {
+    using x11_ref_window_t = test::space::x11_window;
+
+    void addRepaint(QRegion const& region)
+    {
+        repaints |= region;
+    }
+
+    base_t& base;
+    test::space* space;
+    base_mod::render_t::effects_t* effects;
+
+    render::x11::unredirection fullscreen_unredirect;
+    mock_overlay_window* overlay_window{nullptr};
+    QRegion repaints;
+};
+
+}
+
+TEST_CASE("x11 unredirect", "[win],[xwl]")
+{
+    test::setup setup("x11-unredirect", base::operation_mode::xwayland);
+    setup.start();
+
+    auto& options = *setup.base->mod.render->options->qobject;
+    options.setUnredirectFullscreen(true);
+
+    auto const output_geo = setup.base->outputs.at(0)->geometry();
+
+    mock_overlay_window overlay;
+    unredirect_platform platform{
+        *setup.base, setup.base->mod.space.get(), setup.base->mod.render->effects.get()};
+    platform.overlay_window = &overlay;
+
+    auto& state = platform.fullscreen_unredirect;
+    state.timer.setSingleShot(true);
+    state.timer.setInterval(render::x11::unredirection::delay);
+    QObject::connect(&state.timer, &QTimer::timeout, &state.timer, [&platform] {
+        render::x11::check_unredirect(platform);
+    });
+
+    auto c = xcb_connection_create();
+    QVERIFY(!xcb_connection_has_error(c.get()));
+
+    QRect const window_geo(0, 0, 100, 200);
+    xcb_window_t w = xcb_generate_id(c.get());
+    xcb_create_window(c.get(),
+                      XCB_COPY_FROM_PARENT,
+                      w,
+                      setup.base->x11_data.root_window,
+                      window_geo.x(),
+                      window_geo.y(),
+                      window_geo.width(),
+                      window_geo.height(),
+                      0,
+                      XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                      XCB_COPY_FROM_PARENT,
+                      0,
+                      nullptr);
+    xcb_size_hints_t hints;
+    memset(&hints, 0, sizeof(hints));
+    xcb_icccm_size_hints_set_position(&hints, 1, window_geo.x(), window_geo.y());
+    xcb_icccm_size_hints_set_size(&hints, 1, window_geo.width(), window_geo.height());
+    xcb_icccm_set_wm_normal_hints(c.get(), w, &hints);
+    xcb_map_window(c.get(), w);
+    xcb_flush(c.get());
+
+    QSignalSpy window_spy(setup.base->mod.space->qobject.get(), &space::qobject_t::clientAdded);
+    QVERIFY(window_spy.isValid());
+    QVERIFY(window_spy.wait());
+
+    auto client = get_x11_window(
+        setup.base->mod.space->windows_map.at(window_spy.first().first().value<quint32>()));
+    QVERIFY(client);
+    QCOMPARE(client->xcb_windows.client, w);
+    QVERIFY(client->control->active);
+    QTRY_VERIFY(client->render_data.ready_for_painting);
+
+    // Effects that are always active, like blur, must not keep the window redirected.
+    QTRY_VERIFY(!platform.effects->blocksDirectScanout());
+
+    // A normal window is not unredirected.
+    render::x11::check_unredirect(platform);
+    QCOMPARE(state.window, XCB_WINDOW_NONE);
+    QCOMPARE(state.candidate, XCB_WINDOW_NONE);
+    QVERIFY(!state.timer.isActive());
+
+    win::active_window_set_fullscreen(*setup.base->mod.space);
+    QVERIFY(client->control->fullscreen);
+    QCOMPARE(client->geo.frame, output_geo);
+
+    // The fullscreen window qualifies but is only unredirected after the delay.
+    render::x11::check_unredirect(platform);
+    QCOMPARE(state.candidate, client->frameId());
+    QCOMPARE(state.window, XCB_WINDOW_NONE);
+    QVERIFY(state.timer.isActive());
+
+    QTRY_COMPARE(state.window, client->frameId());
+    QCOMPARE(state.candidate, XCB_WINDOW_NONE);
+    QCOMPARE(state.region, QRegion(output_geo));
+    QVERIFY(overlay.shape.isEmpty());
+
+    // Checking again keeps the window unredirected.
+    render::x11::check_unredirect(platform);
+    QCOMPARE(state.window, client->frameId());
+    QVERIFY(!state.timer.isActive());
+
+    // A translucent window is redirected again immediately.
+    client->setOpacity(0.5);
+    render::x11::check_unredirect(platform);
+    QCOMPARE(state.window, XCB_WINDOW_NONE);
+    QCOMPARE(state.candidate, XCB_WINDOW_NONE);
+    QVERIFY(state.region.isEmpty());
+    QCOMPARE(overlay.shape, QRegion(QRect({}, setup.base->topology.size)));
+    QCOMPARE(platform.repaints, QRegion(output_geo));
+
+    client->setOpacity(1.);
+    render::x11::check_unredirect(platform);
+    QCOMPARE(state.candidate, client->frameId());
+    QTRY_COMPARE(state.window, client->frameId());
+
+    // Leaving fullscreen redirects the window again.
+    win::active_window_set_fullscreen(*setup.base->mod.space);
+    QVERIFY(!client->control->fullscreen);
+
+    render::x11::check_unredirect(platform);
+    QCOMPARE(state.window, XCB_WINDOW_NONE);
+    QCOMPARE(state.candidate, XCB_WINDOW_NONE);
+    QVERIFY(!state.timer.isActive());
+    QCOMPARE(overlay.shape, QRegion(QRect({}, setup.base->topology.size)));
+
+    xcb_unmap_window(c.get(), w);
+    xcb_destroy_window(c.get(), w);
+    xcb_flush(c.get());
+    c.reset();
+}
+
+}
@@ -6,13 +6,211 @@ SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "lib/setup.h"
 
+#include "como/xwl/transfer.h"
+
+#include <QElapsedTimer>
 #include <QProcess>
 #include <QProcessEnvironment>
 #include <catch2/generators/catch_generators.hpp>
+#include <chrono>
+#include <fcntl.h>
+#include <limits>
+#include <optional>
+#include <unistd.h>
 
 namespace como::detail::test
 {
 
+namespace
+{
+
+enum class sync_direction {
+    wayland_to_x11,
+    x11_to_wayland,
+};
+
+/**
+ * Copies text in one client and pastes it in another one. The text has @p size bytes or is a short
+ * text if @p size is 0. Returns the time the paste took.
+ */
+std::chrono::milliseconds sync_clipboard(test::setup& setup,
+                                         std::string const& clipboard_mode,
+                                         sync_direction direction,
+                                         int size)
+{
+    QString copy_platform = QStringLiteral("wayland");
+    QString paste_platform = QStringLiteral("xcb");
+
+    if (direction == sync_direction::x11_to_wayland) {
+        copy_platform = QStringLiteral("xcb");
+        paste_platform = QStringLiteral("wayland");
+    } else {
+        REQUIRE(direction == sync_direction::wayland_to_x11);
+    }
+
+    // The helpers copy and expect a text of the given size or a short text.
+    auto arguments = QStringList{QString::fromStdString(clipboard_mode)};
+    if (size > 0) {
+        arguments.prepend(QString::number(size));
+    }
+
+    QString const copy = QFINDTESTDATA(QStringLiteral("copy"));
+    QVERIFY(!copy.isEmpty());
+    const QString paste = QFINDTESTDATA(QStringLiteral("paste"));
+    QVERIFY(!paste.isEmpty());
+
+    QSignalSpy clientAddedSpy(setup.base->mod.space->qobject.get(), &space::qobject_t::clientAdded);
+    QVERIFY(clientAddedSpy.isValid());
+    QSignalSpy shellClientAddedSpy(setup.base->mod.space->qobject.get(),
+                                   &space::qobject_t::wayland_window_added);
+    QVERIFY(shellClientAddedSpy.isValid());
+
+    QSignalSpy clipboardChangedSpy = [&setup, &clipboard_mode]() {
+        if (clipboard_mode == "Clipboard") {
+            return QSignalSpy(setup.base->server->seat(),
+                              &Wrapland::Server::Seat::selectionChanged);
+        }
+        if (clipboard_mode == "Selection") {
+            return QSignalSpy(setup.base->server->seat(),
+                              &Wrapland::Server::Seat::primarySelectionChanged);
+        }
+        std::terminate();
+    }();
+
+    QVERIFY(clipboardChangedSpy.isValid());
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+
+    // start the copy process
+    environment.insert(QStringLiteral("QT_QPA_PLATFORM"), copy_platform);
+    auto copy_process = new QProcess();
+    copy_process->setProcessEnvironment(environment);
+    copy_process->setProcessChannelMode(QProcess::ForwardedChannels);
+    copy_process->setProgram(copy);
+    copy_process->setArguments(arguments);
+    copy_process->start();
+    QVERIFY(copy_process->waitForStarted());
+
+    std::optional<space::window_t> copyClient;
+    if (copy_platform == QLatin1String("xcb")) {
+        QVERIFY(clientAddedSpy.wait());
+        auto copy_client_id = clientAddedSpy.first().first().value<quint32>();
+        copyClient = setup.base->mod.space->windows_map.at(copy_client_id);
+    } else {
+        QVERIFY(shellClientAddedSpy.wait());
+        auto copy_client_id = shellClientAddedSpy.first().first().value<quint32>();
+        copyClient = setup.base->mod.space->windows_map.at(copy_client_id);
+    }
+    QVERIFY(copyClient);
+    if (setup.base->mod.space->stacking.active != *copyClient) {
+        std::visit(overload{[&setup](auto&& win) {
+                       win::activate_window(*setup.base->mod.space, *win);
+                   }},
+                   *copyClient);
+    }
+    QCOMPARE(setup.base->mod.space->stacking.active, copyClient);
+    if (copy_platform == QLatin1String("xcb")) {
+        QVERIFY(clipboardChangedSpy.isEmpty());
+        QVERIFY(clipboardChangedSpy.wait());
+    } else {
+        // TODO: it would be better to be able to connect to a signal, instead of waiting
+        // the idea is to make sure that the clipboard is updated, thus we need to give it
+        // enough time before starting the paste process which creates another window
+        QTest::qWait(250);
+    }
+
+    // start the paste process
+    auto paste_process = new QProcess();
+    QSignalSpy finishedSpy(
+        paste_process,
+        static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished));
+    QVERIFY(finishedSpy.isValid());
+    environment.insert(QStringLiteral("QT_QPA_PLATFORM"), paste_platform);
+    paste_process->setProcessEnvironment(environment);
+    paste_process->setProcessChannelMode(QProcess::ForwardedChannels);
+    paste_process->setProgram(paste);
+    paste_process->setArguments(arguments);
+    paste_process->start();
+    QVERIFY(paste_process->waitForStarted());
+
+    std::optional<space::window_t> pasteClient;
+    if (paste_platform == QLatin1String("xcb")) {
+        QVERIFY(clientAddedSpy.wait());
+        auto paste_client_id = clientAddedSpy.last().first().value<quint32>();
+        pasteClient = setup.base->mod.space->windows_map.at(paste_client_id);
+    } else {
+        QVERIFY(shellClientAddedSpy.wait());
+        auto paste_client_id = shellClientAddedSpy.last().first().value<quint32>();
+        pasteClient = setup.base->mod.space->windows_map.at(paste_client_id);
+    }
+    QCOMPARE(clientAddedSpy.count(), 1);
+    QCOMPARE(shellClientAddedSpy.count(), 1);
+    QVERIFY(pasteClient);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (setup.base->mod.space->stacking.active != pasteClient) {
+        QSignalSpy clientActivatedSpy(setup.base->mod.space->qobject.get(),
+                                      &space::qobject_t::clientActivated);
+        QVERIFY(clientActivatedSpy.isValid());
+        std::visit(overload{[&setup](auto&& win) {
+                       win::activate_window(*setup.base->mod.space, *win);
+                   }},
+                   *pasteClient);
+        QVERIFY(clientActivatedSpy.wait());
+    }
+    QTRY_COMPARE(setup.base->mod.space->stacking.active, pasteClient);
+    QVERIFY(finishedSpy.wait(size > 0 ? 60000 : 5000));
+    auto const elapsed = std::chrono::milliseconds(timer.elapsed());
+    QCOMPARE(finishedSpy.first().first().toInt(), 0);
+    delete paste_process;
+    paste_process = nullptr;
+
+    if (copy_process) {
+        copy_process->terminate();
+        QVERIFY(copy_process->waitForFinished());
+        copy_process = nullptr;
+    }
+    if (paste_process) {
+        paste_process->terminate();
+        QVERIFY(paste_process->waitForFinished());
+        paste_process = nullptr;
+    }
+
+    return elapsed;
+}
+
+struct property_value {
+    xcb_atom_t type;
+    QByteArray data;
+};
+
+/// Reads and deletes the property like a selection requestor does. Returns nothing if it is unset.
+std::optional<property_value>
+take_property(xcb_connection_t* con, xcb_window_t window, xcb_atom_t property)
+{
+    auto cookie = xcb_get_property(con,
+                                   1,
+                                   window,
+                                   property,
+                                   XCB_GET_PROPERTY_TYPE_ANY,
+                                   0,
+                                   std::numeric_limits<uint32_t>::max() / 4);
+    std::unique_ptr<xcb_get_property_reply_t, decltype(&free)> reply(
+        xcb_get_property_reply(con, cookie, nullptr), free);
+
+    if (!reply || reply->type == XCB_ATOM_NONE) {
+        return {};
+    }
+
+    auto const value = static_cast<char const*>(xcb_get_property_value(reply.get()));
+    return property_value{reply->type,
+                          QByteArray(value, xcb_get_property_value_length(reply.get()))};
+}
+
+}
+
 TEST_CASE("xwayland selections", "[win],[xwl]")
 {
     test::setup setup("xwayland-selections", base::operation_mode::xwayland);
@@ -27,146 +225,138 @@ TEST_CASE("xwayland selections", "[win],[xwl]")
 
     SECTION("sync")
     {
-        enum class sync_direction {
-            wayland_to_x11,
-            x11_to_wayland,
-        };
-
         auto clipboard_mode = GENERATE(as<std::string>{}, "Clipboard", "Selection");
         auto direction = GENERATE(sync_direction::wayland_to_x11, sync_direction::x11_to_wayland);
 
-        QString copy_platform = QStringLiteral("wayland");
-        QString paste_platform = QStringLiteral("xcb");
+        sync_clipboard(setup, clipboard_mode, direction, 0);
+    }
 
-        if (direction == sync_direction::x11_to_wayland) {
-            copy_platform = QStringLiteral("xcb");
-            paste_platform = QStringLiteral("wayland");
-        } else {
-            REQUIRE(direction == sync_direction::wayland_to_x11);
-        }
+    SECTION("incremental transfer")
+    {
+        // Data larger than a chunk is transferred incrementally on X11.
+        auto direction = GENERATE(sync_direction::wayland_to_x11, sync_direction::x11_to_wayland);
+        sync_clipboard(setup, "Clipboard", direction, 3 * 1024 * 1024);
+    }
 
-        // this test verifies the syncing of X11 to Wayland clipboard
-        QString const copy = QFINDTESTDATA(QStringLiteral("copy"));
-        QVERIFY(!copy.isEmpty());
-        const QString paste = QFINDTESTDATA(QStringLiteral("paste"));
-        QVERIFY(!paste.isEmpty());
-
-        QSignalSpy clientAddedSpy(setup.base->mod.space->qobject.get(),
-                                  &space::qobject_t::clientAdded);
-        QVERIFY(clientAddedSpy.isValid());
-        QSignalSpy shellClientAddedSpy(setup.base->mod.space->qobject.get(),
-                                       &space::qobject_t::wayland_window_added);
-        QVERIFY(shellClientAddedSpy.isValid());
-
-        QSignalSpy clipboardChangedSpy = [&setup, &clipboard_mode]() {
-            if (clipboard_mode == "Clipboard") {
-                return QSignalSpy(setup.base->server->seat(),
-                                  &Wrapland::Server::Seat::selectionChanged);
-            }
-            if (clipboard_mode == "Selection") {
-                return QSignalSpy(setup.base->server->seat(),
-                                  &Wrapland::Server::Seat::primarySelectionChanged);
+    SECTION("incremental transfer with source ending late")
+    {
+        // The source is closed only after the requestor took the last chunk and deleted the
+        // property. The transfer must still be completed with a zero-length property.
+        xwl::x11_runtime x11{setup.base->x11_data.connection,
+                             base::x11::get_default_screen(setup.base->x11_data),
+                             setup.base->mod.space->atoms.get()};
+        QVERIFY(x11.atoms);
+
+        auto con = xcb_connection_create();
+        QVERIFY(!xcb_connection_has_error(con.get()));
+
+        auto const root = xcb_setup_roots_iterator(xcb_get_setup(con.get())).data->root;
+        auto const window = xcb_generate_id(con.get());
+        xcb_create_window(con.get(),
+                          XCB_COPY_FROM_PARENT,
+                          window,
+                          root,
+                          0,
+                          0,
+                          10,
+                          10,
+                          0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          XCB_COPY_FROM_PARENT,
+                          0,
+                          nullptr);
+        base::x11::xcb::atom property(QByteArrayLiteral("COMO_TEST_SELECTION"), con.get());
+        xcb_flush(con.get());
+
+        auto request = new xcb_selection_request_event_t{};
+        request->requestor = window;
+        request->selection = x11.atoms->clipboard;
+        request->target = x11.atoms->utf8_string;
+        request->property = property;
+
+        int fds[2];
+        QVERIFY(pipe2(fds, O_CLOEXEC) == 0);
+        QVERIFY(fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+
+        auto transfer
+            = std::make_unique<xwl::wl_to_x11_transfer>(x11.atoms->clipboard, request, fds[0], x11);
+        QSignalSpy finished_spy(transfer.get(), &xwl::transfer::finished);
+        QVERIFY(finished_spy.isValid());
+        transfer->start_transfer_from_source();
+
+        // The requestor's property deletions are forwarded by the selection owning a transfer.
+        auto notify_delete = [&] {
+            xcb_property_notify_event_t event{};
+            event.response_type = XCB_PROPERTY_NOTIFY;
+            event.window = window;
+            event.atom = property;
+            event.state = XCB_PROPERTY_DELETE;
+            QVERIFY(transfer->handle_property_notify(&event));
+        };
+
+        // Same as the transfer's chunk size. The data fills exactly two chunks.
+        auto const max_request = xcb_get_maximum_request_length(x11.connection) * 4;
+        auto const chunk_size = std::min<uint32_t>(1024 * 1024, max_request - 24);
+        auto const data = QByteArray(2 * chunk_size, 'x');
+
+        qsizetype written{0};
+        QTRY_VERIFY([&] {
+            auto const ret = write(fds[1], data.constData() + written, data.size() - written);
+            if (ret > 0) {
+                written += ret;
             }
-            std::terminate();
-        }();
-
-        QVERIFY(clipboardChangedSpy.isValid());
-
-        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
-
-        // start the copy process
-        environment.insert(QStringLiteral("QT_QPA_PLATFORM"), copy_platform);
-        auto copy_process = new QProcess();
-        copy_process->setProcessEnvironment(environment);
-        copy_process->setProcessChannelMode(QProcess::ForwardedChannels);
-        copy_process->setProgram(copy);
-        copy_process->setArguments({QString::fromStdString(clipboard_mode)});
-        copy_process->start();
-        QVERIFY(copy_process->waitForStarted());
-
-        std::optional<space::window_t> copyClient;
-        if (copy_platform == QLatin1String("xcb")) {
-            QVERIFY(clientAddedSpy.wait());
-            auto copy_client_id = clientAddedSpy.first().first().value<quint32>();
-            copyClient = setup.base->mod.space->windows_map.at(copy_client_id);
-        } else {
-            QVERIFY(shellClientAddedSpy.wait());
-            auto copy_client_id = shellClientAddedSpy.first().first().value<quint32>();
-            copyClient = setup.base->mod.space->windows_map.at(copy_client_id);
-        }
-        QVERIFY(copyClient);
-        if (setup.base->mod.space->stacking.active != *copyClient) {
-            std::visit(overload{[&setup](auto&& win) {
-                           win::activate_window(*setup.base->mod.space, *win);
-                       }},
-                       *copyClient);
-        }
-        QCOMPARE(setup.base->mod.space->stacking.active, copyClient);
-        if (copy_platform == QLatin1String("xcb")) {
-            QVERIFY(clipboardChangedSpy.isEmpty());
-            QVERIFY(clipboardChangedSpy.wait());
-        } else {
-            // TODO: it would be better to be able to connect to a signal, instead of waiting
-            // the idea is to make sure that the clipboard is updated, thus we need to give it
-            // enough time before starting the paste process which creates another window
-            QTest::qWait(250);
-        }
+            return written == data.size();
+        }());
 
-        // start the paste process
-        auto paste_process = new QProcess();
-        QSignalSpy finishedSpy(
-            paste_process,
-            static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished));
-        QVERIFY(finishedSpy.isValid());
-        environment.insert(QStringLiteral("QT_QPA_PLATFORM"), paste_platform);
-        paste_process->setProcessEnvironment(environment);
-        paste_process->setProcessChannelMode(QProcess::ForwardedChannels);
-        paste_process->setProgram(paste);
-        paste_process->setArguments({QString::fromStdString(clipboard_mode)});
-        paste_process->start();
-        QVERIFY(paste_process->waitForStarted());
-
-        std::optional<space::window_t> pasteClient;
-        if (paste_platform == QLatin1String("xcb")) {
-            QVERIFY(clientAddedSpy.wait());
-            auto paste_client_id = clientAddedSpy.last().first().value<quint32>();
-            pasteClient = setup.base->mod.space->windows_map.at(paste_client_id);
-        } else {
-            QVERIFY(shellClientAddedSpy.wait());
-            auto paste_client_id = shellClientAddedSpy.last().first().value<quint32>();
-            pasteClient = setup.base->mod.space->windows_map.at(paste_client_id);
-        }
-        QCOMPARE(clientAddedSpy.count(), 1);
-        QCOMPARE(shellClientAddedSpy.count(), 1);
-        QVERIFY(pasteClient);
-
-        if (setup.base->mod.space->stacking.active != pasteClient) {
-            QSignalSpy clientActivatedSpy(setup.base->mod.space->qobject.get(),
-                                          &space::qobject_t::clientActivated);
-            QVERIFY(clientActivatedSpy.isValid());
-            std::visit(overload{[&setup](auto&& win) {
-                           win::activate_window(*setup.base->mod.space, *win);
-                       }},
-                       *pasteClient);
-            QVERIFY(clientActivatedSpy.wait());
-        }
-        QTRY_COMPARE(setup.base->mod.space->stacking.active, pasteClient);
-        QVERIFY(finishedSpy.wait());
-        QCOMPARE(finishedSpy.first().first().toInt(), 0);
-        delete paste_process;
-        paste_process = nullptr;
+        std::optional<property_value> value;
+        QTRY_VERIFY((value = take_property(con.get(), window, property)));
+        QCOMPARE(value->type, x11.atoms->incr);
+        QCOMPARE(value->data.size(), 4);
+        QCOMPARE(*reinterpret_cast<uint32_t const*>(value->data.constData()), chunk_size + 1024);
+        notify_delete();
 
-        if (copy_process) {
-            copy_process->terminate();
-            QVERIFY(copy_process->waitForFinished());
-            copy_process = nullptr;
-        }
-        if (paste_process) {
-            paste_process->terminate();
-            QVERIFY(paste_process->waitForFinished());
-            paste_process = nullptr;
+        QByteArray received;
+        while (received.size() < data.size()) {
+            QTRY_VERIFY((value = take_property(con.get(), window, property)));
+            QCOMPARE(value->type, x11.atoms->utf8_string);
+            QVERIFY(!value->data.isEmpty());
+            received += value->data;
+            notify_delete();
         }
+        QCOMPARE(received, data);
+        QCOMPARE(finished_spy.count(), 0);
+
+        close(fds[1]);
+
+        QTRY_VERIFY((value = take_property(con.get(), window, property)));
+        QCOMPARE(value->type, x11.atoms->utf8_string);
+        QVERIFY(value->data.isEmpty());
+        QTRY_COMPARE(finished_spy.count(), 1);
+
+        transfer.reset();
+        xcb_destroy_window(con.get(), window);
+        xcb_flush(con.get());
     }
 }
 
+TEST_CASE("xwayland selections benchmark", "[.],[benchmark],[win],[xwl]")
+{
+    test::setup setup("xwayland-selections-benchmark", base::operation_mode::xwayland);
+    setup.start();
+    setup.set_outputs(2);
+    test_outputs_default();
+    setup_wayland_connection();
+
+    // Start Xwayland on demand.
+    xcb_connection_create();
+
+    // Large transfers are done incrementally on X11.
+    auto direction = GENERATE(sync_direction::wayland_to_x11, sync_direction::x11_to_wayland);
+    auto const size = 32 * 1024 * 1024;
+
+    auto const elapsed = sync_clipboard(setup, "Clipboard", direction, size);
+    WARN((direction == sync_direction::wayland_to_x11 ? "Wayland to X11" : "X11 to Wayland")
+         << " transfer of " << size / (1024 * 1024) << " MiB took " << elapsed.count() << " ms");
+}
+
 }
@@ -0,0 +1,147 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/base/output.h"
+#include "como/render/wayland/capture_stream.h"
+
+#include <QSignalSpy>
+#include <cstring>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+class mock_output : public base::output
+{
+public:
+    QString name() const override
+    {
+        return QStringLiteral("mock");
+    }
+
+    QRect geometry() const override
+    {
+        return {0, 0, 100, 50};
+    }
+
+    int refresh_rate() const override
+    {
+        return 60000;
+    }
+};
+
+}
+
+TEST_CASE("capture stream unit", "[render],[unit]")
+{
+    mock_output output;
+    render::wayland::capture_stream stream(output, 2);
+
+    QSignalSpy buffers_spy(&stream, &render::wayland::capture_stream::buffers_changed);
+    QSignalSpy frame_spy(&stream, &render::wayland::capture_stream::frame_ready);
+
+    QSize const size(100, 50);
+    auto const format = QImage::Format_RGB32;
+
+    QRegion copied;
+    auto copy = [&](QRect const& rect, uchar* data, int stride) {
+        copied |= rect;
+        for (int row = 0; row < rect.height(); row++) {
+            std::memset(data + row * stride, 0xff, rect.width() * 4);
+        }
+    };
+
+    auto submit = [&](QRegion const& damage) {
+        copied = {};
+        stream.submit(size, format, false, damage, copy);
+    };
+
+    SECTION("first frame is complete")
+    {
+        submit(QRect(10, 10, 5, 5));
+
+        QCOMPARE(buffers_spy.count(), 1);
+        QCOMPARE(stream.buffers.size(), 2u);
+        QCOMPARE(stream.stride, 400);
+        QCOMPARE(stream.drm_format(), 0x34325258u);
+
+        QCOMPARE(frame_spy.count(), 1);
+        QCOMPARE(frame_spy.last().at(1).value<QRegion>(), QRegion(0, 0, 100, 50));
+        QCOMPARE(copied, QRegion(0, 0, 100, 50));
+    }
+
+    SECTION("unchanged frames are skipped")
+    {
+        submit({});
+        QCOMPARE(frame_spy.count(), 1);
+
+        submit({});
+        QCOMPARE(frame_spy.count(), 1);
+        QVERIFY(copied.isEmpty());
+
+        submit(QRect(10, 10, 5, 5));
+        QCOMPARE(frame_spy.count(), 2);
+        QCOMPARE(frame_spy.last().at(1).value<QRegion>(), QRegion(10, 10, 5, 5));
+        QCOMPARE(frame_spy.last().at(2).value<quint64>(), 2u);
+    }
+
+    SECTION("only stale parts are copied")
+    {
+        submit({});
+        QCOMPARE(frame_spy.last().at(0).toInt(), 0);
+
+        submit(QRect(0, 0, 10, 10));
+        QCOMPARE(frame_spy.last().at(0).toInt(), 1);
+        QCOMPARE(copied, QRegion(0, 0, 100, 50));
+
+        REQUIRE(stream.release(0));
+        REQUIRE(stream.release(1));
+        QVERIFY(!stream.release(1));
+
+        // The first buffer misses the damage of the second frame too.
+        submit(QRect(20, 20, 10, 10));
+        QCOMPARE(frame_spy.last().at(0).toInt(), 0);
+        QCOMPARE(copied, QRegion(0, 0, 10, 10) | QRegion(20, 20, 10, 10));
+        QCOMPARE(frame_spy.last().at(1).value<QRegion>(), QRegion(20, 20, 10, 10));
+    }
+
+    SECTION("damage is kept while all buffers are held")
+    {
+        submit({});
+        submit(QRect(0, 0, 10, 10));
+        QCOMPARE(frame_spy.count(), 2);
+
+        submit(QRect(20, 20, 10, 10));
+        QCOMPARE(frame_spy.count(), 2);
+        QVERIFY(copied.isEmpty());
+
+        REQUIRE(stream.release(1));
+        submit(QRect(40, 40, 5, 5));
+        QCOMPARE(frame_spy.count(), 3);
+        QCOMPARE(frame_spy.last().at(0).toInt(), 1);
+        QCOMPARE(frame_spy.last().at(1).value<QRegion>(),
+                 QRegion(20, 20, 10, 10) | QRegion(40, 40, 5, 5));
+    }
+
+    SECTION("resize reallocates buffers")
+    {
+        submit({});
+        REQUIRE(stream.release(0));
+
+        copied = {};
+        stream.submit(QSize(200, 100), format, false, QRect(0, 0, 1, 1), copy);
+
+        QCOMPARE(buffers_spy.count(), 2);
+        QCOMPARE(stream.size, QSize(200, 100));
+        QCOMPARE(frame_spy.last().at(1).value<QRegion>(), QRegion(0, 0, 200, 100));
+        QCOMPARE(copied, QRegion(0, 0, 200, 100));
+    }
+}
+
+}
@@ -0,0 +1,114 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/input/window_grid.h"
+
+namespace como::detail::test
+{
+
+TEST_CASE("input window grid", "[unit],[input]")
+{
+    using grid_t = input::window_grid<int>;
+
+    auto const area = QRect(0, 0, 1000, 600);
+    auto accept_all = [](auto) { return true; };
+
+    grid_t grid;
+
+    SECTION("empty")
+    {
+        grid.build(area, {});
+        QVERIFY(!grid.find({10, 10}, accept_all));
+        QVERIFY(!grid.find({-10, 10}, accept_all));
+    }
+
+    SECTION("first match in entry order")
+    {
+        grid.build(area,
+                   {
+                       {QRect(100, 100, 200, 200), 1},
+                       {QRect(0, 0, 1000, 600), 2},
+                       {QRect(250, 250, 400, 300), 3},
+                   });
+
+        QCOMPARE(grid.find({150, 150}, accept_all), 1);
+        QCOMPARE(grid.find({299, 299}, accept_all), 1);
+        QCOMPARE(grid.find({300, 300}, accept_all), 2);
+        QCOMPARE(grid.find({999, 599}, accept_all), 2);
+        QVERIFY(!grid.find({1000, 600}, accept_all));
+    }
+
+    SECTION("predicate")
+    {
+        grid.build(area,
+                   {
+                       {QRect(100, 100, 200, 200), 1},
+                       {QRect(250, 250, 400, 300), 2},
+                   });
+
+        QCOMPARE(grid.find({260, 260}, [](auto win) { return win != 1; }), 2);
+        QVERIFY(!grid.find({150, 150}, [](auto win) { return win != 1; }));
+    }
+
+    SECTION("rects outside of area")
+    {
+        grid.build(area,
+                   {
+                       {QRect(-500, -100, 600, 200), 1},
+                       {QRect(900, 500, 500, 500), 2},
+                   });
+
+        QCOMPARE(grid.find({-200, 0}, accept_all), 1);
+        QCOMPARE(grid.find({50, 50}, accept_all), 1);
+        QCOMPARE(grid.find({950, 550}, accept_all), 2);
+        QCOMPARE(grid.find({1200, 700}, accept_all), 2);
+        QVERIFY(!grid.find({500, 300}, accept_all));
+    }
+
+    SECTION("update")
+    {
+        grid.build(area,
+                   {
+                       {QRect(0, 0, 100, 100), 1},
+                       {QRect(500, 300, 200, 200), 2},
+                       {QRect(0, 0, 1000, 600), 3},
+                   });
+
+        QCOMPARE(grid.find({50, 50}, accept_all), 1);
+        QCOMPARE(grid.find({550, 350}, accept_all), 2);
+
+        // Moving a window changes only where it is found.
+        QVERIFY(grid.update(2, QRect(20, 20, 600, 100)));
+        QCOMPARE(grid.find({50, 50}, accept_all), 1);
+        QCOMPARE(grid.find({550, 50}, accept_all), 2);
+        QCOMPARE(grid.find({550, 350}, accept_all), 3);
+
+        // The order of the entries is kept in the cells it is moved to.
+        QVERIFY(grid.update(3, QRect(0, 0, 10, 10)));
+        QVERIFY(grid.update(1, QRect(500, 300, 200, 200)));
+        QCOMPARE(grid.find({5, 5}, accept_all), 3);
+        QCOMPARE(grid.find({550, 350}, accept_all), 1);
+        QCOMPARE(grid.find({550, 50}, accept_all), 2);
+        QVERIFY(!grid.find({10, 200}, accept_all));
+
+        QVERIFY(grid.update(1, QRect(0, 0, 600, 400)));
+        QCOMPARE(grid.find({5, 5}, accept_all), 1);
+        QCOMPARE(grid.find({550, 50}, accept_all), 1);
+        QVERIFY(!grid.find({650, 450}, accept_all));
+
+        // Rects can move in and out of the area.
+        QVERIFY(grid.update(2, QRect(-300, -300, 200, 200)));
+        QCOMPARE(grid.find({-200, -200}, accept_all), 2);
+        QVERIFY(grid.update(2, QRect(800, 500, 100, 100)));
+        QCOMPARE(grid.find({850, 550}, accept_all), 2);
+        QVERIFY(!grid.find({-200, -200}, accept_all));
+
+        QVERIFY(!grid.update(4, QRect(0, 0, 100, 100)));
+    }
+}
+
+}
@@ -39,7 +39,17 @@ public:
     {
     }
 
-    std::vector<input::event_spy<mock_redirect>*> m_spies;
+    void install_spy(event_spy_t* spy)
+    {
+        m_spies.push_back(spy);
+    }
+
+    void uninstall_spy(event_spy_t* spy)
+    {
+        remove_all(m_spies, spy);
+    }
+
+    std::vector<event_spy_t*> m_spies;
     std::unique_ptr<mock_pointer> pointer;
 };
 
@@ -0,0 +1,75 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/render/wayland/buffer_sync.h"
+
+#include <QCoreApplication>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+void signal_fence(int fd)
+{
+    char const data{1};
+    QVERIFY(write(fd, &data, 1) == 1);
+}
+
+}
+
+TEST_CASE("render buffer fence", "[unit],[render]")
+{
+    using render::wayland::buffer_fence;
+
+    // Pipes stand in for the sync_files of a two-plane dmabuf. They become readable on a write.
+    int plane1[2];
+    int plane2[2];
+    QVERIFY(pipe2(plane1, O_CLOEXEC) == 0);
+    QVERIFY(pipe2(plane2, O_CLOEXEC) == 0);
+
+    auto context = std::make_unique<QObject>();
+    int ready_count{0};
+
+    auto fence = std::make_unique<buffer_fence>(
+        std::vector<int>{plane1[0], plane2[0]}, context.get(), [&] { ready_count++; });
+    QVERIFY(!fence->is_signaled());
+
+    SECTION("all signalled")
+    {
+        signal_fence(plane1[1]);
+        QCoreApplication::processEvents();
+        QCOMPARE(ready_count, 0);
+        QVERIFY(!fence->is_signaled());
+
+        signal_fence(plane2[1]);
+        TRY_REQUIRE(ready_count == 1);
+        QVERIFY(fence->is_signaled());
+
+        // Called only once even though the fences stay readable.
+        QCoreApplication::processEvents();
+        QCOMPARE(ready_count, 1);
+    }
+
+    SECTION("context destroyed")
+    {
+        context.reset();
+        signal_fence(plane1[1]);
+        signal_fence(plane2[1]);
+        QCoreApplication::processEvents();
+        QCOMPARE(ready_count, 0);
+    }
+
+    fence.reset();
+    close(plane1[1]);
+    close(plane2[1]);
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/render/backend/wlroots/dmabuf_import.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+struct mock_plane {
+    int fd;
+    uint32_t offset;
+    uint32_t stride;
+};
+
+struct mock_dmabuf {
+    std::vector<mock_plane> planes;
+    uint32_t format{0};
+    uint64_t modifier{0};
+    QSize size;
+};
+
+}
+
+TEST_CASE("render dmabuf import", "[unit],[render]")
+{
+    using render::backend::wlroots::dmabuf_import_cache;
+
+    auto fd1 = memfd_create("dmabuf-import-1", 0);
+    auto fd2 = memfd_create("dmabuf-import-2", 0);
+    QVERIFY(fd1 >= 0);
+    QVERIFY(fd2 >= 0);
+
+    // Another descriptor of the same memory as a client sends for each of its wl_buffers.
+    auto fd1_dup = dup(fd1);
+    QVERIFY(fd1_dup >= 0);
+
+    int client1{0};
+    int client2{0};
+
+    auto const buffer = mock_dmabuf{{{fd1, 0, 1024}, {fd2, 0, 512}}, 1, 2, QSize(256, 256)};
+
+    dmabuf_import_cache cache;
+    auto const tex_import = cache.get(buffer, &client1);
+    QVERIFY(tex_import);
+
+    SECTION("same memory")
+    {
+        auto other = buffer;
+        other.planes.at(0).fd = fd1_dup;
+        QCOMPARE(cache.get(other, &client1), tex_import);
+    }
+
+    SECTION("other stride")
+    {
+        auto other = buffer;
+        other.planes.at(1).stride = 1024;
+        QVERIFY(cache.get(other, &client1) != tex_import);
+    }
+
+    SECTION("other plane memory")
+    {
+        auto other = buffer;
+        other.planes.at(1).fd = fd1_dup;
+        QVERIFY(cache.get(other, &client1) != tex_import);
+    }
+
+    SECTION("other client")
+    {
+        QVERIFY(cache.get(buffer, &client2) != tex_import);
+    }
+
+    SECTION("unknown client")
+    {
+        QVERIFY(cache.get(buffer, nullptr) != tex_import);
+    }
+
+    close(fd1_dup);
+    close(fd2);
+    close(fd1);
+}
+
+}
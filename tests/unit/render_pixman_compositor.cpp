@@ -0,0 +1,71 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/render/qpainter/pixman_compositor.h"
+
+#include <catch2/generators/catch_generators.hpp>
+
+namespace como::detail::test
+{
+
+TEST_CASE("render pixman compositor", "[unit],[render]")
+{
+    using render::qpainter::draw_item;
+    using render::qpainter::draw_item_pixman;
+
+    // Left half red, right half blue. Only the red half is the source of the item.
+    QImage source(4, 4, QImage::Format_ARGB32_Premultiplied);
+    source.fill(Qt::blue);
+    for (int y = 0; y < source.height(); y++) {
+        for (int x = 0; x < 2; x++) {
+            source.setPixelColor(x, y, Qt::red);
+        }
+    }
+
+    auto const smooth = GENERATE(true, false);
+    auto const opacity = GENERATE(1., 0.5);
+
+    QImage target(8, 8, QImage::Format_RGB32);
+    target.fill(Qt::black);
+
+    draw_item item;
+    item.clip = target.rect();
+    item.smooth = smooth;
+    item.opacity = opacity;
+
+    SECTION("scaled sub-rect")
+    {
+        item.images.push_back({.target = QRectF(0, 0, 8, 8),
+                               .image = source,
+                               .source = QRectF(0, 0, 2, 4)});
+    }
+
+    SECTION("translated sub-rect")
+    {
+        item.images.push_back({.target = QRectF(3, 2, 2, 4),
+                               .image = source,
+                               .source = QRectF(0, 0, 2, 4)});
+        item.clip = QRect(3, 2, 2, 4);
+    }
+
+    QVERIFY(draw_item_pixman(target, item, target.rect()));
+
+    // No blue from outside of the source rectangle may bleed into the edge pixels.
+    auto const expected = qRgb(qRound(255 * opacity), 0, 0);
+    auto const bounds = item.clip.boundingRect();
+
+    for (int y = bounds.top(); y <= bounds.bottom(); y++) {
+        for (auto x : {bounds.left(), bounds.right()}) {
+            auto const pixel = target.pixel(x, y);
+            INFO("pixel " << x << "," << y);
+            QCOMPARE(qBlue(pixel), 0);
+            REQUIRE(std::abs(qRed(pixel) - qRed(expected)) <= 1);
+        }
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/render/qpainter/scratch_image_pool.h"
+
+namespace como::detail::test
+{
+
+TEST_CASE("render scratch image pool", "[unit],[render]")
+{
+    render::qpainter::scratch_image_pool pool;
+
+    SECTION("reuse after release")
+    {
+        auto& first = pool.acquire(QSize(100, 50));
+        auto const first_bits = first.constBits();
+        QVERIFY(first.width() >= 100);
+        QVERIFY(first.height() >= 50);
+        pool.release(first);
+
+        // Another layer of the same frame gets the same storage.
+        auto& second = pool.acquire(QSize(90, 60));
+        QCOMPARE(&second, &first);
+        QCOMPARE(second.constBits(), first_bits);
+        pool.release(second);
+    }
+
+    SECTION("no reuse while acquired")
+    {
+        auto& first = pool.acquire(QSize(100, 50));
+        auto& second = pool.acquire(QSize(100, 50));
+        QVERIFY(&second != &first);
+        QVERIFY(second.constBits() != first.constBits());
+    }
+
+    SECTION("reuse in next frame")
+    {
+        auto& first = pool.acquire(QSize(100, 50));
+        auto const first_bits = first.constBits();
+        pool.end_frame();
+
+        auto& second = pool.acquire(QSize(100, 50));
+        QCOMPARE(second.constBits(), first_bits);
+    }
+}
+
+}
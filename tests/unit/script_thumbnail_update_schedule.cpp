@@ -0,0 +1,186 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/script/thumbnail_update_schedule.h"
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+struct mock_source {
+    bool needs_update() const
+    {
+        return dirty;
+    }
+
+    bool is_visible() const
+    {
+        return visible;
+    }
+
+    QSize texture_size() const
+    {
+        return size;
+    }
+
+    QSize size;
+    bool visible{true};
+    bool dirty{true};
+    int skipped_frames{0};
+};
+
+}
+
+TEST_CASE("script thumbnail update schedule", "[unit],[script]")
+{
+    using scripting::schedule_thumbnail_updates;
+
+    SECTION("budget")
+    {
+        auto env_budget = [](char const* value) {
+            qputenv("COMO_THUMBNAIL_PIXEL_BUDGET", value);
+            auto const budget = scripting::get_thumbnail_pixel_budget();
+            qunsetenv("COMO_THUMBNAIL_PIXEL_BUDGET");
+            return budget;
+        };
+
+        QCOMPARE(scripting::get_thumbnail_pixel_budget(), 3840 * 2160);
+        QCOMPARE(env_budget("1000"), 1000);
+
+        // Invalid values fall back to the default.
+        QCOMPARE(env_budget("0"), 3840 * 2160);
+        QCOMPARE(env_budget("-5"), 3840 * 2160);
+        QCOMPARE(env_budget("abc"), 3840 * 2160);
+    }
+
+    SECTION("budget accounting")
+    {
+        mock_source a{{10, 10}};
+        mock_source b{{10, 20}};
+        mock_source c{{20, 20}};
+        std::vector<mock_source*> sources{&a, &b, &c};
+
+        // All fit exactly.
+        auto schedule = schedule_thumbnail_updates(sources, 700);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{&a, &b, &c}));
+        QVERIFY(schedule.deferred.empty());
+
+        // Only the smallest fit, the remaining budget does not suffice for the largest one.
+        schedule = schedule_thumbnail_updates(sources, 699);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{&a, &b}));
+        QCOMPARE(schedule.deferred, (std::vector<mock_source*>{&c}));
+        QCOMPARE(c.skipped_frames, 1);
+        QCOMPARE(a.skipped_frames, 0);
+
+        // A source is skipped while a later smaller one still fits into the remaining budget.
+        c.skipped_frames = 0;
+        c.size = {10, 10};
+        b.size = {30, 30};
+        schedule = schedule_thumbnail_updates(sources, 300);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{&a, &c}));
+        QCOMPARE(schedule.deferred, (std::vector<mock_source*>{&b}));
+    }
+
+    SECTION("one update per frame")
+    {
+        mock_source large{{100, 100}};
+        mock_source small{{20, 20}};
+        std::vector<mock_source*> sources{&large, &small};
+
+        // The first source is updated even if it alone exceeds the budget.
+        auto schedule = schedule_thumbnail_updates(sources, 10);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{&small}));
+        QCOMPARE(schedule.deferred, (std::vector<mock_source*>{&large}));
+
+        // After waiting the large one goes first and is updated alone.
+        schedule = schedule_thumbnail_updates(sources, 10);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{&large}));
+        QCOMPARE(schedule.deferred, (std::vector<mock_source*>{&small}));
+        QCOMPARE(large.skipped_frames, 0);
+        QCOMPARE(small.skipped_frames, 1);
+    }
+
+    SECTION("clean sources")
+    {
+        mock_source a{{10, 10}};
+        mock_source b{{10, 10}};
+        b.dirty = false;
+
+        auto schedule = schedule_thumbnail_updates(std::vector<mock_source*>{&a, &b}, 10);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{&a}));
+        QVERIFY(schedule.deferred.empty());
+        QCOMPARE(b.skipped_frames, 0);
+    }
+
+    SECTION("service order")
+    {
+        mock_source hidden{{10, 10}};
+        hidden.visible = false;
+        hidden.skipped_frames = 5;
+        mock_source visible_large{{40, 40}};
+        mock_source visible_small{{20, 20}};
+        mock_source waited{{30, 30}};
+        waited.skipped_frames = 2;
+
+        std::vector<mock_source*> sources{&hidden, &visible_large, &visible_small, &waited};
+        std::vector<mock_source*> const expected_order{
+            &waited, &visible_small, &visible_large, &hidden};
+
+        SECTION("ordered")
+        {
+            // Visible first, then the longest waiting, then the smallest.
+            auto schedule = schedule_thumbnail_updates(sources, 3000);
+            QCOMPARE(schedule.updated, expected_order);
+        }
+
+        SECTION("round-robin")
+        {
+            // With a budget for a single source per frame every source is updated once in order.
+            std::vector<mock_source*> serviced;
+            for (int frame = 0; frame < 4; frame++) {
+                auto schedule = schedule_thumbnail_updates(sources, 1);
+                QCOMPARE(schedule.updated.size(), size_t{1});
+                serviced.push_back(schedule.updated.front());
+                schedule.updated.front()->dirty = false;
+            }
+            QCOMPARE(serviced, expected_order);
+            QVERIFY(schedule_thumbnail_updates(sources, 1).updated.empty());
+        }
+    }
+
+    SECTION("deferred sources catch up")
+    {
+        std::vector<mock_source> storage(4, mock_source{{10, 10}});
+        std::vector<mock_source*> sources;
+        for (auto& source : storage) {
+            sources.push_back(&source);
+        }
+
+        // With a budget for two sources per frame the deferred ones are first in the next frame.
+        auto schedule = schedule_thumbnail_updates(sources, 200);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{sources[0], sources[1]}));
+        QCOMPARE(schedule.deferred, (std::vector<mock_source*>{sources[2], sources[3]}));
+
+        schedule = schedule_thumbnail_updates(sources, 200);
+        QCOMPARE(schedule.updated, (std::vector<mock_source*>{sources[2], sources[3]}));
+        QCOMPARE(schedule.deferred, (std::vector<mock_source*>{sources[0], sources[1]}));
+    }
+
+    SECTION("mipmap levels")
+    {
+        QCOMPARE(scripting::get_thumbnail_mipmap_levels({}), 1);
+        QCOMPARE(scripting::get_thumbnail_mipmap_levels({1, 1}), 1);
+        QCOMPARE(scripting::get_thumbnail_mipmap_levels({2, 1}), 2);
+        QCOMPARE(scripting::get_thumbnail_mipmap_levels({255, 100}), 8);
+        QCOMPARE(scripting::get_thumbnail_mipmap_levels({100, 256}), 9);
+        QCOMPARE(scripting::get_thumbnail_mipmap_levels({3840, 2160}), 12);
+    }
+}
+
+}
@@ -0,0 +1,292 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/base/x11/event_compression.h"
+
+#include <algorithm>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstdlib>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+template<typename Event>
+base::x11::event_ptr make_event(Event const& data)
+{
+    // Events from the X server always have the size of a generic event.
+    auto event = static_cast<Event*>(std::calloc(1, std::max(sizeof(Event), size_t{32})));
+    *event = data;
+    return base::x11::event_ptr(reinterpret_cast<xcb_generic_event_t*>(event));
+}
+
+base::x11::event_ptr
+configure_request(xcb_window_t window, uint16_t mask, int16_t x, int16_t y, uint16_t width)
+{
+    xcb_configure_request_event_t req{};
+    req.response_type = XCB_CONFIGURE_REQUEST;
+    req.window = window;
+    req.value_mask = mask;
+    req.x = x;
+    req.y = y;
+    req.width = width;
+    return make_event(req);
+}
+
+base::x11::event_ptr property_notify(xcb_window_t window, xcb_atom_t atom, uint8_t state)
+{
+    xcb_property_notify_event_t notify{};
+    notify.response_type = XCB_PROPERTY_NOTIFY;
+    notify.window = window;
+    notify.atom = atom;
+    notify.state = state;
+    return make_event(notify);
+}
+
+base::x11::event_ptr motion_notify(xcb_window_t window, int16_t x, uint16_t state = 0)
+{
+    xcb_motion_notify_event_t motion{};
+    motion.response_type = XCB_MOTION_NOTIFY;
+    motion.event = window;
+    motion.event_x = x;
+    motion.state = state;
+    return make_event(motion);
+}
+
+base::x11::event_ptr map_request(xcb_window_t window)
+{
+    xcb_map_request_event_t req{};
+    req.response_type = XCB_MAP_REQUEST;
+    req.window = window;
+    return make_event(req);
+}
+
+template<typename Event>
+Event const& get(std::vector<base::x11::event_ptr> const& events, size_t index)
+{
+    return *reinterpret_cast<Event const*>(events.at(index).get());
+}
+
+template<typename Event>
+Event& get_mutable(base::x11::event_ptr const& event)
+{
+    return *reinterpret_cast<Event*>(event.get());
+}
+
+}
+
+TEST_CASE("x11 event compression", "[unit],[base]")
+{
+    std::vector<base::x11::event_ptr> events;
+
+    SECTION("configure requests are merged")
+    {
+        events.push_back(
+            configure_request(1, XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y, 10, 20, 0));
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_WIDTH, 0, 0, 100));
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 30, 0, 0));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 1);
+        auto const& req = get<xcb_configure_request_event_t>(events, 0);
+        QCOMPARE(req.value_mask,
+                 XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y | XCB_CONFIG_WINDOW_WIDTH);
+        QCOMPARE(req.x, 30);
+        QCOMPARE(req.y, 20);
+        QCOMPARE(req.width, 100);
+    }
+
+    SECTION("configure request values are merged per flag")
+    {
+        auto const all_values = XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y | XCB_CONFIG_WINDOW_WIDTH
+            | XCB_CONFIG_WINDOW_HEIGHT | XCB_CONFIG_WINDOW_BORDER_WIDTH;
+
+        events.push_back(configure_request(1, all_values, 10, 20, 100));
+        auto& first = get_mutable<xcb_configure_request_event_t>(events.back());
+        first.height = 50;
+        first.border_width = 2;
+
+        auto const size_mask = XCB_CONFIG_WINDOW_HEIGHT | XCB_CONFIG_WINDOW_BORDER_WIDTH;
+        events.push_back(configure_request(1, size_mask, 0, 0, 0));
+        auto& second = get_mutable<xcb_configure_request_event_t>(events.back());
+        second.height = 60;
+        second.border_width = 0;
+
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_Y, 0, 40, 0));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 1);
+        auto const& req = get<xcb_configure_request_event_t>(events, 0);
+        QCOMPARE(req.value_mask, all_values);
+        QCOMPARE(req.x, 10);
+        QCOMPARE(req.y, 40);
+        QCOMPARE(req.width, 100);
+        QCOMPARE(req.height, 60);
+        QCOMPARE(req.border_width, 0);
+    }
+
+    SECTION("configure request values not set are not merged")
+    {
+        // Values of flags that neither request sets must not appear in the merged request.
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 10, 20, 100));
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_Y, 30, 40, 200));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 1);
+        auto const& req = get<xcb_configure_request_event_t>(events, 0);
+        QCOMPARE(req.value_mask, XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y);
+        QCOMPARE(req.x, 10);
+        QCOMPARE(req.y, 40);
+    }
+
+    SECTION("configure requests of different windows")
+    {
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 10, 0, 0));
+        events.push_back(configure_request(2, XCB_CONFIG_WINDOW_X, 20, 0, 0));
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 30, 0, 0));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 2);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 0).window, 2u);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 1).window, 1u);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 1).x, 30);
+    }
+
+    SECTION("restacking is not merged")
+    {
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_STACK_MODE, 0, 0, 0));
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_STACK_MODE, 0, 0, 0));
+        base::x11::compress_events(events);
+
+        QCOMPARE(events.size(), 2u);
+    }
+
+    SECTION("restacking ends a run")
+    {
+        auto const restack_mask = GENERATE(as<uint16_t>{},
+                                           XCB_CONFIG_WINDOW_STACK_MODE,
+                                           XCB_CONFIG_WINDOW_SIBLING | XCB_CONFIG_WINDOW_STACK_MODE,
+                                           XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_STACK_MODE);
+
+        // The geometry before and after the restacking must not be merged over it.
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 10, 0, 0));
+        events.push_back(configure_request(1, restack_mask, 20, 0, 0));
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 30, 0, 0));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 3);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 0).x, 10);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 1).value_mask, restack_mask);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 2).x, 30);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 2).value_mask, XCB_CONFIG_WINDOW_X);
+    }
+
+    SECTION("restacking of another window ends a run")
+    {
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 10, 0, 0));
+        events.push_back(configure_request(2, XCB_CONFIG_WINDOW_STACK_MODE, 0, 0, 0));
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 30, 0, 0));
+        base::x11::compress_events(events);
+
+        QCOMPARE(events.size(), 3u);
+    }
+
+    SECTION("property notifies per atom and state")
+    {
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        events.push_back(property_notify(1, 101, XCB_PROPERTY_NEW_VALUE));
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_DELETE));
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 3);
+        QCOMPARE(get<xcb_property_notify_event_t>(events, 0).atom, 101u);
+        QCOMPARE(get<xcb_property_notify_event_t>(events, 1).state, XCB_PROPERTY_DELETE);
+        QCOMPARE(get<xcb_property_notify_event_t>(events, 2).state, XCB_PROPERTY_NEW_VALUE);
+    }
+
+    SECTION("property notifies with interleaved new and delete")
+    {
+        auto const first = GENERATE(XCB_PROPERTY_NEW_VALUE, XCB_PROPERTY_DELETE);
+        auto const second
+            = first == XCB_PROPERTY_NEW_VALUE ? XCB_PROPERTY_DELETE : XCB_PROPERTY_NEW_VALUE;
+
+        events.push_back(property_notify(1, 100, first));
+        events.push_back(property_notify(1, 100, second));
+        events.push_back(property_notify(1, 100, first));
+        events.push_back(property_notify(1, 100, second));
+        base::x11::compress_events(events);
+
+        // The last event still describes the final state of the property.
+        REQUIRE(events.size() == 2);
+        QCOMPARE(get<xcb_property_notify_event_t>(events, 0).state, first);
+        QCOMPARE(get<xcb_property_notify_event_t>(events, 1).state, second);
+    }
+
+    SECTION("property notifies of different windows")
+    {
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        events.push_back(property_notify(2, 100, XCB_PROPERTY_DELETE));
+        events.push_back(property_notify(2, 100, XCB_PROPERTY_NEW_VALUE));
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_DELETE));
+        base::x11::compress_events(events);
+
+        QCOMPARE(events.size(), 4u);
+    }
+
+    SECTION("motion notifies")
+    {
+        events.push_back(motion_notify(1, 10));
+        events.push_back(motion_notify(1, 20));
+        events.push_back(motion_notify(1, 30, XCB_BUTTON_MASK_1));
+        events.push_back(motion_notify(1, 40, XCB_BUTTON_MASK_1));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 2);
+        QCOMPARE(get<xcb_motion_notify_event_t>(events, 0).event_x, 20);
+        QCOMPARE(get<xcb_motion_notify_event_t>(events, 1).event_x, 40);
+    }
+
+    SECTION("other events end compression")
+    {
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        events.push_back(map_request(1));
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 3);
+        QCOMPARE(events.at(1)->response_type, XCB_MAP_REQUEST);
+    }
+
+    SECTION("sent events are kept")
+    {
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        events.back()->response_type |= 0x80;
+        base::x11::compress_events(events);
+
+        QCOMPARE(events.size(), 2u);
+    }
+
+    SECTION("sent events end a run")
+    {
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 10, 0, 0));
+        events.push_back(property_notify(1, 100, XCB_PROPERTY_NEW_VALUE));
+        events.back()->response_type |= 0x80;
+        events.push_back(configure_request(1, XCB_CONFIG_WINDOW_X, 30, 0, 0));
+        base::x11::compress_events(events);
+
+        REQUIRE(events.size() == 3);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 0).x, 10);
+        QCOMPARE(events.at(1)->response_type, XCB_PROPERTY_NOTIFY | 0x80);
+        QCOMPARE(get<xcb_configure_request_event_t>(events, 2).x, 30);
+    }
+}
+
+}
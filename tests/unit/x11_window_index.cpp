@@ -0,0 +1,98 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/win/x11/window_index.h"
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+struct mock_window {
+    struct {
+        xcb_window_t outer{XCB_WINDOW_NONE};
+        xcb_window_t wrapper{XCB_WINDOW_NONE};
+        xcb_window_t client{XCB_WINDOW_NONE};
+        xcb_window_t input{XCB_WINDOW_NONE};
+    } xcb_windows;
+
+    struct {
+        xcb_sync_alarm_t alarm{XCB_NONE};
+    } sync_request;
+};
+
+}
+
+TEST_CASE("x11 window index", "[unit],[win]")
+{
+    using win::x11::predicate_match;
+
+    win::x11::window_index<mock_window> index;
+
+    mock_window win1;
+    win1.xcb_windows = {.outer = 10, .wrapper = 11, .client = 12, .input = 13};
+    win1.sync_request.alarm = 14;
+
+    mock_window win2;
+    win2.xcb_windows.client = 20;
+
+    index.add(&win1);
+    index.add(&win2);
+
+    SECTION("find by resource")
+    {
+        QCOMPARE(index.find(predicate_match::window, 12), &win1);
+        QCOMPARE(index.find(predicate_match::wrapper_id, 11), &win1);
+        QCOMPARE(index.find(predicate_match::frame_id, 10), &win1);
+        QCOMPARE(index.find(predicate_match::input_id, 13), &win1);
+        QCOMPARE(index.find_sync_alarm(14), &win1);
+        QCOMPARE(index.find(predicate_match::window, 20), &win2);
+
+        // Resources are only found with the matching predicate.
+        QCOMPARE(index.find(predicate_match::window, 10), nullptr);
+        QCOMPARE(index.find(predicate_match::frame_id, 20), nullptr);
+        QCOMPARE(index.find(predicate_match::window, 30), nullptr);
+    }
+
+    SECTION("released resources are not found")
+    {
+        win1.xcb_windows.input = XCB_WINDOW_NONE;
+        QCOMPARE(index.find(predicate_match::input_id, 13), nullptr);
+
+        win1.xcb_windows.input = 15;
+        index.add(predicate_match::input_id, 15, &win1);
+        QCOMPARE(index.find(predicate_match::input_id, 15), &win1);
+
+        win1.sync_request.alarm = XCB_NONE;
+        QCOMPARE(index.find_sync_alarm(14), nullptr);
+    }
+
+    SECTION("remove window with released resources")
+    {
+        // Also entries of resources the window does not hold anymore are removed.
+        win1.xcb_windows.input = XCB_WINDOW_NONE;
+        win1.sync_request.alarm = XCB_NONE;
+        index.remove(&win1);
+        QVERIFY(!index.contains(&win1));
+    }
+
+    SECTION("remove window")
+    {
+        QVERIFY(index.contains(&win1));
+        index.remove(&win1);
+        QVERIFY(!index.contains(&win1));
+        QVERIFY(index.contains(&win2));
+
+        QCOMPARE(index.find(predicate_match::window, 12), nullptr);
+        QCOMPARE(index.find(predicate_match::frame_id, 10), nullptr);
+        QCOMPARE(index.find_sync_alarm(14), nullptr);
+        QCOMPARE(index.find(predicate_match::window, 20), &win2);
+    }
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+SPDX-FileCopyrightText: 2024 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/base/x11/xcb/helpers.h"
+
+#include <algorithm>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+std::vector<xcb_window_t> apply_moves(std::vector<xcb_window_t> const& previous,
+                                      std::vector<xcb_window_t> const& windows)
+{
+    auto stack = previous;
+    for (auto index : base::x11::xcb::get_restack_moves(previous, windows)) {
+        auto const win = windows.at(index);
+        if (auto it = std::find(stack.begin(), stack.end(), win); it != stack.end()) {
+            stack.erase(it);
+        }
+        auto sibling = std::find(stack.begin(), stack.end(), windows.at(index - 1));
+        REQUIRE(sibling != stack.end());
+        stack.insert(sibling + 1, win);
+    }
+
+    std::erase_if(stack, [&](auto win) {
+        return std::find(windows.begin(), windows.end(), win) == windows.end();
+    });
+    return stack;
+}
+
+}
+
+TEST_CASE("xcb restack", "[unit],[win]")
+{
+    using base::x11::xcb::get_restack_moves;
+
+    std::vector<xcb_window_t> const previous{1, 2, 3, 4, 5, 6};
+
+    SECTION("unchanged")
+    {
+        QVERIFY(get_restack_moves(previous, previous).empty());
+    }
+
+    SECTION("no previous stack")
+    {
+        std::vector<xcb_window_t> const windows{1, 2, 3};
+        QCOMPARE(get_restack_moves({}, windows), (std::vector<size_t>{1, 2}));
+    }
+
+    SECTION("raise single window")
+    {
+        std::vector<xcb_window_t> const windows{1, 5, 2, 3, 4, 6};
+        QCOMPARE(get_restack_moves(previous, windows), std::vector<size_t>{1});
+        QCOMPARE(apply_moves(previous, windows), windows);
+    }
+
+    SECTION("lower single window")
+    {
+        std::vector<xcb_window_t> const windows{1, 3, 4, 5, 6, 2};
+        QCOMPARE(get_restack_moves(previous, windows), std::vector<size_t>{5});
+        QCOMPARE(apply_moves(previous, windows), windows);
+    }
+
+    SECTION("first window stays")
+    {
+        std::vector<xcb_window_t> const windows{3, 1, 2, 4, 5, 6};
+        QCOMPARE(get_restack_moves(previous, windows), (std::vector<size_t>{1, 2}));
+        QCOMPARE(apply_moves(previous, windows), windows);
+    }
+
+    SECTION("added and removed windows")
+    {
+        std::vector<xcb_window_t> const windows{1, 7, 2, 4, 6, 5};
+        QCOMPARE(get_restack_moves(previous, windows), (std::vector<size_t>{1, 4}));
+        QCOMPARE(apply_moves(previous, windows), windows);
+    }
+
+    SECTION("reversed")
+    {
+        std::vector<xcb_window_t> const windows{1, 6, 5, 4, 3, 2};
+        QCOMPARE(get_restack_moves(previous, windows).size(), 4u);
+        QCOMPARE(apply_moves(previous, windows), windows);
+    }
+}
+
+}